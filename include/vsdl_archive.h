@@ -0,0 +1,14 @@
+#ifndef VSDL_ARCHIVE_H
+#define VSDL_ARCHIVE_H
+
+#include "vsdl_types.h"
+
+// Map a packed asset archive read-only; false if it is missing or malformed (loaders then use loose files)
+bool vsdl_open_archive(VSDL_Archive& archive, const std::string& path);
+void vsdl_close_archive(VSDL_Archive& archive);
+
+// Zero-copy view of the entry called name ("shaders/tri.vert.spv"), nullptr if absent.
+// The pointer is VSDL_ARCHIVE_ALIGNMENT aligned and valid until vsdl_close_archive.
+const uint8_t* vsdl_archive_find(const VSDL_Archive& archive, const std::string& name, size_t* size);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,39 @@
+#ifndef VSDL_ARCHIVE_FORMAT_H
+#define VSDL_ARCHIVE_FORMAT_H
+
+#include <cstdint>
+
+// On-disk layout of a packed asset archive (.vpk), shared by the runtime and tools/vsdl_pack.cpp:
+// header, then entryCount index entries sorted by name, then the entry data, each entry starting
+// on a VSDL_ARCHIVE_ALIGNMENT boundary so mapped views are page and SPIR-V aligned
+#define VSDL_ARCHIVE_MAGIC 0x4B505356u // "VSPK" little endian
+#define VSDL_ARCHIVE_VERSION 1u
+#define VSDL_ARCHIVE_ALIGNMENT 4096u
+#define VSDL_ARCHIVE_MAX_NAME 104
+
+enum VSDL_ArchiveEntryType : uint32_t {
+    VSDL_ARCHIVE_RAW = 0,
+    VSDL_ARCHIVE_SHADER = 1,  // SPIR-V module
+    VSDL_ARCHIVE_MESH = 2,
+    VSDL_ARCHIVE_TEXTURE = 3,
+};
+
+struct VSDL_ArchiveHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t alignment;
+};
+
+struct VSDL_ArchiveEntry {
+    char name[VSDL_ARCHIVE_MAX_NAME]; // Path relative to the executable, '/' separated, NUL terminated
+    uint32_t type; // VSDL_ArchiveEntryType
+    uint32_t reserved;
+    uint64_t offset; // From the start of the file
+    uint64_t size;
+};
+
+static_assert(sizeof(VSDL_ArchiveHeader) == 16, "archive header layout");
+static_assert(sizeof(VSDL_ArchiveEntry) == 128, "archive entry layout");
+
+#endif
\ No newline at end of file
@@ -0,0 +1,24 @@
+#ifndef VSDL_DEPTH_PYRAMID_H
+#define VSDL_DEPTH_PYRAMID_H
+
+#include "vsdl_types.h"
+
+// Create the reduction pipeline and a pyramid for the current swapchain extent; throws on failure
+void vsdl_create_depth_pyramid(VSDL_Context& ctx);
+void vsdl_destroy_depth_pyramid(VSDL_Context& ctx);
+
+// Rebuild the pyramid image for a new swapchain extent and point the cull sets at it; the device must be idle.
+// The pyramid is invalid until the next build.
+void vsdl_resize_depth_pyramid(VSDL_Context& ctx);
+
+// Point an instancing descriptor set's pyramid binding at the current image
+void vsdl_write_depth_pyramid_binding(VSDL_Context& ctx, VkDescriptorSet set, uint32_t binding);
+
+// Move a freshly created pyramid out of UNDEFINED; record before the first dispatch that binds it
+void vsdl_depth_pyramid_prepare(VSDL_Context& ctx, VkCommandBuffer commandBuffer);
+
+// Reduce depthView (in SHADER_READ_ONLY_OPTIMAL, its writes visible to compute) into the pyramid for the
+// next frame's cull pass. Recorded outside any render pass.
+void vsdl_record_depth_pyramid(VSDL_Context& ctx, VkCommandBuffer commandBuffer, VkImageView depthView);
+
+#endif
\ No newline at end of file
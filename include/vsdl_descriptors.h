@@ -0,0 +1,29 @@
+#ifndef VSDL_DESCRIPTORS_H
+#define VSDL_DESCRIPTORS_H
+
+#include "vsdl_types.h"
+
+// Create the global bindless table when descriptor indexing was enabled at device creation
+bool vsdl_create_descriptors(VSDL_Context& ctx);
+void vsdl_destroy_descriptors(VSDL_Context& ctx);
+
+// Write a resource into a free slot of the bindless table; throws when the table is full or unavailable
+VSDL_BindlessHandle vsdl_bindless_add_texture(VSDL_Context& ctx, VkImageView view, VkSampler sampler);
+VSDL_BindlessHandle vsdl_bindless_add_buffer(VSDL_Context& ctx, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range);
+
+// The slot is reused only after every frame that could reference it has completed
+void vsdl_bindless_free(VSDL_Context& ctx, VSDL_BindlessHandle& handle);
+
+// Call once per submitted frame after waiting for its slot's previous submit: recycles deferred frees
+// and resets the slot's transient pools
+void vsdl_descriptors_begin_frame(VSDL_Context& ctx);
+
+// Transient set from the current slot's linear pools, valid until the slot comes around again.
+// Main thread only.
+VkDescriptorSet vsdl_allocate_frame_set(VSDL_Context& ctx, VkDescriptorSetLayout layout);
+
+// Bind the bindless table; layout must have been created with ctx.descriptors.bindlessLayout at setIndex
+void vsdl_bind_bindless(VSDL_Context& ctx, VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint,
+                        VkPipelineLayout layout, uint32_t setIndex = 0);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,40 @@
+#ifndef VSDL_DEVICE_H
+#define VSDL_DEVICE_H
+
+#include "vsdl_types.h"
+#include <string>
+#include <vector>
+
+// What device selection knows about one physical device. Filled from Vulkan by vsdl_query_devices,
+// but plain data so scoring and selection can run on a hand-made list.
+struct VSDL_DeviceCandidate {
+    std::string name;
+    uint32_t vendorID = 0;
+    uint32_t deviceID = 0;
+    VkPhysicalDeviceType type = VK_PHYSICAL_DEVICE_TYPE_OTHER;
+    uint32_t apiVersion = VK_API_VERSION_1_0;
+    VkDeviceSize deviceLocalBytes = 0; // Largest DEVICE_LOCAL heap
+    bool graphicsQueue = false;
+    bool presentQueue = false; // Some family can present to the surface
+    bool asyncCompute = false; // Compute family without graphics
+    bool dedicatedTransfer = false; // Transfer family without graphics or compute
+    bool swapchain = false; // VK_KHR_swapchain
+    bool timelineSemaphore = false;
+    bool descriptorIndexing = false; // Everything the bindless table needs
+    bool dynamicRendering = false; // dynamicRendering + synchronization2
+    bool memoryBudget = false;
+};
+
+// Enumerate the instance's devices in vkEnumeratePhysicalDevices order; devices receives the handles
+std::vector<VSDL_DeviceCandidate> vsdl_query_devices(VSDL_Context& ctx, std::vector<VkPhysicalDevice>& devices);
+
+// Higher is better, negative means unusable (reason says why). Headless needs neither present nor swapchain.
+int64_t vsdl_score_device(const VSDL_DeviceCandidate& candidate, bool headless, std::string* reason = nullptr);
+
+// Pick a device: the override (index or case-insensitive name substring) when it names a usable device,
+// otherwise the best score, ties going to the lower index. Returns -1 when nothing is usable.
+// report receives one line per candidate plus the decision.
+int vsdl_select_device(const std::vector<VSDL_DeviceCandidate>& candidates, bool headless, const std::string& override,
+                       std::string* report = nullptr);
+
+#endif
\ No newline at end of file
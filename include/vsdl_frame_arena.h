@@ -0,0 +1,36 @@
+#ifndef VSDL_FRAME_ARENA_H
+#define VSDL_FRAME_ARENA_H
+
+#include "vsdl_types.h"
+#include <cstddef>
+
+// Per frame slot; the GPU windows bound through the dynamic set are at most this large. The whole ring
+// (VSDL_MAX_FRAMES_IN_FLIGHT slots plus one window) must fit a block of the dynamic memory pool.
+#define VSDL_FRAME_ARENA_CPU_BYTES (1ull * 1024 * 1024)
+#define VSDL_FRAME_ARENA_GPU_BYTES (4ull * 1024 * 1024)
+#define VSDL_FRAME_UNIFORM_WINDOW (64ull * 1024)
+#define VSDL_FRAME_STORAGE_WINDOW (4ull * 1024 * 1024)
+
+// Create the arena with a region for every possible frame slot, so it outlives frames-in-flight changes
+bool vsdl_create_frame_arena(VSDL_Context& ctx);
+void vsdl_destroy_frame_arena(VSDL_Context& ctx);
+
+// Reset the current slot's regions; call after waiting for the slot's previous submit
+void vsdl_frame_arena_begin(VSDL_Context& ctx);
+// Flush the GPU bytes written this frame (no-op on coherent memory) and record the usage counters
+void vsdl_frame_arena_end(VSDL_Context& ctx);
+
+// CPU scratch valid until the slot is reset; throws when the region is exhausted. Render thread only.
+void* vsdl_frame_alloc(VSDL_Context& ctx, size_t size, size_t alignment = alignof(std::max_align_t));
+
+template <typename T>
+T* vsdl_frame_alloc_array(VSDL_Context& ctx, size_t count) {
+    return static_cast<T*>(vsdl_frame_alloc(ctx, sizeof(T) * count, alignof(T)));
+}
+
+// Mapped GPU slices for dynamic uniform/storage descriptors (bind ctx.frameArena.set with the slice offset);
+// throw when the slot's ring space or the descriptor window is exceeded. Render thread only.
+VSDL_FrameSlice vsdl_frame_alloc_uniform(VSDL_Context& ctx, VkDeviceSize size);
+VSDL_FrameSlice vsdl_frame_alloc_storage(VSDL_Context& ctx, VkDeviceSize size);
+
+#endif
\ No newline at end of file
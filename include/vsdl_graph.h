@@ -0,0 +1,34 @@
+#ifndef VSDL_GRAPH_H
+#define VSDL_GRAPH_H
+
+#include "vsdl_types.h"
+#include <string>
+
+// Declare resources and passes; indices are stable until vsdl_graph_destroy
+uint32_t vsdl_graph_import_image(VSDL_RenderGraph& graph, const char* name, VkFormat format,
+                                 VkImageLayout initialLayout, VkImageLayout finalLayout);
+uint32_t vsdl_graph_create_image(VSDL_RenderGraph& graph, const char* name, VkFormat format, VkClearValue clearValue = {});
+uint32_t vsdl_graph_add_pass(VSDL_RenderGraph& graph, const char* name,
+                             std::function<void(VSDL_Context&, VkCommandBuffer)> record);
+void vsdl_graph_use(VSDL_RenderGraph& graph, uint32_t pass, uint32_t resource, VSDL_GraphAccess access);
+void vsdl_graph_set_output(VSDL_RenderGraph& graph, uint32_t resource);
+
+// Cull passes that don't reach an output, compute barriers and create the aliased transient images; throws on failure
+void vsdl_graph_compile(VSDL_Context& ctx, VSDL_RenderGraph& graph);
+
+// Point an imported resource at this frame's image
+void vsdl_graph_bind_image(VSDL_RenderGraph& graph, uint32_t resource, VkImage image, VkImageView view);
+
+// Record every live pass with its barriers; passes with attachments need the dynamic rendering path
+void vsdl_graph_execute(VSDL_Context& ctx, VSDL_RenderGraph& graph, VkCommandBuffer commandBuffer);
+
+// Free transient images and memory and forget all passes/resources; the device must be idle
+void vsdl_graph_destroy(VSDL_Context& ctx, VSDL_RenderGraph& graph);
+
+// Human-readable listing of the compiled passes, barriers and transient memory layout
+std::string vsdl_graph_dump(const VSDL_RenderGraph& graph);
+
+// Compile a representative deferred-style graph at the swapchain size and return its dump (--dump-graph)
+std::string vsdl_graph_dump_demo(VSDL_Context& ctx);
+
+#endif
\ No newline at end of file
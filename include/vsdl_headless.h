@@ -0,0 +1,15 @@
+#ifndef VSDL_HEADLESS_H
+#define VSDL_HEADLESS_H
+
+#include "vsdl_types.h"
+
+// Create one VMA-allocated color image and host-visible readback buffer per frame in flight.
+// The images stand in for swapchain images (ctx.swapchainImages/ImageViews).
+bool vsdl_create_offscreen_targets(VSDL_Context& ctx);
+void vsdl_destroy_offscreen_targets(VSDL_Context& ctx);
+
+// Render ctx.headlessConfig.frameCount frames offscreen, reading each back asynchronously
+// and dumping it to headlessConfig.outputDir when set
+void vsdl_headless_loop(VSDL_Context& ctx);
+
+#endif
\ No newline at end of file
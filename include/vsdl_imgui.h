@@ -10,7 +10,10 @@ namespace vsdl {
     // Process ImGui events and prepare a new frame
     void imgui_new_frame(VSDL_Context& ctx, SDL_Event& event);
 
-    // Render ImGui draw data
+    // Finish the UI frame (or take the ctx.uiDrawData snapshot) and hash it; once per recorded frame
+    void imgui_prepare(VSDL_Context& ctx);
+
+    // Render the prepared draw data, from the UI cache when ctx.ui.mode allows it
     void imgui_render(VSDL_Context& ctx, VkCommandBuffer commandBuffer);
 
     // Shutdown ImGui
@@ -0,0 +1,27 @@
+#ifndef VSDL_INSTANCING_H
+#define VSDL_INSTANCING_H
+
+#include "vsdl_types.h"
+#include <vector>
+
+// Create the cull/draw pipelines and descriptor sets; throws on failure
+void vsdl_create_instancing(VSDL_Context& ctx);
+void vsdl_destroy_instancing(VSDL_Context& ctx);
+
+// Deterministic pseudo-random layout shared by the instanced and direct-draw scenes
+std::vector<VSDL_InstanceData> vsdl_generate_instances(uint32_t count);
+
+// (Re)generate instanceCount instances of ctx.meshes[0] and queue their upload; 0 disables the path.
+// Waits for the device to go idle since the old buffers may still be in use.
+void vsdl_set_instance_count(VSDL_Context& ctx, uint32_t instanceCount);
+
+// Record the culling dispatch (outside the render pass) and the indirect draw (inside it) for a frame slot;
+// depthOnly draws with the prepass pipeline. The dispatch tests the frustum and the previous frame's depth
+// pyramid, and queues a readback of its counters into ctx.instancing.lastStats for when the slot comes around.
+void vsdl_record_instancing_cull(VSDL_Context& ctx, VkCommandBuffer commandBuffer, uint32_t frameSlot);
+void vsdl_record_instancing_draw(VSDL_Context& ctx, VkCommandBuffer commandBuffer, uint32_t frameSlot, bool depthOnly);
+
+// Render frameCount frames at increasing instance counts and log CPU record and GPU time
+void vsdl_benchmark_instances(VSDL_Context& ctx, uint32_t frameCount);
+
+#endif
\ No newline at end of file
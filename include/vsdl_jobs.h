@@ -0,0 +1,15 @@
+#ifndef VSDL_JOBS_H
+#define VSDL_JOBS_H
+
+#include "vsdl_types.h"
+#include <functional>
+
+// Fixed pool of worker threads running indexed jobs
+VSDL_JobSystem* vsdl_create_job_system(uint32_t workerCount);
+void vsdl_destroy_job_system(VSDL_JobSystem* jobs);
+
+// Queue job(0) .. job(count - 1) and return immediately; vsdl_jobs_wait blocks until all have run
+void vsdl_jobs_dispatch(VSDL_JobSystem* jobs, uint32_t count, const std::function<void(uint32_t)>& job);
+void vsdl_jobs_wait(VSDL_JobSystem* jobs);
+
+#endif
\ No newline at end of file
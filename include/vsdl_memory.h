@@ -0,0 +1,25 @@
+#ifndef VSDL_MEMORY_H
+#define VSDL_MEMORY_H
+
+#include "vsdl_types.h"
+
+const char* vsdl_memory_class_name(VSDL_MemoryClass memoryClass);
+
+// Create the VMA allocator and one custom pool per pooled VSDL_MemoryClass
+bool vsdl_create_allocator(VSDL_Context& ctx);
+void vsdl_destroy_allocator(VSDL_Context& ctx);
+
+// Sub-allocate a buffer from the pool of its class; throws on failure
+VSDL_Buffer vsdl_create_buffer(VSDL_Context& ctx, VkDeviceSize size, VkBufferUsageFlags usage, VSDL_MemoryClass memoryClass);
+void vsdl_destroy_buffer(VSDL_Context& ctx, VSDL_Buffer& buffer);
+
+// Device-local image; dedicated requests its own VkDeviceMemory (render targets). Throws on failure.
+VSDL_Image vsdl_create_image(VSDL_Context& ctx, const VkImageCreateInfo& imageInfo, bool dedicated = false);
+void vsdl_destroy_image(VSDL_Context& ctx, VSDL_Image& image);
+
+// Fill budgets (VK_MAX_MEMORY_HEAPS entries) and return the heap count
+uint32_t vsdl_get_memory_budgets(VSDL_Context& ctx, VmaBudget* budgets);
+VmaStatistics vsdl_get_pool_statistics(VSDL_Context& ctx, VSDL_MemoryClass memoryClass);
+void vsdl_log_memory_stats(VSDL_Context& ctx);
+
+#endif
\ No newline at end of file
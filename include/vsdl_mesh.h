@@ -2,7 +2,18 @@
 #define VSDL_MESH_H
 
 #include "vsdl_types.h"
+#include <vector>
 
+// Vertex layout matching VSDL_Vertex (binding 0, position at location 0, color at location 1)
+VkVertexInputBindingDescription vsdl_vertex_binding();
+std::vector<VkVertexInputAttributeDescription> vsdl_vertex_attributes();
+
+// Create device-local vertex/index buffers and queue their upload; usable once the next frame is submitted
+VSDL_Mesh vsdl_create_mesh(VSDL_Context& ctx, const std::vector<VSDL_Vertex>& vertices, const std::vector<uint32_t>& indices);
+void vsdl_destroy_mesh(VSDL_Context& ctx, VSDL_Mesh& mesh);
+void vsdl_draw_mesh(VkCommandBuffer commandBuffer, const VSDL_Mesh& mesh);
+
+// Add the demo triangle to ctx.meshes
 void vsdl_create_triangle(VSDL_Context& ctx);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,33 @@
+#ifndef VSDL_PARALLEL_H
+#define VSDL_PARALLEL_H
+
+#include "vsdl_types.h"
+
+// Create the pipeline of the direct-draw scene (frame arena must exist); throws on failure
+void vsdl_create_parallel(VSDL_Context& ctx);
+void vsdl_destroy_parallel(VSDL_Context& ctx);
+
+// (Re)generate drawCount objects drawn with one vkCmdDrawIndexed each; 0 disables the scene
+void vsdl_set_direct_draw_count(VSDL_Context& ctx, uint32_t drawCount);
+
+// Animate the objects and write the camera and object data into the frame arena; call once per
+// frame before vsdl_record_direct_draws, after vsdl_update_camera
+void vsdl_prepare_direct_draws(VSDL_Context& ctx);
+
+// Restart the job system with workerCount threads, each with its own command pool per frame slot.
+// 0 records inline. Waits for the device to go idle since the old pools may still be in use.
+void vsdl_set_worker_count(VSDL_Context& ctx, uint32_t workerCount);
+
+// Record objects [first, first + count) into a command buffer inside the scene render pass;
+// depthOnly draws with the prepass pipeline
+void vsdl_record_direct_draws(VSDL_Context& ctx, VkCommandBuffer commandBuffer, uint32_t first, uint32_t count, bool depthOnly);
+
+// Record the direct draws on the workers and the particles and ImGui on this thread into secondary command
+// buffers, then execute them. Only for the direct-draw scene: the instanced scene is recorded inline.
+// The pass must have been begun with secondaryContents set; framebuffer is null on the dynamic rendering path.
+void vsdl_execute_parallel_scene(VSDL_Context& ctx, VkCommandBuffer commandBuffer, VkFramebuffer framebuffer);
+
+// Render frameCount frames with 0, 1, 2, 4, 8 workers and log CPU record and frame time
+void vsdl_benchmark_workers(VSDL_Context& ctx, uint32_t frameCount);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,32 @@
+#ifndef VSDL_PARTICLES_H
+#define VSDL_PARTICLES_H
+
+#include "vsdl_types.h"
+#include <vector>
+
+// Create count particles (clamped to one dispatch) and their pipelines; steps on the async compute queue
+// when there is a dedicated compute family and timeline semaphores. Throws on failure.
+void vsdl_create_particles(VSDL_Context& ctx, uint32_t count);
+void vsdl_destroy_particles(VSDL_Context& ctx);
+
+// Switch between the async compute queue and inline dispatches on graphics. Waits for the device to go
+// idle and reseeds the simulation; returns false if async was asked for but isn't available.
+bool vsdl_set_particles_async(VSDL_Context& ctx, bool async);
+
+// Async mode: record and submit this frame's step on the compute queue. Call once per frame after
+// submission of the graphics frame is certain and before recording it.
+void vsdl_particles_simulate(VSDL_Context& ctx);
+
+// Outside the scene pass: before it the inline step or the async acquire, after it the async release
+void vsdl_record_particles_pre_pass(VSDL_Context& ctx, VkCommandBuffer commandBuffer);
+void vsdl_record_particles_post_pass(VSDL_Context& ctx, VkCommandBuffer commandBuffer);
+// Inside the scene pass
+void vsdl_record_particles_draw(VSDL_Context& ctx, VkCommandBuffer commandBuffer);
+
+// Async mode: the graphics submit waits for the compute step it draws
+void vsdl_particles_graphics_waits(VSDL_Context& ctx, std::vector<VSDL_QueueWait>& waits);
+
+// Render frameCount frames with the async compute queue, then with inline dispatches, and log both
+void vsdl_benchmark_particles(VSDL_Context& ctx, uint32_t frameCount);
+
+#endif
\ No newline at end of file
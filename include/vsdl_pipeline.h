@@ -5,4 +5,34 @@
 
 void vsdl_create_pipeline(VSDL_Context& ctx);
 
+// Key for vertPath/fragPath (an empty fragPath gives a depth-only key) against the current render pass and
+// attachment formats. Scene defaults: triangles, back-face culling, alpha blend, reverse-Z depth test that
+// turns EQUAL without writes when ctx.depthPrepass is set.
+VSDL_PipelineKey vsdl_pipeline_key(VSDL_Context& ctx, const std::string& vertPath, const std::string& fragPath,
+                                   VkPipelineLayout layout);
+// Stable id for a SPIR-V path
+uint32_t vsdl_pipeline_shader(VSDL_Context& ctx, const std::string& path);
+
+// Build a pipeline outside the library; the caller owns it. outCreateMs receives the time spent in
+// vkCreateGraphicsPipelines.
+VkPipeline vsdl_build_pipeline(VSDL_Context& ctx, const VSDL_PipelineKey& key, VkPipelineCache cache,
+                               double* outCreateMs = nullptr);
+
+// Library lookup, building on a miss; the pipeline follows shader hot-reloads
+VSDL_PipelineId vsdl_get_pipeline(VSDL_Context& ctx, const VSDL_PipelineKey& key);
+// Same for a batch: duplicates collapse, misses are built in parallel on worker threads
+std::vector<VSDL_PipelineId> vsdl_prewarm_pipelines(VSDL_Context& ctx, const std::vector<VSDL_PipelineKey>& keys);
+// Destroys every library pipeline; the device must be idle
+void vsdl_destroy_pipeline_library(VSDL_Context& ctx);
+
+// Current handle of a library pipeline, for binding
+inline VkPipeline vsdl_pipeline(VSDL_Context& ctx, VSDL_PipelineId id) {
+    return ctx.pipelineLibrary.entries[id].pipeline;
+}
+
+VkPipeline vsdl_build_compute_pipeline(VSDL_Context& ctx, const std::string& path, VkPipelineLayout layout, VkPipelineCache cache);
+
+// Load a SPIR-V file into a shader module; throws on failure
+VkShaderModule vsdl_create_shader_module(VSDL_Context& ctx, const std::string& path);
+
 #endif
\ No newline at end of file
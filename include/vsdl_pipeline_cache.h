@@ -0,0 +1,18 @@
+#ifndef VSDL_PIPELINE_CACHE_H
+#define VSDL_PIPELINE_CACHE_H
+
+#include "vsdl_types.h"
+
+// Create ctx.pipelineCache, seeded from ctx.pipelineCachePath when the blob's header
+// matches this device's vendor ID, device ID and pipeline cache UUID
+bool vsdl_create_pipeline_cache(VSDL_Context& ctx);
+
+// Write the cache back to ctx.pipelineCachePath (temp file + rename)
+void vsdl_save_pipeline_cache(VSDL_Context& ctx);
+
+void vsdl_destroy_pipeline_cache(VSDL_Context& ctx);
+
+// Log cold vs warm creation time of the triangle pipeline
+void vsdl_benchmark_pipeline_cache(VSDL_Context& ctx);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,32 @@
+#ifndef VSDL_PROFILER_H
+#define VSDL_PROFILER_H
+
+#include "vsdl_types.h"
+
+// Create the timestamp query pool; without timestamp support only CPU scopes are recorded
+void vsdl_create_profiler(VSDL_Context& ctx);
+void vsdl_destroy_profiler(VSDL_Context& ctx);
+
+// Start GPU scopes for a ring slot (outside a render pass); resets the slot's queries
+void vsdl_profiler_begin_frame(VSDL_Context& ctx, VkCommandBuffer commandBuffer, uint32_t frameSlot);
+
+// Nested GPU scopes in the current frame's command buffer; names must be string literals
+void vsdl_gpu_scope_begin(VSDL_Context& ctx, VkCommandBuffer commandBuffer, const char* name);
+void vsdl_gpu_scope_end(VSDL_Context& ctx, VkCommandBuffer commandBuffer);
+
+// Read the slot's timestamps from the frame that last used it; call once its fence has signaled
+void vsdl_profiler_resolve(VSDL_Context& ctx, uint32_t frameSlot);
+
+// Record a CPU scope that started at SDL_GetPerformanceCounter() value start and ends now
+void vsdl_profiler_cpu_scope(VSDL_Context& ctx, const char* name, Uint64 start);
+
+// Most recent duration of a scope in milliseconds, 0 if it never ran
+float vsdl_profiler_last_ms(VSDL_Context& ctx, const char* name);
+
+// Overlay with rolling histograms of every track while open is set; its close button clears open
+void vsdl_profiler_draw_ui(VSDL_Context& ctx, bool& open);
+
+// Write the captured events as Chrome trace JSON (chrome://tracing, Perfetto)
+bool vsdl_profiler_write_trace(VSDL_Context& ctx, const std::string& path);
+
+#endif
\ No newline at end of file
@@ -3,6 +3,27 @@
 
 #include "vsdl_types.h"
 
+// Create/destroy the frames-in-flight ring (ctx.framesInFlight slots)
+void vsdl_create_frames(VSDL_Context& ctx);
+void vsdl_destroy_frames(VSDL_Context& ctx);
+
+// Build the ImGui frame that the next vsdl_record_frame call will render. Widgets edit settings
+// (ctx.uiSettings by default), which vsdl_record_frame applies; --threaded passes its own copy.
+void vsdl_build_ui(VSDL_Context& ctx, VSDL_UiSettings* settings = nullptr);
+
+// Begin/end the VkRenderPass on framebuffer imageIndex (the dynamic rendering path goes through ctx.frameGraph)
+void vsdl_begin_scene_pass(VSDL_Context& ctx, VkCommandBuffer commandBuffer, uint32_t imageIndex, bool secondaryContents);
+void vsdl_end_scene_pass(VSDL_Context& ctx, VkCommandBuffer commandBuffer, uint32_t imageIndex);
+
+// Record the scene and ImGui render pass into framebuffer imageIndex
+void vsdl_record_frame(VSDL_Context& ctx, VkCommandBuffer commandBuffer, uint32_t imageIndex);
+
+// Record, submit and present one frame using the current ring slot
+void vsdl_draw_frame(VSDL_Context& ctx);
+
 void vsdl_render_loop(VSDL_Context& ctx);
 
+// Render frameCount frames with 1..VSDL_MAX_FRAMES_IN_FLIGHT frames in flight and log the frame times
+void vsdl_benchmark_frames(VSDL_Context& ctx, uint32_t frameCount);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,33 @@
+#ifndef VSDL_SHADER_RELOAD_H
+#define VSDL_SHADER_RELOAD_H
+
+#include "vsdl_types.h"
+#include <functional>
+#include <initializer_list>
+
+// Set by CMake to the GLSL sources and the glslc found at configure time
+#ifndef VSDL_SHADER_SOURCE_DIR
+#define VSDL_SHADER_SOURCE_DIR "shaders"
+#endif
+#ifndef VSDL_GLSLC_PATH
+#define VSDL_GLSLC_PATH "glslc"
+#endif
+
+// Watch sourceDir and recompile changed GLSL into shaders/*.spv on a background thread
+void vsdl_create_shader_reloader(VSDL_Context& ctx, const std::string& sourceDir, const std::string& glslc);
+// Joins the thread and destroys pending and retired pipelines; the device must be idle
+void vsdl_destroy_shader_reloader(VSDL_Context& ctx);
+
+// Rebuild *pipeline with build() on the watcher thread whenever one of the named sources ("tri.frag") is
+// recompiled. No-op while hot-reload is off; *pipeline must outlive the reloader.
+void vsdl_shader_reload_register(VSDL_Context& ctx, std::initializer_list<const char*> sources, VkPipeline* pipeline,
+                                 std::function<VkPipeline(VSDL_Context&)> build);
+
+// Frame boundary: swap in pipelines finished since the last call and destroy replaced ones once every
+// frame that could still reference them has completed on the graphics timeline. Call before recording.
+void vsdl_shader_reload_apply(VSDL_Context& ctx);
+
+// One-line status for the UI ("3 reloads" or the last compiler error)
+std::string vsdl_shader_reload_status(VSDL_Context& ctx);
+
+#endif
\ No newline at end of file
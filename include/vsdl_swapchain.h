@@ -0,0 +1,23 @@
+#ifndef VSDL_SWAPCHAIN_H
+#define VSDL_SWAPCHAIN_H
+
+#include "vsdl_types.h"
+
+// Create the swapchain, its image views and per-image present semaphores.
+// Uses ctx.requestedPresentMode when supported, FIFO otherwise. A window minimized at startup only gets
+// its format chosen and ctx.swapchainOutOfDate set; the swapchain follows once it is restored.
+bool vsdl_create_swapchain(VSDL_Context& ctx);
+
+// Create the depth buffer and one framebuffer per swapchain image view for ctx.renderPass
+void vsdl_create_framebuffers(VSDL_Context& ctx);
+
+void vsdl_destroy_swapchain(VSDL_Context& ctx);
+
+// Rebuild the swapchain, image views and framebuffers after a resize or VK_ERROR_OUT_OF_DATE_KHR.
+// The render pass and pipelines are kept. Returns false while the window has no drawable area; throws
+// if the surface format changed.
+bool vsdl_recreate_swapchain(VSDL_Context& ctx);
+
+const char* vsdl_present_mode_name(VkPresentModeKHR mode);
+
+#endif
\ No newline at end of file
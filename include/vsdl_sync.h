@@ -0,0 +1,25 @@
+#ifndef VSDL_SYNC_H
+#define VSDL_SYNC_H
+
+#include "vsdl_types.h"
+
+// Create one timeline per queue kind; ctx.sync.timeline is decided at device creation
+bool vsdl_create_sync(VSDL_Context& ctx);
+// The device must be idle
+void vsdl_destroy_sync(VSDL_Context& ctx);
+
+// Submit one command buffer on the queue of kind and return the timeline value it signals on completion.
+// waits are values on other timelines, waitSemaphore/signalSemaphore optional binary semaphores
+// (swapchain acquire and present).
+uint64_t vsdl_queue_submit(VSDL_Context& ctx, VSDL_QueueKind kind, VkCommandBuffer commandBuffer,
+                           const std::vector<VSDL_QueueWait>& waits, VkSemaphore waitSemaphore = VK_NULL_HANDLE,
+                           VkPipelineStageFlags waitStage = 0, VkSemaphore signalSemaphore = VK_NULL_HANDLE);
+
+// Value the next submit on kind will signal: anything released now is unused once it has completed
+uint64_t vsdl_timeline_pending(VSDL_Context& ctx, VSDL_QueueKind kind);
+// Highest value known to have completed; polls without blocking
+uint64_t vsdl_timeline_completed(VSDL_Context& ctx, VSDL_QueueKind kind);
+// Block until value has completed; values not submitted yet are an error
+void vsdl_timeline_wait(VSDL_Context& ctx, VSDL_QueueKind kind, uint64_t value);
+
+#endif
\ No newline at end of file
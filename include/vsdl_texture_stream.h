@@ -0,0 +1,33 @@
+#ifndef VSDL_TEXTURE_STREAM_H
+#define VSDL_TEXTURE_STREAM_H
+
+#include "vsdl_types.h"
+
+// Start the decode workers and create the shared sampler; needs the upload queue
+bool vsdl_create_texture_streamer(VSDL_Context& ctx);
+// Drops queued decodes, joins the workers and destroys every texture; the device must be idle
+void vsdl_destroy_texture_streamer(VSDL_Context& ctx);
+
+// Queue a binary PPM (P6) or a true-color TGA (raw or RLE), looked up in ctx.archive before loose files.
+// Returns the texture id at once; nothing is resident until a worker has decoded it. sRGB, full mip chain.
+uint32_t vsdl_stream_texture(VSDL_Context& ctx, const std::string& path);
+// Same for RGBA8 pixels already in memory (UNORM); the mip chain is built on a worker when asked for
+uint32_t vsdl_stream_texture_pixels(VSDL_Context& ctx, const std::string& name, std::vector<uint8_t> pixels,
+                                    uint32_t width, uint32_t height, bool generateMips);
+
+// Frame boundary: create images for a few decoded textures and upload mips smallest first, round robin
+// over all streaming textures, within the frame's byte budget. Each texture whose finest level changed
+// gets a new view and bindless slot. Call after vsdl_descriptors_begin_frame and before recording.
+void vsdl_stream_update(VSDL_Context& ctx);
+
+// Block until the texture is fully resident (startup, loading screens). Waits on the decode workers and
+// the transfer queue only, never the graphics queue. Returns false when decoding failed.
+bool vsdl_stream_wait(VSDL_Context& ctx, uint32_t id);
+
+// Reference stays valid while the streamer lives; view and handle change as mips land
+const VSDL_Texture& vsdl_get_texture(VSDL_Context& ctx, uint32_t id);
+
+// One-line status for the UI ("12 / 300 resident, 4 streaming, 41.2 MB streamed"); safe from the simulation thread
+std::string vsdl_stream_status(VSDL_Context& ctx);
+
+#endif
\ No newline at end of file
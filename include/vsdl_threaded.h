@@ -0,0 +1,10 @@
+#ifndef VSDL_THREADED_H
+#define VSDL_THREADED_H
+
+#include "vsdl_types.h"
+
+// Run events, simulation and UI on the calling (main) thread at tickHz and render on a separate thread.
+// Snapshots pass through a lock-free triple buffer, so a GPU stall never delays input handling.
+void vsdl_threaded_loop(VSDL_Context& ctx, float tickHz);
+
+#endif
\ No newline at end of file
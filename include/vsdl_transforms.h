@@ -0,0 +1,18 @@
+#ifndef VSDL_TRANSFORMS_H
+#define VSDL_TRANSFORMS_H
+
+#include "vsdl_types.h"
+
+// Rebuild ctx.camera's matrices for the current swapchain aspect; call once per frame before recording
+void vsdl_update_camera(VSDL_Context& ctx);
+
+// Camera controls, appended to the current ImGui window; they edit camera, not ctx.camera
+void vsdl_camera_ui(VSDL_Camera& camera);
+
+// Scatter count spinning objects a bit past the default view, like vsdl_generate_instances
+void vsdl_generate_transforms(VSDL_Transforms& transforms, uint32_t count);
+
+// Advance every object's spin by dtSeconds and write its VSDL_ObjectData to out (count entries)
+void vsdl_update_transforms(VSDL_Transforms& transforms, float dtSeconds, VSDL_ObjectData* out);
+
+#endif
\ No newline at end of file
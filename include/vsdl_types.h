@@ -4,6 +4,15 @@
 #include <SDL3/SDL.h>
 #include <SDL3/SDL_vulkan.h>
 #include <vulkan/vulkan.h>
+#include "vk_mem_alloc.h"
+#include "vsdl_archive_format.h"
+#include <glm/glm.hpp>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 // Define VSDL_ENABLE_VALIDATION_LAYERS based on _DEBUG unless overridden
@@ -15,29 +24,698 @@
 #endif
 #endif
 
+// Upper bound for the frames-in-flight ring; the active count is VSDL_Context::framesInFlight
+#define VSDL_MAX_FRAMES_IN_FLIGHT 3
+
+// Resources owned by one slot of the frames-in-flight ring
+struct VSDL_Frame {
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    uint64_t timelineValue = 0; // Graphics timeline value of the slot's last submit
+    VkSemaphore imageAvailableSemaphore = VK_NULL_HANDLE;
+};
+
+// Queues with their own timeline
+enum class VSDL_QueueKind : uint32_t {
+    Graphics,
+    Transfer,
+    Compute,
+};
+#define VSDL_QUEUE_KIND_COUNT 3
+
+// GPU-side wait of a submit for a value on another queue's timeline
+struct VSDL_QueueWait {
+    VSDL_QueueKind kind = VSDL_QueueKind::Graphics;
+    uint64_t value = 0;
+    VkPipelineStageFlags stages = 0;
+};
+
+// Monotonic per-queue progress: a timeline semaphore, or without one a fence per submit plus binary
+// semaphores for other queues to wait on
+struct VSDL_Timeline {
+    VkQueue queue = VK_NULL_HANDLE;
+    VkSemaphore semaphore = VK_NULL_HANDLE; // Timeline mode only
+    uint64_t submitted = 0; // Value signaled by the latest submit
+    uint64_t completed = 0; // Cached, refreshed by vsdl_timeline_completed
+    std::vector<std::pair<uint64_t, VkFence>> fences; // Fallback: in flight, in submission order
+    std::vector<VkFence> freeFences;
+    std::vector<std::pair<uint64_t, VkSemaphore>> signals; // Fallback: not waited on by another queue yet
+    std::vector<std::pair<uint64_t, VkSemaphore>> waited; // Fallback: consumed by the submit with this value
+};
+
+struct VSDL_Sync {
+    bool timeline = false; // Timeline semaphores enabled on the device
+    PFN_vkWaitSemaphores waitSemaphores = nullptr;
+    PFN_vkGetSemaphoreCounterValue getSemaphoreCounterValue = nullptr;
+    VSDL_Timeline timelines[VSDL_QUEUE_KIND_COUNT]; // Indexed by VSDL_QueueKind
+    std::vector<VkSemaphore> freeSemaphores; // Fallback: unsignaled binary semaphores
+};
+
+// Allocation classes; the first VSDL_MEMORY_POOL_COUNT get their own VMA pool
+enum class VSDL_MemoryClass : uint32_t {
+    Static,   // Device-local geometry and other data uploaded once
+    Dynamic,  // Host-written every frame, read by the GPU
+    Staging,  // Host-written upload source for transfers
+    Readback, // GPU-written, read back on the host (default VMA allocations)
+};
+#define VSDL_MEMORY_POOL_COUNT 3
+
+// Buffer sub-allocated through VMA; mapped is non-null for host-visible classes
+struct VSDL_Buffer {
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VmaAllocation allocation = VK_NULL_HANDLE;
+    VkDeviceSize size = 0;
+    void* mapped = nullptr;
+};
+
+struct VSDL_Image {
+    VkImage image = VK_NULL_HANDLE;
+    VmaAllocation allocation = VK_NULL_HANDLE;
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    VkExtent3D extent = {};
+};
+
+struct VSDL_Vertex {
+    float position[3];
+    float color[3];
+};
+
+// Depth state of a scene pipeline; every test is reverse-Z
+enum class VSDL_DepthMode : uint32_t {
+    Opaque,      // GREATER_OR_EQUAL, writes depth
+    Prepass,     // Opaque without a fragment shader or color writes
+    Equal,       // Shading after a prepass: only the surviving fragment passes, no writes
+    Translucent, // GREATER_OR_EQUAL, no writes
+    Disabled,    // Overlays: no test, no writes
+};
+
+enum class VSDL_BlendMode : uint32_t {
+    Opaque,
+    Alpha,    // src * a + dst * (1 - a)
+    Additive, // src * a + dst
+    Premultiplied, // src + dst * (1 - a), alpha included; the shader has already multiplied by a
+};
+
+// Vertex buffer layout read by a pipeline; point lists never take one
+enum class VSDL_VertexInput : uint32_t {
+    Scene, // VSDL_Vertex
+    ImGui, // ImDrawVert
+    None,  // Vertices generated from gl_VertexIndex
+};
+
+#define VSDL_NO_SHADER UINT32_MAX   // Shader id of an absent stage
+#define VSDL_NO_PIPELINE UINT32_MAX // Pipeline id that was never requested
+
+// Everything that varies between our graphics pipelines, compared and hashed field by field. The rest is
+// fixed: dynamic viewport/scissor, one color attachment.
+struct VSDL_PipelineKey {
+    uint32_t vertShader = VSDL_NO_SHADER; // Ids from vsdl_pipeline_shader()
+    uint32_t fragShader = VSDL_NO_SHADER; // None for depth-only pipelines
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+    VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    VSDL_VertexInput vertexInput = VSDL_VertexInput::Scene;
+    VkCullModeFlags cullMode = VK_CULL_MODE_BACK_BIT;
+    VSDL_BlendMode blend = VSDL_BlendMode::Alpha;
+    VSDL_DepthMode depth = VSDL_DepthMode::Opaque;
+    VkRenderPass renderPass = VK_NULL_HANDLE; // Null on the dynamic rendering path, which uses the formats
+    VkFormat colorFormat = VK_FORMAT_UNDEFINED;
+    VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+
+    bool operator==(const VSDL_PipelineKey& other) const;
+};
+
+struct VSDL_PipelineKeyHash {
+    size_t operator()(const VSDL_PipelineKey& key) const; // FNV-1a over the fields, see vsdl_pipeline.cpp
+};
+
+typedef uint32_t VSDL_PipelineId; // Index into VSDL_PipelineLibrary::entries
+
+struct VSDL_PipelineEntry {
+    VSDL_PipelineKey key;
+    VkPipeline pipeline = VK_NULL_HANDLE; // Swapped in place by shader hot-reload
+};
+
+// Owns every graphics pipeline built from a key; a key built twice returns the first id.
+// Entries are only appended at load time or between frames, never while recording.
+struct VSDL_PipelineLibrary {
+    std::mutex mutex; // Guards shaders and ids
+    std::vector<std::string> shaders; // SPIR-V paths, indexed by shader id
+    std::deque<VSDL_PipelineEntry> entries; // A deque so the reloader's slots stay put as it grows
+    std::unordered_map<VSDL_PipelineKey, VSDL_PipelineId, VSDL_PipelineKeyHash> ids;
+    uint32_t hits = 0; // Requests answered from the library
+};
+
+// Device-local geometry; buffers come from the static pool and are filled through the upload queue
+struct VSDL_Mesh {
+    VSDL_Buffer vertexBuffer;
+    VSDL_Buffer indexBuffer;
+    uint32_t vertexCount = 0;
+    uint32_t indexCount = 0;
+};
+
+// One submission of copy commands; recycled once the transfer timeline reaches its timelineValue
+struct VSDL_UploadBatch {
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    uint64_t timelineValue = 0; // Transfer timeline value signaled when the copies are done
+    VkDeviceSize ringBytes = 0;             // Ring space (incl. wrap padding) released on completion
+    std::vector<VSDL_Buffer> oversizedStaging; // Uploads too large for the ring, freed on completion
+    bool recording = false;
+    bool inFlight = false;
+};
+
+#define VSDL_UPLOAD_BATCH_COUNT 4
+
+// Staging ring + batched copies, submitted on the transfer queue (the graphics queue if there is none)
+struct VSDL_UploadQueue {
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    VSDL_Buffer ring;
+    VkDeviceSize ringHead = 0; // Next write offset
+    VkDeviceSize ringUsed = 0; // Bytes owned by recording or in-flight batches
+    VSDL_UploadBatch batches[VSDL_UPLOAD_BATCH_COUNT];
+    uint32_t currentBatch = 0;
+    uint64_t waitedValue = 0; // Latest transfer value a graphics submit already waits for
+    uint64_t bytesUploaded = 0;
+};
+
+// Per-frame transient memory: a CPU bump region and a slice of a persistently mapped GPU ring per frame
+// slot. Both are reset once the slot's previous submit has completed, so nothing is freed individually.
+struct VSDL_FrameArena {
+    uint8_t* cpuMemory = nullptr; // framesInFlight regions of cpuBytesPerFrame
+    size_t cpuBytesPerFrame = 0;
+    size_t cpuHead = 0; // Offset within the current slot's region
+    VSDL_Buffer ring; // Dynamic class; slot i owns [i * gpuBytesPerFrame, (i + 1) * gpuBytesPerFrame)
+    VkDeviceSize gpuBytesPerFrame = 0;
+    VkDeviceSize gpuHead = 0;
+    VkDeviceSize uniformAlignment = 16; // Device minimum offset alignments, slices start on them
+    VkDeviceSize storageAlignment = 16;
+    VkDeviceSize uniformWindow = 0; // Descriptor ranges, clamped to the device limits
+    VkDeviceSize storageWindow = 0;
+    VkDescriptorSetLayout setLayout = VK_NULL_HANDLE; // Binding 0 dynamic uniform, binding 1 dynamic storage
+    VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+    VkDescriptorSet set = VK_NULL_HANDLE; // Windows onto the whole ring, placed by dynamic offsets
+    uint32_t slot = 0; // Frame slot being recorded
+    size_t lastCpuBytes = 0; // Usage of the last recorded frame
+    VkDeviceSize lastGpuBytes = 0;
+    size_t peakCpuBytes = 0;
+    VkDeviceSize peakGpuBytes = 0;
+};
+
+// Sub-range of the frame ring, valid until its frame slot comes around again
+struct VSDL_FrameSlice {
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkDeviceSize offset = 0; // Also the dynamic offset for VSDL_FrameArena::set
+    VkDeviceSize size = 0;
+    void* mapped = nullptr;
+};
+
+// Look-at camera. Projections are reverse-Z like the depth buffer and flip Y for Vulkan's clip space, so
+// world +Y is up. The default orthographic view shows world Y in [-1, 1] at the window's aspect.
+struct VSDL_Camera {
+    glm::vec3 position = glm::vec3(0.0f, 0.0f, 2.0f);
+    float yaw = 0.0f;   // Radians, 0 looks down -Z
+    float pitch = 0.0f; // Radians, positive looks up
+    bool perspective = false;
+    float fovY = 1.0471976f; // 60 degrees
+    float orthoHeight = 2.0f; // World units visible vertically
+    float nearZ = 0.05f;
+    float farZ = 100.0f; // Orthographic only; the perspective projection reaches infinity
+    glm::mat4 view = glm::mat4(1.0f);
+    glm::mat4 projection = glm::mat4(1.0f);
+    glm::mat4 viewProjection = glm::mat4(1.0f); // Refreshed once per frame by vsdl_update_camera
+};
+
+// Object transforms as structure-of-arrays: the per-frame update walks contiguous float arrays with no
+// dependency between lanes, so it vectorizes and scales linearly with the object count
+struct VSDL_Transforms {
+    uint32_t count = 0;
+    std::vector<float> positionX, positionY, positionZ;
+    std::vector<float> scale;
+    std::vector<float> angle; // Radians about Z, kept in [-pi, pi]
+    std::vector<float> spin;  // Radians per second
+    std::vector<float> colorR, colorG, colorB;
+};
+
+// Per-object record the direct-draw shaders index with a push constant (std430, 64 bytes)
+struct VSDL_ObjectData {
+    float world[3][4]; // Rows of the affine world matrix
+    float color[4];
+};
+
+// Per-instance data read by cull.comp and instanced.vert (std430, 32 bytes)
+struct VSDL_InstanceData {
+    float positionScale[4]; // xyz offset, w uniform scale
+    float color[4];
+};
+
+// GPU-driven instanced path: a compute pass culls instances and writes the indirect draw
+// Written by cull.comp: the indirect draw of the survivors followed by the rejection counters
+struct VSDL_CullOutput {
+    VkDrawIndexedIndirectCommand command; // instanceCount is the visible count
+    uint32_t frustumCulled;
+    uint32_t occlusionCulled;
+};
+
+// Hierarchical depth of the last rendered frame: mip i holds the farthest (reverse-Z minimum) depth of
+// each 2^(i+1) pixel square. Built after the scene pass, tested by the next frame's cull pass.
+#define VSDL_DEPTH_PYRAMID_MAX_LEVELS 16
+struct VSDL_DepthPyramid {
+    VSDL_Image image; // R32_SFLOAT, always in GENERAL
+    VkImageView view = VK_NULL_HANDLE; // All levels, sampled by the cull pass
+    VkImageView levelViews[VSDL_DEPTH_PYRAMID_MAX_LEVELS] = {};
+    uint32_t levelCount = 0;
+    VkExtent2D depthExtent = {}; // Depth buffer the pyramid was sized for
+    bool valid = false; // Holds a built frame; false after creation or resize
+    bool needsInit = true; // Image still in UNDEFINED
+    glm::mat4 viewProjection = glm::mat4(1.0f); // Camera of the frame the pyramid was built from
+    VkSampler sampler = VK_NULL_HANDLE; // Nearest, clamped; the shaders only use texelFetch
+    VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+    VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+    VkDescriptorSet depthSets[VSDL_MAX_FRAMES_IN_FLIGHT] = {}; // Depth buffer -> level 0, rewritten every frame
+    VkDescriptorSet levelSets[VSDL_DEPTH_PYRAMID_MAX_LEVELS] = {}; // Level i - 1 -> level i
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline pipeline = VK_NULL_HANDLE;
+};
+
+struct VSDL_Instancing {
+    uint32_t instanceCount = 0; // 0 disables the instanced path
+    bool occlusionCulling = true; // Also test against the previous frame's depth pyramid
+    VSDL_Buffer instanceBuffer;
+    VSDL_Buffer visibleBuffers[VSDL_MAX_FRAMES_IN_FLIGHT];  // Indices of surviving instances, per frame slot
+    VSDL_Buffer indirectBuffers[VSDL_MAX_FRAMES_IN_FLIGHT]; // VSDL_CullOutput, per frame slot
+    VSDL_Buffer statsReadback[VSDL_MAX_FRAMES_IN_FLIGHT];   // Copy of the slot's VSDL_CullOutput
+    bool statsPending[VSDL_MAX_FRAMES_IN_FLIGHT] = {};      // A copy was submitted and not read yet
+    VSDL_CullOutput lastStats = {}; // From the newest completed frame; lags the recorded one by the ring depth
+    uint32_t paramsOffset = 0; // Frame arena offset of this frame's cull/camera uniform
+    VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+    VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+    VkDescriptorSet descriptorSets[VSDL_MAX_FRAMES_IN_FLIGHT] = {};
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline cullPipeline = VK_NULL_HANDLE;
+    VSDL_PipelineId drawPipeline = VSDL_NO_PIPELINE;
+    VSDL_PipelineId depthPipeline = VSDL_NO_PIPELINE; // Depth prepass only
+};
+
+// GPU particle simulation. Async mode steps it on the dedicated compute queue one frame ahead of the
+// graphics queue drawing the previous step; otherwise the dispatch is recorded inline before the pass.
+// Buffers are exclusive to one family at a time and change hands through release/acquire barriers.
+struct VSDL_Particles {
+    uint32_t count = 0; // 0 disables the simulation
+    bool async = false; // Stepping on ctx.computeQueue
+    bool needsInit = true; // Next step seeds the state instead of integrating it
+    uint64_t step = 0; // Steps recorded so far; step n writes positions[n % 2]
+    uint32_t drawBuffer = UINT32_MAX; // positions[] index the frame being recorded draws, none before the first step
+    float time = 0.0f;
+    VSDL_Buffer state; // Position and velocity, only touched by the simulation
+    VSDL_Buffer positions[2]; // Drawn by graphics while the simulation writes the other one
+    uint64_t computeValues[2] = {}; // Async: compute timeline value of the step that wrote each buffer
+    uint64_t releaseValues[2] = {}; // Async: graphics timeline value of the frame that released each buffer, 0 if never drawn
+    VkCommandPool computePool = VK_NULL_HANDLE; // On the compute family
+    VkCommandBuffer computeCommandBuffers[VSDL_MAX_FRAMES_IN_FLIGHT] = {};
+    uint64_t computeSlotValues[VSDL_MAX_FRAMES_IN_FLIGHT] = {}; // Compute timeline value of each command buffer's last submit
+    VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+    VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+    VkDescriptorSet descriptorSets[2] = {}; // State plus positions[i]
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE; // Shared by the simulation and the point draw
+    VkPipeline simulatePipeline = VK_NULL_HANDLE;
+    VSDL_PipelineId drawPipeline = VSDL_NO_PIPELINE;
+};
+
+// Secondary command buffer recorded by one job; the pool is only ever touched by that job
+struct VSDL_WorkerFrame {
+    VkCommandPool commandPool = VK_NULL_HANDLE;
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+};
+
+struct ImDrawData; // imgui.h
+struct VSDL_JobSystem; // Opaque worker thread pool, see vsdl_jobs.h
+struct VSDL_ShaderReloader; // Opaque shader watcher/compiler thread, see vsdl_shader_reload.h
+struct VSDL_TextureStreamer; // Opaque decode workers and upload scheduler, see vsdl_texture_stream.h
+
+enum class VSDL_UiMode : uint32_t {
+    Direct, // ImGui's backend uploads and records the whole UI every frame
+    Cached, // An unchanged UI replays geometry cached in device-local buffers
+    Layer,  // The UI is drawn into an offscreen layer only when it changes and composited every frame
+};
+
+// One ImDrawCmd, already projected to framebuffer space
+struct VSDL_UiDraw {
+    VkRect2D scissor = {};
+    VkDescriptorSet texture = VK_NULL_HANDLE; // The command's ImTextureID
+    uint32_t indexCount = 0;
+    uint32_t firstIndex = 0;
+    int32_t vertexOffset = 0;
+};
+
+// A frame slot's copy of the UI; only that slot's frames read it, so it is rebuilt when the slot comes around
+struct VSDL_UiCacheSlot {
+    VSDL_Buffer vertexBuffer; // Static pool, filled through the upload queue
+    VSDL_Buffer indexBuffer;
+    std::vector<VSDL_UiDraw> draws;
+    float transform[4] = {}; // Scale and translate into clip space, ImGui's push constants
+    VkViewport viewport = {};
+    uint64_t hash = 0; // Draw data hash the slot was built from
+    bool valid = false;
+};
+
+// How the ImGui overlay reaches the screen. Every frame's draw data is hashed (vertices, indices, commands
+// and display rect); an unchanged hash lets Cached and Layer modes skip the re-upload and re-record.
+struct VSDL_UiRenderer {
+    VSDL_UiMode mode = VSDL_UiMode::Cached; // Set through vsdl_set_ui_mode
+    ImDrawData* drawData = nullptr; // This frame's UI, set by vsdl::imgui_prepare
+    uint64_t hash = 0;
+    uint32_t stableFrames = 0; // Frames in a row with the same hash
+    uint64_t reusedFrames = 0; // Frames drawn from a cache slot or the layer as they were
+    uint64_t redrawnFrames = 0;
+    std::atomic<bool> lastReused{false}; // Shown by the UI, which runs on the simulation thread in --threaded mode
+    VkDescriptorSetLayout setLayout = VK_NULL_HANDLE; // Same as the backend's, so its texture sets bind here
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    VSDL_PipelineId pipeline = VSDL_NO_PIPELINE;          // ImDrawVert into the scene pass
+    VSDL_PipelineId layerPipeline = VSDL_NO_PIPELINE;     // ImDrawVert into the layer, handed to the backend
+    VSDL_PipelineId compositePipeline = VSDL_NO_PIPELINE; // Fullscreen layer blend into the scene pass
+    VSDL_UiCacheSlot slots[VSDL_MAX_FRAMES_IN_FLIGHT];
+    // Layer mode; the image is created on first use and dropped on resize
+    VSDL_Image layer; // Swapchain format and extent, premultiplied alpha
+    VkImageView layerView = VK_NULL_HANDLE;
+    VkRenderPass layerPass = VK_NULL_HANDLE; // Render pass path only
+    VkFramebuffer layerFramebuffer = VK_NULL_HANDLE;
+    VkSampler layerSampler = VK_NULL_HANDLE;
+    VkDescriptorSet layerTexture = VK_NULL_HANDLE; // From the backend's pool
+    uint64_t layerHash = 0;
+    bool layerValid = false;
+};
+
+// What the UI widgets edit. vsdl_record_frame applies it at the start of each frame, so in --threaded mode
+// the simulation thread edits its own copy and publishes it with the snapshot instead of touching ctx.
+struct VSDL_UiSettings {
+    VSDL_Camera camera; // Inputs only; the matrices are rebuilt from them when applied
+    bool occlusionCulling = true; // Copied to ctx.instancing.occlusionCulling
+    VSDL_UiMode uiMode = VSDL_UiMode::Cached; // Applied through vsdl_set_ui_mode, which restarts the cache
+    bool showProfiler = false; // Copied to ctx.profiler.showOverlay; off like Statistics, its histograms never hold still
+};
+
+// The per-frame numbers the UI shows, copied out at the end of vsdl_record_frame. Atomic because in
+// --threaded mode the UI reads them on the simulation thread while the render thread records the next frame.
+struct VSDL_FrameStats {
+    std::atomic<double> recordMs{0.0};
+    std::atomic<uint32_t> visibleInstances{0};
+    std::atomic<uint32_t> frustumCulled{0};
+    std::atomic<uint32_t> occlusionCulled{0};
+    std::atomic<uint64_t> arenaCpuBytes{0};
+    std::atomic<uint64_t> arenaGpuBytes{0};
+    std::atomic<uint64_t> arenaPeakCpuBytes{0};
+    std::atomic<uint64_t> arenaPeakGpuBytes{0};
+};
+
+// CPU-driven scene: one draw per object, optionally recorded in parallel. Each frame the object records go
+// to a frame arena storage slice and the camera to a uniform slice; draws only push their object index.
+struct VSDL_ParallelRecording {
+    VSDL_Transforms objects; // No objects disables the direct-draw scene
+    uint32_t cameraOffset = 0; // Dynamic offsets into the frame arena for the frame being recorded
+    uint32_t objectOffset = 0;
+    Uint64 lastUpdateNs = 0; // 0 until the first update
+    uint32_t workerCount = 0; // 0 records everything inline on the main thread
+    VSDL_JobSystem* jobs = nullptr;
+    std::vector<VSDL_WorkerFrame> workerFrames[VSDL_MAX_FRAMES_IN_FLIGHT]; // [frame slot][job]
+    VSDL_WorkerFrame uiFrames[VSDL_MAX_FRAMES_IN_FLIGHT]; // ImGui secondary, recorded by the main thread
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    VSDL_PipelineId pipeline = VSDL_NO_PIPELINE;
+    VSDL_PipelineId depthPipeline = VSDL_NO_PIPELINE; // Depth prepass only
+};
+
+struct VSDL_Context;
+
+// How a render graph pass touches an image; determines layout, stages, access and usage
+enum class VSDL_GraphAccess : uint32_t {
+    ColorAttachment, // Write (cleared on first use, loaded afterwards)
+    DepthAttachment, // Write
+    DepthRead,       // Read-only depth test
+    Sampled,         // Fragment or compute shader read
+    StorageRead,
+    StorageWrite,
+    TransferSrc,
+    TransferDst,
+};
+
+struct VSDL_GraphUse {
+    uint32_t resource = 0;
+    VSDL_GraphAccess access = VSDL_GraphAccess::Sampled;
+};
+
+// Stages/access use only bits shared by synchronization2 and the 1.0 barrier path
+struct VSDL_GraphBarrier {
+    uint32_t resource = 0;
+    VkImageLayout oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    VkImageLayout newLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    VkPipelineStageFlags2 srcStage = 0;
+    VkAccessFlags2 srcAccess = 0;
+    VkPipelineStageFlags2 dstStage = 0;
+    VkAccessFlags2 dstAccess = 0;
+};
+
+struct VSDL_GraphResource {
+    const char* name = nullptr; // String literal
+    bool imported = false; // Owned elsewhere (swapchain image); bound per frame with vsdl_graph_bind_image
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    VkImageUsageFlags usage = 0; // Accumulated from the declared uses
+    VkClearValue clearValue = {};
+    VkImage image = VK_NULL_HANDLE;
+    VkImageView view = VK_NULL_HANDLE;
+    VkImageLayout initialLayout = VK_IMAGE_LAYOUT_UNDEFINED; // Imported only
+    VkImageLayout finalLayout = VK_IMAGE_LAYOUT_UNDEFINED;   // Imported only
+    uint32_t firstPass = UINT32_MAX; // Lifetime over live passes, UINT32_MAX if never used
+    uint32_t lastPass = 0;
+    VkDeviceSize memoryOffset = 0; // Transient only: placement in the shared aliasing allocation
+    VkDeviceSize memorySize = 0;
+};
+
+struct VSDL_GraphPass {
+    const char* name = nullptr; // String literal, doubles as the GPU profiler scope
+    std::vector<VSDL_GraphUse> uses;
+    std::function<void(VSDL_Context&, VkCommandBuffer)> record;
+    bool secondaryContents = false; // Begin rendering for vkCmdExecuteCommands
+    bool culled = false;
+    std::vector<VSDL_GraphBarrier> barriers; // Emitted before the pass
+};
+
+// Passes run in declaration order; compile culls, places barriers and aliases transient images
+struct VSDL_RenderGraph {
+    VkExtent2D extent = {}; // Size of every transient image
+    std::vector<VSDL_GraphResource> resources;
+    std::vector<VSDL_GraphPass> passes;
+    std::vector<uint32_t> outputs; // Resources whose writers are never culled
+    std::vector<VSDL_GraphBarrier> finalBarriers; // Imported images to their final layouts
+    VmaAllocation transientMemory = VK_NULL_HANDLE;
+    VkDeviceSize transientBytes = 0;
+    VkDeviceSize unaliasedBytes = 0; // What the transients would take with one allocation each
+    bool compiled = false;
+};
+
+#define VSDL_PROFILER_MAX_SCOPES 32   // GPU scopes per frame
+#define VSDL_PROFILER_HISTORY 120     // Samples kept per track for the histograms
+
+// Rolling timings of one named CPU or GPU scope
+struct VSDL_ProfilerTrack {
+    const char* name = nullptr; // Scope names are string literals
+    bool gpu = false;
+    float history[VSDL_PROFILER_HISTORY] = {};
+    uint32_t head = 0; // Next history slot
+    float lastMs = 0.0f;
+};
+
+struct VSDL_ProfilerGpuScope {
+    uint32_t track = 0;
+    uint32_t beginQuery = 0;
+    uint32_t endQuery = 0;
+};
+
+// GPU scopes written by the frame that last used a ring slot, resolved once its fence signals
+struct VSDL_ProfilerFrame {
+    VSDL_ProfilerGpuScope scopes[VSDL_PROFILER_MAX_SCOPES];
+    uint32_t scopeCount = 0;
+    uint32_t queryCount = 0;
+    uint32_t openScopes[VSDL_PROFILER_MAX_SCOPES] = {}; // Stack of indices into scopes
+    uint32_t openCount = 0;
+    double cpuStartUs = 0.0; // Record start, used to place GPU scopes on the trace timeline
+    bool pending = false;
+};
+
+// Complete ("X") event of the Chrome trace format
+struct VSDL_TraceEvent {
+    const char* name;
+    bool gpu;
+    double startUs;
+    double durationUs;
+};
+
+struct VSDL_Profiler {
+    VkQueryPool queryPool = VK_NULL_HANDLE; // 2 * VSDL_PROFILER_MAX_SCOPES queries per frame slot
+    float timestampPeriod = 0.0f; // Nanoseconds per tick
+    uint64_t timestampMask = ~0ull; // timestampValidBits of the graphics queue
+    VSDL_ProfilerFrame frames[VSDL_MAX_FRAMES_IN_FLIGHT];
+    uint32_t recordingSlot = 0;
+    std::vector<VSDL_ProfilerTrack> tracks;
+    Uint64 epoch = 0; // Trace timestamps are relative to profiler creation
+    bool showOverlay = false; // Applied from VSDL_UiSettings::showProfiler by vsdl_record_frame
+    std::string tracePath; // Empty disables trace capture
+    std::vector<VSDL_TraceEvent> traceEvents;
+    std::recursive_mutex mutex; // Tracks are shared by the simulation and render threads in threaded mode
+};
+
+// Offscreen color target + readback buffer used in place of a swapchain image in headless mode
+struct VSDL_OffscreenTarget {
+    VSDL_Image image;
+    VSDL_Buffer readback;
+    bool pending = false;    // A copy into readbackBuffer was submitted and not consumed yet
+    uint64_t frameIndex = 0; // Frame whose pixels the pending copy holds
+};
+
+struct VSDL_HeadlessConfig {
+    uint32_t width = 800;
+    uint32_t height = 600;
+    uint32_t frameCount = 120;
+    float targetFps = 0.0f;   // 0 renders as fast as possible
+    std::string outputDir;    // Empty disables dumping frames to disk
+};
+
+#define VSDL_BINDLESS_MAX_TEXTURES 4096 // Upper bound, clamped to the device's update-after-bind limits
+#define VSDL_BINDLESS_MAX_BUFFERS 4096
+#define VSDL_BINDLESS_INVALID UINT32_MAX
+
+enum class VSDL_BindlessKind : uint32_t {
+    Texture, // Binding 0: combined image sampler array
+    Buffer,  // Binding 1: storage buffer array
+};
+
+// Slot in the global bindless table; index is the array element shaders use
+struct VSDL_BindlessHandle {
+    uint32_t index = VSDL_BINDLESS_INVALID;
+    VSDL_BindlessKind kind = VSDL_BindlessKind::Texture;
+};
+
+// Linear allocator for sets that live for one frame; reset wholesale when the slot comes around again
+struct VSDL_FrameDescriptors {
+    std::vector<VkDescriptorPool> pools; // Grows by one pool when the current one runs out
+    uint32_t activePool = 0;
+};
+
+struct VSDL_Descriptors {
+    bool bindless = false; // Descriptor indexing with update-after-bind is available
+    VkDescriptorSetLayout bindlessLayout = VK_NULL_HANDLE;
+    VkDescriptorPool bindlessPool = VK_NULL_HANDLE;
+    VkDescriptorSet bindlessSet = VK_NULL_HANDLE; // Bound once per frame, never reallocated
+    uint32_t capacity[2] = {}; // Indexed by VSDL_BindlessKind
+    uint32_t used[2] = {};     // High-water mark
+    std::vector<uint32_t> freeSlots[2];
+    std::vector<std::pair<VSDL_BindlessHandle, uint64_t>> pendingFrees; // Handle and the graphics value that releases it
+    VSDL_FrameDescriptors frames[VSDL_MAX_FRAMES_IN_FLIGHT];
+};
+
+// Streamed texture: mips land smallest first and the view widens to each one as it becomes visible
+struct VSDL_Texture {
+    VSDL_Image image;
+    VkImageView view = VK_NULL_HANDLE; // Covers residentMip .. mipLevels - 1; null until the first mip lands
+    VkSampler sampler = VK_NULL_HANDLE; // Shared by all streamed textures
+    VSDL_BindlessHandle handle; // Follows view, so read it every frame; invalid without a bindless table
+    uint32_t mipLevels = 0;
+    uint32_t residentMip = UINT32_MAX; // Finest visible level
+    bool failed = false; // Decoding failed, the texture never becomes resident
+    std::string name;
+};
+
+// Read-only mapping of a packed asset archive; entries and views point straight into it
+struct VSDL_Archive {
+    const uint8_t* data = nullptr; // Null when no archive is open
+    size_t size = 0;
+    const VSDL_ArchiveEntry* entries = nullptr; // Sorted by name
+    uint32_t entryCount = 0;
+    void* fileHandle = nullptr;    // Windows only
+    void* mappingHandle = nullptr; // Windows only
+};
+
+// Vulkan 1.3 dynamic rendering + synchronization2; entry points are loaded per device so a 1.0 loader still links
+struct VSDL_DynamicRendering {
+    bool enabled = false; // No VkRenderPass/VkFramebuffer objects are created when set
+    PFN_vkCmdBeginRendering cmdBeginRendering = nullptr;
+    PFN_vkCmdEndRendering cmdEndRendering = nullptr;
+    PFN_vkCmdPipelineBarrier2 cmdPipelineBarrier2 = nullptr;
+};
+
 struct VSDL_Context {
+    bool headless = false; // Render into offscreen images without a surface
+    VSDL_HeadlessConfig headlessConfig;
     SDL_Window* window = nullptr;
     VkInstance instance = VK_NULL_HANDLE;
     VkDebugUtilsMessengerEXT debugMessenger = VK_NULL_HANDLE;
     VkSurfaceKHR surface = VK_NULL_HANDLE;
     VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+    std::string deviceOverride; // GPU index or name substring, overrides VSDL_DEVICE; empty picks by score
     VkDevice device = VK_NULL_HANDLE;
+    uint32_t apiVersion = VK_API_VERSION_1_0; // Instance/device version actually in use
+    bool requestDynamicRendering = false; // Opt into the Vulkan 1.3 path when the device supports it
+    VSDL_DynamicRendering dynamicRendering;
+    VmaAllocator allocator = VK_NULL_HANDLE;
+    VmaPool memoryPools[VSDL_MEMORY_POOL_COUNT] = {}; // Indexed by VSDL_MemoryClass
+    bool memoryBudgetSupported = false; // VK_EXT_memory_budget enabled, otherwise VMA estimates
     VkQueue graphicsQueue = VK_NULL_HANDLE;
     VkQueue presentQueue = VK_NULL_HANDLE;
+    VkQueue transferQueue = VK_NULL_HANDLE; // Same as graphicsQueue when there is no dedicated transfer family
+    uint32_t transferQueueFamilyIndex = 0;
+    VkQueue computeQueue = VK_NULL_HANDLE; // Same as graphicsQueue when there is no dedicated compute family
+    uint32_t computeQueueFamilyIndex = 0;
+    bool requestTimeline = true; // Cleared to force the fence fallback of the sync layer
+    VSDL_Sync sync;
+    VSDL_UploadQueue uploads;
+    VSDL_FrameArena frameArena;
+    VSDL_Camera camera;
+    VSDL_UiSettings uiSettings; // Edited by vsdl_build_ui, applied by vsdl_record_frame
+    VSDL_DepthPyramid depthPyramid; // Created with the instanced path, which is its only user
+    std::vector<VSDL_Mesh> meshes;
+    VSDL_Instancing instancing;
+    VSDL_Particles particles;
+    VSDL_Profiler profiler;
+    VSDL_ParallelRecording parallel;
+    VSDL_RenderGraph frameGraph; // Dynamic rendering path only; rebuilt after swapchain recreation
+    double lastRecordMs = 0.0; // CPU time of the last vsdl_record_frame call
+    VSDL_FrameStats frameStats; // The UI's copy of the numbers above, safe to read from any thread
+    ImDrawData* uiDrawData = nullptr; // Threaded mode: snapshot to render instead of the live ImGui frame
+    VSDL_UiRenderer ui;
     VkSwapchainKHR swapchain = VK_NULL_HANDLE;
     VkFormat swapchainImageFormat = VK_FORMAT_UNDEFINED;
     VkExtent2D swapchainExtent = {};
+    VkPresentModeKHR requestedPresentMode = VK_PRESENT_MODE_FIFO_KHR; // Falls back to FIFO when unsupported
+    VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR;
+    uint32_t swapchainMinImageCount = 2;
+    bool swapchainOutOfDate = false; // Set on resize/out-of-date, handled at the next frame
     std::vector<VkImage> swapchainImages;
     std::vector<VkImageView> swapchainImageViews;
-    VkRenderPass renderPass = VK_NULL_HANDLE;
+    std::vector<VSDL_OffscreenTarget> offscreenTargets; // Headless mode only, one per frame in flight
+    VkRenderPass renderPass = VK_NULL_HANDLE; // Null on the dynamic rendering path
     VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
-    VkPipeline graphicsPipeline = VK_NULL_HANDLE;
+    VSDL_PipelineId graphicsPipeline = VSDL_NO_PIPELINE;
+    VSDL_PipelineId depthPipeline = VSDL_NO_PIPELINE; // Depth-only variant of graphicsPipeline, prepass only
+    // Reverse-Z: depth is cleared to 0 and nearer fragments have larger values, so the float format's
+    // precision sits where perspective needs it
+    VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+    bool depthSampled = false; // depthFormat supports sampling, which the depth pyramid's reduction needs
+    bool depthPrepass = false; // Lay down depth first, then shade with an EQUAL test so each pixel shades once
+    VSDL_Image depthImage; // Render pass path; the dynamic rendering path's graph owns its own
+    VkImageView depthView = VK_NULL_HANDLE;
+    VkPipelineCache pipelineCache = VK_NULL_HANDLE; // Shared by our pipelines and ImGui's
+    VSDL_PipelineLibrary pipelineLibrary;
+    VSDL_ShaderReloader* shaderReloader = nullptr; // Null unless shader hot-reload is on
+    VSDL_Archive archive; // Checked by loaders before loose files
+    VSDL_Descriptors descriptors;
+    VSDL_TextureStreamer* textureStreamer = nullptr;
+    uint32_t fontTexture = UINT32_MAX; // ImGui font atlas, streamed like any other texture
+    std::string archivePath = "assets.vpk";
+    std::string pipelineCachePath = "pipeline_cache.bin";
+    bool pipelineCacheWarm = false; // True when the cache was seeded from disk
     std::vector<VkFramebuffer> framebuffers;
     VkCommandPool commandPool = VK_NULL_HANDLE;
-    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
-    VkSemaphore imageAvailableSemaphore = VK_NULL_HANDLE;
-    VkSemaphore renderFinishedSemaphore = VK_NULL_HANDLE;
-    VkFence inFlightFence = VK_NULL_HANDLE;
+    uint32_t framesInFlight = 2;
+    uint32_t currentFrame = 0;
+    VSDL_Frame frames[VSDL_MAX_FRAMES_IN_FLIGHT];
+    std::vector<VkSemaphore> renderFinishedSemaphores; // One per swapchain image
+    std::vector<uint64_t> imagesInFlight; // Graphics timeline value of the frame that last used each swapchain image
     VkDescriptorPool imguiDescriptorPool = VK_NULL_HANDLE;
     uint32_t graphicsQueueFamilyIndex = 0;
 };
@@ -0,0 +1,30 @@
+#ifndef VSDL_UI_CACHE_H
+#define VSDL_UI_CACHE_H
+
+#include "vsdl_types.h"
+
+// Create the UI pipelines and the layer render pass after ImGui's backend is up; throws on failure
+void vsdl_create_ui_cache(VSDL_Context& ctx);
+void vsdl_destroy_ui_cache(VSDL_Context& ctx);
+
+// Drop the layer and every cached slot after a swapchain rebuild; the device must be idle
+void vsdl_resize_ui_cache(VSDL_Context& ctx);
+
+// Switch how the UI is drawn; a change starts the cache over. Called by vsdl_record_frame with the UI's setting.
+void vsdl_set_ui_mode(VSDL_Context& ctx, VSDL_UiMode mode);
+
+// Take this frame's draw data and hash it; once per frame, before any UI is recorded
+void vsdl_ui_begin_frame(VSDL_Context& ctx, ImDrawData* drawData);
+
+// Layer mode: redraw the layer when the UI changed. Recorded outside any render pass.
+void vsdl_record_ui_layer(VSDL_Context& ctx, VkCommandBuffer commandBuffer);
+
+// Inside the scene pass: replay a cache slot or composite the layer. False when the caller has to draw the
+// UI through the backend instead (Direct mode, or a UI that has not settled yet).
+bool vsdl_record_ui(VSDL_Context& ctx, VkCommandBuffer commandBuffer);
+
+const char* vsdl_ui_mode_name(VSDL_UiMode mode);
+// Mode selection, appended to the current ImGui window; it edits settings, not ctx.ui
+void vsdl_ui_cache_ui(VSDL_Context& ctx, VSDL_UiSettings& settings);
+
+#endif
\ No newline at end of file
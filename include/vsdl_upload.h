@@ -0,0 +1,30 @@
+#ifndef VSDL_UPLOAD_H
+#define VSDL_UPLOAD_H
+
+#include "vsdl_types.h"
+
+// Stages of the graphics submit that wait for uploads: anything reading geometry, storage buffers or textures
+#define VSDL_UPLOAD_WAIT_STAGES (VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | \
+                                 VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT)
+
+// Create the staging ring and upload batches on ctx.transferQueueFamilyIndex
+bool vsdl_create_upload_queue(VSDL_Context& ctx);
+void vsdl_destroy_upload_queue(VSDL_Context& ctx);
+
+// Copy data into the staging ring and record a copy into dst; nothing is submitted until the next flush
+void vsdl_upload_buffer(VSDL_Context& ctx, const void* data, VkDeviceSize size, VSDL_Buffer& dst, VkDeviceSize dstOffset = 0);
+
+// Copy tightly packed texels into one mip level of a single-layer color image and leave that level in
+// SHADER_READ_ONLY_OPTIMAL. The level's previous contents are discarded; dst must be usable by both queue
+// families (concurrent sharing), as there is no ownership transfer.
+void vsdl_upload_image(VSDL_Context& ctx, const void* data, VkDeviceSize size, VSDL_Image& dst, uint32_t mipLevel);
+
+// Submit the recorded copies and recycle finished batches. Returns the transfer timeline wait (if any)
+// the next graphics submit must include; call it right before that submit.
+std::vector<VSDL_QueueWait> vsdl_flush_uploads(VSDL_Context& ctx);
+
+// Submit the recorded copies and block until every batch has completed. Only waits on the transfer timeline,
+// for loading screens and startup; the next graphics submit then has nothing to wait for.
+void vsdl_finish_uploads(VSDL_Context& ctx);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,21 @@
+#version 450
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inColor;
+layout(location = 0) out vec3 fragColor;
+
+// Frame arena set: both bindings are dynamic, offset per frame
+layout(set = 0, binding = 0) uniform Camera { mat4 viewProjection; } camera;
+struct Object {
+    mat3x4 world; // Rows of the affine world transform
+    vec4 color;
+};
+layout(std430, set = 0, binding = 1) readonly buffer Objects { Object objects[]; };
+
+layout(push_constant) uniform Push { uint objectIndex; } pc;
+
+void main() {
+    Object object = objects[pc.objectIndex];
+    vec3 worldPosition = vec4(inPosition, 1.0) * object.world;
+    gl_Position = camera.viewProjection * vec4(worldPosition, 1.0);
+    fragColor = inColor * object.color.rgb;
+}
\ No newline at end of file
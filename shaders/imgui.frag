@@ -0,0 +1,12 @@
+#version 450
+layout(location = 0) in vec4 fragColor;
+layout(location = 1) in vec2 fragUV;
+layout(location = 0) out vec4 outColor;
+
+layout(set = 0, binding = 0) uniform sampler2D uiTexture;
+
+void main() {
+    // Premultiplied, so the same blend lands on the screen and accumulates coverage in the transparent layer
+    vec4 color = fragColor * texture(uiTexture, fragUV);
+    outColor = vec4(color.rgb * color.a, color.a);
+}
\ No newline at end of file
@@ -0,0 +1,19 @@
+#version 450
+layout(location = 0) in vec2 inPosition;
+layout(location = 1) in vec2 inUV;
+layout(location = 2) in vec4 inColor;
+
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out vec2 fragUV;
+
+// Same push constants as ImGui's own shaders, so the backend can draw with this pipeline
+layout(push_constant) uniform Transform {
+    vec2 scale;
+    vec2 translate;
+} transform;
+
+void main() {
+    fragColor = inColor;
+    fragUV = inUV;
+    gl_Position = vec4(inPosition * transform.scale + transform.translate, 0.0, 1.0);
+}
\ No newline at end of file
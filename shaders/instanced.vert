@@ -0,0 +1,19 @@
+#version 450
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inColor;
+layout(location = 0) out vec3 fragColor;
+
+struct Instance {
+    vec4 positionScale;
+    vec4 color;
+};
+layout(std430, set = 0, binding = 0) readonly buffer Instances { Instance instances[]; };
+layout(std430, set = 0, binding = 1) readonly buffer Visible { uint visible[]; };
+layout(set = 1, binding = 0) uniform Cull { mat4 viewProjection; } camera; // Leading member of the cull parameters
+
+void main() {
+    Instance instance = instances[visible[gl_InstanceIndex]];
+    vec3 worldPosition = inPosition * instance.positionScale.w + instance.positionScale.xyz;
+    gl_Position = camera.viewProjection * vec4(worldPosition, 1.0);
+    fragColor = inColor * instance.color.rgb;
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+#version 450
+layout(location = 0) out vec3 fragColor;
+
+layout(std430, set = 0, binding = 1) readonly buffer Positions { vec4 positions[]; };
+
+void main() {
+    // xy position, z speed
+    vec4 particle = positions[gl_VertexIndex];
+    gl_Position = vec4(particle.xy, 0.0, 1.0);
+    gl_PointSize = 1.0;
+    fragColor = mix(vec3(0.2, 0.4, 1.0), vec3(1.0, 0.6, 0.2), clamp(particle.z * 1.5, 0.0, 1.0));
+}
\ No newline at end of file
@@ -1,8 +1,11 @@
 #version 450
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inColor;
 layout(location = 0) out vec3 fragColor;
-vec2 positions[3] = vec2[](vec2(0.0, -0.5), vec2(0.5, 0.5), vec2(-0.5, 0.5));
-vec3 colors[3] = vec3[](vec3(1.0, 0.0, 0.0), vec3(0.0, 1.0, 0.0), vec3(0.0, 0.0, 1.0));
+
+layout(push_constant) uniform Push { mat4 viewProjection; } camera;
+
 void main() {
-    gl_Position = vec4(positions[gl_VertexIndex], 0.0, 1.0);
-    fragColor = colors[gl_VertexIndex];
+    gl_Position = camera.viewProjection * vec4(inPosition, 1.0);
+    fragColor = inColor;
 }
\ No newline at end of file
@@ -0,0 +1,9 @@
+#version 450
+layout(location = 0) out vec4 outColor;
+
+layout(set = 0, binding = 0) uniform sampler2D layer;
+
+void main() {
+    // The layer has the swapchain extent, so pixels map one to one
+    outColor = texelFetch(layer, ivec2(gl_FragCoord.xy), 0);
+}
\ No newline at end of file
@@ -0,0 +1,6 @@
+#version 450
+void main() {
+    // One triangle over the whole screen: (-1, -1), (3, -1), (-1, 3)
+    vec2 position = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);
+    gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+}
\ No newline at end of file
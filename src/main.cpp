@@ -1,12 +1,125 @@
 #include "vsdl_init.h"
+#include "vsdl_mesh.h"
+#include "vsdl_instancing.h"
+#include "vsdl_particles.h"
+#include "vsdl_parallel.h"
 #include "vsdl_pipeline.h"
 #include "vsdl_renderer.h"
 #include "vsdl_cleanup.h"
+#include "vsdl_pipeline_cache.h"
+#include "vsdl_headless.h"
+#include "vsdl_threaded.h"
+#include "vsdl_graph.h"
+#include "vsdl_shader_reload.h"
+#include "vsdl_archive.h"
+#include "vsdl_texture_stream.h"
 #include <SDL3/SDL_log.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
 
 int main(int argc, char* argv[]) {
     VSDL_Context ctx = {};
 
+    // Command line options
+    uint32_t benchmarkFrames = 0;
+    bool benchmarkPipelineCache = false;
+    uint32_t instanceCount = 0;
+    uint32_t benchmarkInstanceFrames = 0;
+    uint32_t particleCount = 0;
+    uint32_t benchmarkParticleFrames = 0;
+    bool sameQueueParticles = false;
+    uint32_t drawCount = 0;
+    uint32_t workerCount = 0;
+    uint32_t benchmarkWorkerFrames = 0;
+    bool threaded = false;
+    float tickHz = 120.0f;
+    bool dumpGraph = false;
+    bool hotReload = false;
+    const char* textureDir = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames-in-flight") == 0 && i + 1 < argc) {
+            ctx.framesInFlight = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--device") == 0 && i + 1 < argc) {
+            ctx.deviceOverride = argv[++i];
+        } else if (strcmp(argv[i], "--present-mode") == 0 && i + 1 < argc) {
+            const char* mode = argv[++i];
+            if (strcmp(mode, "mailbox") == 0) ctx.requestedPresentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+            else if (strcmp(mode, "immediate") == 0) ctx.requestedPresentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+            else if (strcmp(mode, "fifo_relaxed") == 0) ctx.requestedPresentMode = VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+            else ctx.requestedPresentMode = VK_PRESENT_MODE_FIFO_KHR;
+        } else if (strcmp(argv[i], "--pipeline-cache") == 0 && i + 1 < argc) {
+            ctx.pipelineCachePath = argv[++i];
+        } else if (strcmp(argv[i], "--bench-pipeline-cache") == 0) {
+            benchmarkPipelineCache = true;
+        } else if (strcmp(argv[i], "--headless") == 0) {
+            ctx.headless = true;
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            ctx.headlessConfig.frameCount = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            unsigned width = 0, height = 0;
+            if (sscanf(argv[++i], "%ux%u", &width, &height) == 2 && width > 0 && height > 0) {
+                ctx.headlessConfig.width = width;
+                ctx.headlessConfig.height = height;
+            }
+        } else if (strcmp(argv[i], "--dump-dir") == 0 && i + 1 < argc) {
+            ctx.headlessConfig.outputDir = argv[++i];
+        } else if (strcmp(argv[i], "--target-fps") == 0 && i + 1 < argc) {
+            ctx.headlessConfig.targetFps = strtof(argv[++i], nullptr);
+        } else if (strcmp(argv[i], "--bench-frames") == 0) {
+            benchmarkFrames = 500;
+            if (i + 1 < argc && argv[i + 1][0] != '-') benchmarkFrames = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--instances") == 0 && i + 1 < argc) {
+            instanceCount = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--bench-instances") == 0) {
+            benchmarkInstanceFrames = 300;
+            if (i + 1 < argc && argv[i + 1][0] != '-') benchmarkInstanceFrames = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--particles") == 0) {
+            particleCount = 1000000;
+            if (i + 1 < argc && argv[i + 1][0] != '-') particleCount = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--bench-particles") == 0) {
+            benchmarkParticleFrames = 300;
+            if (i + 1 < argc && argv[i + 1][0] != '-') benchmarkParticleFrames = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--same-queue") == 0) {
+            sameQueueParticles = true;
+        } else if (strcmp(argv[i], "--draws") == 0 && i + 1 < argc) {
+            drawCount = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            workerCount = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--bench-workers") == 0) {
+            benchmarkWorkerFrames = 300;
+            if (i + 1 < argc && argv[i + 1][0] != '-') benchmarkWorkerFrames = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--threaded") == 0) {
+            threaded = true;
+        } else if (strcmp(argv[i], "--tick-rate") == 0 && i + 1 < argc) {
+            tickHz = strtof(argv[++i], nullptr);
+        } else if (strcmp(argv[i], "--fence-sync") == 0) {
+            ctx.requestTimeline = false;
+        } else if (strcmp(argv[i], "--depth-prepass") == 0) {
+            ctx.depthPrepass = true;
+        } else if (strcmp(argv[i], "--dynamic-rendering") == 0) {
+            ctx.requestDynamicRendering = true;
+        } else if (strcmp(argv[i], "--archive") == 0 && i + 1 < argc) {
+            ctx.archivePath = argv[++i];
+        } else if (strcmp(argv[i], "--hot-reload") == 0) {
+            hotReload = true;
+        } else if (strcmp(argv[i], "--stream-textures") == 0 && i + 1 < argc) {
+            textureDir = argv[++i];
+        } else if (strcmp(argv[i], "--dump-graph") == 0) {
+            dumpGraph = true;
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            ctx.profiler.tracePath = argv[++i];
+        } else if (strcmp(argv[i], "--ui-mode") == 0 && i + 1 < argc) {
+            const char* mode = argv[++i];
+            if (strcmp(mode, "direct") == 0) ctx.uiSettings.uiMode = VSDL_UiMode::Direct;
+            else if (strcmp(mode, "layer") == 0) ctx.uiSettings.uiMode = VSDL_UiMode::Layer;
+            else ctx.uiSettings.uiMode = VSDL_UiMode::Cached;
+        } else {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Unknown option: %s", argv[i]);
+        }
+    }
+
     // Initialize Vulkan and SDL
     if (!vsdl_init(ctx)) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Initialization failed");
@@ -14,18 +127,62 @@ int main(int argc, char* argv[]) {
         return -1;
     }
 
-    // Create pipeline and ImGui setup
+    // Create pipeline, ImGui setup and the scene geometry
     try {
+        vsdl_open_archive(ctx.archive, ctx.archivePath); // Optional, loaders fall back to loose files
+        if (hotReload) vsdl_create_shader_reloader(ctx, VSDL_SHADER_SOURCE_DIR, VSDL_GLSLC_PATH);
         vsdl_create_pipeline(ctx);
+        vsdl_create_triangle(ctx);
+        if (instanceCount > 0 || benchmarkInstanceFrames > 0) {
+            vsdl_create_instancing(ctx);
+            vsdl_set_instance_count(ctx, instanceCount);
+        }
+        if (benchmarkParticleFrames > 0 && particleCount == 0) particleCount = 1000000;
+        if (particleCount > 0) {
+            vsdl_create_particles(ctx, particleCount);
+            if (sameQueueParticles) vsdl_set_particles_async(ctx, false);
+        }
+        if (benchmarkWorkerFrames > 0 && drawCount == 0) drawCount = 20000;
+        if (drawCount > 0) {
+            vsdl_create_parallel(ctx);
+            vsdl_set_direct_draw_count(ctx, drawCount);
+            vsdl_set_worker_count(ctx, workerCount);
+        }
+        if (textureDir) {
+            // Queued all at once; they decode in the background and land over the next frames
+            std::error_code error;
+            for (const auto& entry : std::filesystem::directory_iterator(textureDir, error)) {
+                std::string extension = entry.path().extension().string();
+                if (extension == ".ppm" || extension == ".tga") vsdl_stream_texture(ctx, entry.path().string());
+            }
+        }
     } catch (const std::exception& e) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Pipeline creation failed: %s", e.what());
         vsdl_cleanup(ctx);
         return -1;
     }
 
-    // Run the render loop
+    // Run the frame-time benchmark or the render loop
     try {
-        vsdl_render_loop(ctx);
+        if (dumpGraph) {
+            printf("%s", vsdl_graph_dump_demo(ctx).c_str());
+        } else if (ctx.headless) {
+            vsdl_headless_loop(ctx);
+        } else if (benchmarkPipelineCache) {
+            vsdl_benchmark_pipeline_cache(ctx);
+        } else if (benchmarkInstanceFrames > 0) {
+            vsdl_benchmark_instances(ctx, benchmarkInstanceFrames);
+        } else if (benchmarkParticleFrames > 0) {
+            vsdl_benchmark_particles(ctx, benchmarkParticleFrames);
+        } else if (benchmarkWorkerFrames > 0) {
+            vsdl_benchmark_workers(ctx, benchmarkWorkerFrames);
+        } else if (benchmarkFrames > 0) {
+            vsdl_benchmark_frames(ctx, benchmarkFrames);
+        } else if (threaded) {
+            vsdl_threaded_loop(ctx, tickHz);
+        } else {
+            vsdl_render_loop(ctx);
+        }
     } catch (const std::exception& e) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Render loop failed: %s", e.what());
         vsdl_cleanup(ctx);
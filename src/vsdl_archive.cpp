@@ -0,0 +1,129 @@
+#include "vsdl_archive.h"
+#include <SDL3/SDL_log.h>
+#include <cstring>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static bool map_file(VSDL_Archive& archive, const std::string& path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER fileSize = {};
+    HANDLE mapping = nullptr;
+    const void* view = nullptr;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping) view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    }
+    if (!view) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    archive.fileHandle = file;
+    archive.mappingHandle = mapping;
+    archive.data = (const uint8_t*)view;
+    archive.size = (size_t)fileSize.QuadPart;
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info = {};
+    void* view = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        view = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd); // The mapping keeps the file referenced
+    if (view == MAP_FAILED) return false;
+    archive.data = (const uint8_t*)view;
+    archive.size = (size_t)info.st_size;
+#endif
+    return true;
+}
+
+// Check everything the lookups rely on so a truncated or stale archive can't send a loader out of bounds
+static bool validate(const VSDL_Archive& archive, const std::string& path) {
+    if (archive.size < sizeof(VSDL_ArchiveHeader)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Archive %s is truncated", path.c_str());
+        return false;
+    }
+    const VSDL_ArchiveHeader* header = (const VSDL_ArchiveHeader*)archive.data;
+    if (header->magic != VSDL_ARCHIVE_MAGIC || header->version != VSDL_ARCHIVE_VERSION) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Archive %s has an unknown format (version %u)", path.c_str(), header->version);
+        return false;
+    }
+    if ((uint64_t)header->entryCount * sizeof(VSDL_ArchiveEntry) > archive.size - sizeof(VSDL_ArchiveHeader)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Archive %s index is truncated", path.c_str());
+        return false;
+    }
+    const VSDL_ArchiveEntry* entries = (const VSDL_ArchiveEntry*)(archive.data + sizeof(VSDL_ArchiveHeader));
+    for (uint32_t i = 0; i < header->entryCount; i++) {
+        const VSDL_ArchiveEntry& entry = entries[i];
+        bool terminated = memchr(entry.name, '\0', sizeof(entry.name)) != nullptr;
+        bool inBounds = entry.offset <= archive.size && entry.size <= archive.size - entry.offset;
+        bool sorted = i == 0 || strcmp(entries[i - 1].name, entry.name) < 0;
+        if (!terminated || !inBounds || !sorted) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Archive %s has a corrupt index entry %u", path.c_str(), i);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool vsdl_open_archive(VSDL_Archive& archive, const std::string& path) {
+    vsdl_close_archive(archive);
+    if (!map_file(archive, path)) {
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "No asset archive at %s, loading loose files", path.c_str());
+        return false;
+    }
+    if (!validate(archive, path)) {
+        vsdl_close_archive(archive);
+        return false;
+    }
+
+    const VSDL_ArchiveHeader* header = (const VSDL_ArchiveHeader*)archive.data;
+    archive.entries = (const VSDL_ArchiveEntry*)(archive.data + sizeof(VSDL_ArchiveHeader));
+    archive.entryCount = header->entryCount;
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Mapped asset archive %s: %u entries, %.1f KB",
+                path.c_str(), archive.entryCount, archive.size / 1024.0);
+    return true;
+}
+
+void vsdl_close_archive(VSDL_Archive& archive) {
+    if (!archive.data) return;
+#ifdef _WIN32
+    UnmapViewOfFile(archive.data);
+    CloseHandle((HANDLE)archive.mappingHandle);
+    CloseHandle((HANDLE)archive.fileHandle);
+#else
+    munmap((void*)archive.data, archive.size);
+#endif
+    archive = VSDL_Archive{};
+}
+
+const uint8_t* vsdl_archive_find(const VSDL_Archive& archive, const std::string& name, size_t* size) {
+    // Binary search, the packer writes the index sorted by name
+    uint32_t low = 0, high = archive.entryCount;
+    while (low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        int order = strcmp(archive.entries[mid].name, name.c_str());
+        if (order == 0) {
+            if (size) *size = (size_t)archive.entries[mid].size;
+            return archive.data + archive.entries[mid].offset;
+        }
+        if (order < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return nullptr;
+}
\ No newline at end of file
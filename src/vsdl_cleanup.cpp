@@ -1,31 +1,63 @@
 #include "vsdl_cleanup.h"
 #include "vsdl_imgui.h"
+#include "vsdl_renderer.h"
+#include "vsdl_swapchain.h"
+#include "vsdl_pipeline.h"
+#include "vsdl_pipeline_cache.h"
+#include "vsdl_headless.h"
+#include "vsdl_memory.h"
+#include "vsdl_mesh.h"
+#include "vsdl_upload.h"
+#include "vsdl_frame_arena.h"
+#include "vsdl_instancing.h"
+#include "vsdl_particles.h"
+#include "vsdl_parallel.h"
+#include "vsdl_graph.h"
+#include "vsdl_shader_reload.h"
+#include "vsdl_archive.h"
+#include "vsdl_descriptors.h"
+#include "vsdl_texture_stream.h"
+#include "vsdl_sync.h"
+#include "vsdl_profiler.h"
+#include "vsdl_ui_cache.h"
 #include <SDL3/SDL_log.h>
 
 void vsdl_cleanup(VSDL_Context& ctx) {
     if (ctx.device) {
         vkDeviceWaitIdle(ctx.device);
+        vsdl_destroy_shader_reloader(ctx); // Before the pipelines it may still be rebuilding
 
+        vsdl_destroy_ui_cache(ctx); // Before the backend that owns the layer's descriptor set
         vsdl::shutdown_imgui(ctx);
+        vsdl_destroy_texture_streamer(ctx);
 
-        if (ctx.inFlightFence) vkDestroyFence(ctx.device, ctx.inFlightFence, nullptr);
-        if (ctx.renderFinishedSemaphore) vkDestroySemaphore(ctx.device, ctx.renderFinishedSemaphore, nullptr);
-        if (ctx.imageAvailableSemaphore) vkDestroySemaphore(ctx.device, ctx.imageAvailableSemaphore, nullptr);
-        if (ctx.commandPool) {
-            vkFreeCommandBuffers(ctx.device, ctx.commandPool, 1, &ctx.commandBuffer);
-            vkDestroyCommandPool(ctx.device, ctx.commandPool, nullptr);
-        }
-        for (auto framebuffer : ctx.framebuffers) {
-            vkDestroyFramebuffer(ctx.device, framebuffer, nullptr);
-        }
-        if (ctx.graphicsPipeline) vkDestroyPipeline(ctx.device, ctx.graphicsPipeline, nullptr);
+        vsdl_destroy_frames(ctx);
+        if (ctx.commandPool) vkDestroyCommandPool(ctx.device, ctx.commandPool, nullptr);
+        vsdl_destroy_pipeline_library(ctx);
         if (ctx.pipelineLayout) vkDestroyPipelineLayout(ctx.device, ctx.pipelineLayout, nullptr);
         if (ctx.renderPass) vkDestroyRenderPass(ctx.device, ctx.renderPass, nullptr);
-        for (auto imageView : ctx.swapchainImageViews) {
-            vkDestroyImageView(ctx.device, imageView, nullptr);
+        vsdl_destroy_swapchain(ctx);
+        vsdl_destroy_offscreen_targets(ctx);
+        vsdl_destroy_instancing(ctx);
+        vsdl_destroy_particles(ctx);
+        vsdl_destroy_parallel(ctx);
+        vsdl_graph_destroy(ctx, ctx.frameGraph);
+        for (auto& mesh : ctx.meshes) {
+            vsdl_destroy_mesh(ctx, mesh);
         }
-        if (ctx.swapchain) vkDestroySwapchainKHR(ctx.device, ctx.swapchain, nullptr);
+        ctx.meshes.clear();
+        vsdl_destroy_upload_queue(ctx);
+        vsdl_destroy_frame_arena(ctx);
+        vsdl_destroy_descriptors(ctx);
+        vsdl_destroy_sync(ctx);
+
+        if (!ctx.profiler.tracePath.empty()) vsdl_profiler_write_trace(ctx, ctx.profiler.tracePath);
+        vsdl_destroy_profiler(ctx);
+
+        vsdl_save_pipeline_cache(ctx);
+        vsdl_destroy_pipeline_cache(ctx);
 
+        vsdl_destroy_allocator(ctx);
         vkDestroyDevice(ctx.device, nullptr);
         SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Vulkan device destroyed");
     }
@@ -51,6 +83,7 @@ void vsdl_cleanup(VSDL_Context& ctx) {
         SDL_DestroyWindow(ctx.window);
         SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "SDL window destroyed");
     }
+    vsdl_close_archive(ctx.archive);
     SDL_Quit();
     SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "SDL quit");
 }
\ No newline at end of file
@@ -0,0 +1,295 @@
+#include "vsdl_depth_pyramid.h"
+#include "vsdl_memory.h"
+#include "vsdl_pipeline.h"
+#include "vsdl_shader_reload.h"
+#include <SDL3/SDL_log.h>
+#include <algorithm>
+#include <stdexcept>
+
+#define VSDL_DEPTH_PYRAMID_GROUP_SIZE 8
+
+static VkExtent2D level_extent(const VSDL_DepthPyramid& pyramid, uint32_t level) {
+    // Rounding up keeps every texel of the level below covered, odd edges included
+    VkExtent2D extent = pyramid.depthExtent;
+    for (uint32_t i = 0; i <= level; i++) {
+        extent.width = std::max((extent.width + 1) / 2, 1u);
+        extent.height = std::max((extent.height + 1) / 2, 1u);
+    }
+    return extent;
+}
+
+static void write_level_set(VSDL_Context& ctx, VkDescriptorSet set, VkImageView source, VkImageLayout sourceLayout,
+                            VkImageView destination) {
+    VSDL_DepthPyramid& pyramid = ctx.depthPyramid;
+    VkDescriptorImageInfo imageInfos[2] = {};
+    imageInfos[0].sampler = pyramid.sampler;
+    imageInfos[0].imageView = source;
+    imageInfos[0].imageLayout = sourceLayout;
+    imageInfos[1].imageView = destination;
+    imageInfos[1].imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+    VkWriteDescriptorSet writes[2] = {};
+    uint32_t writeCount = 0;
+    for (uint32_t b = 0; b < 2; b++) {
+        if (!imageInfos[b].imageView) continue;
+        VkWriteDescriptorSet& write = writes[writeCount++];
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = set;
+        write.dstBinding = b;
+        write.descriptorCount = 1;
+        write.descriptorType = b == 0 ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER : VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        write.pImageInfo = &imageInfos[b];
+    }
+    vkUpdateDescriptorSets(ctx.device, writeCount, writes, 0, nullptr);
+}
+
+static void destroy_pyramid_image(VSDL_Context& ctx) {
+    VSDL_DepthPyramid& pyramid = ctx.depthPyramid;
+    for (uint32_t i = 0; i < pyramid.levelCount; i++) {
+        if (pyramid.levelViews[i]) vkDestroyImageView(ctx.device, pyramid.levelViews[i], nullptr);
+        pyramid.levelViews[i] = VK_NULL_HANDLE;
+    }
+    if (pyramid.view) vkDestroyImageView(ctx.device, pyramid.view, nullptr);
+    pyramid.view = VK_NULL_HANDLE;
+    vsdl_destroy_image(ctx, pyramid.image);
+    pyramid.levelCount = 0;
+}
+
+static VkImageView create_view(VSDL_Context& ctx, uint32_t baseLevel, uint32_t levelCount) {
+    VkImageViewCreateInfo viewInfo = {};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = ctx.depthPyramid.image.image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = VK_FORMAT_R32_SFLOAT;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.baseMipLevel = baseLevel;
+    viewInfo.subresourceRange.levelCount = levelCount;
+    viewInfo.subresourceRange.layerCount = 1;
+    VkImageView view = VK_NULL_HANDLE;
+    if (vkCreateImageView(ctx.device, &viewInfo, nullptr, &view) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create depth pyramid view");
+        throw std::runtime_error("Image view creation failed");
+    }
+    return view;
+}
+
+static void create_pyramid_image(VSDL_Context& ctx) {
+    VSDL_DepthPyramid& pyramid = ctx.depthPyramid;
+    pyramid.depthExtent = ctx.swapchainExtent;
+    pyramid.valid = false;
+    pyramid.needsInit = true;
+
+    // Down to a single texel, so the cull pass always finds a level where a footprint spans two texels
+    VkExtent2D base = level_extent(pyramid, 0);
+    pyramid.levelCount = 1;
+    while (pyramid.levelCount < VSDL_DEPTH_PYRAMID_MAX_LEVELS && (std::max(base.width, base.height) >> pyramid.levelCount) > 0) {
+        pyramid.levelCount++;
+    }
+
+    VkImageCreateInfo imageInfo = {};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = VK_FORMAT_R32_SFLOAT;
+    imageInfo.extent = { base.width, base.height, 1 };
+    imageInfo.mipLevels = pyramid.levelCount;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    pyramid.image = vsdl_create_image(ctx, imageInfo, true); // Resized with the swapchain, like the depth buffer
+
+    pyramid.view = create_view(ctx, 0, pyramid.levelCount);
+    for (uint32_t i = 0; i < pyramid.levelCount; i++) pyramid.levelViews[i] = create_view(ctx, i, 1);
+
+    // Level 0's source is the depth buffer, bound per frame; every other level reads the one below
+    for (uint32_t slot = 0; slot < VSDL_MAX_FRAMES_IN_FLIGHT; slot++) {
+        write_level_set(ctx, pyramid.depthSets[slot], VK_NULL_HANDLE, VK_IMAGE_LAYOUT_UNDEFINED, pyramid.levelViews[0]);
+    }
+    for (uint32_t i = 1; i < pyramid.levelCount; i++) {
+        write_level_set(ctx, pyramid.levelSets[i], pyramid.levelViews[i - 1], VK_IMAGE_LAYOUT_GENERAL, pyramid.levelViews[i]);
+    }
+}
+
+void vsdl_create_depth_pyramid(VSDL_Context& ctx) {
+    VSDL_DepthPyramid& pyramid = ctx.depthPyramid;
+
+    VkSamplerCreateInfo samplerInfo = {};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_NEAREST;
+    samplerInfo.minFilter = VK_FILTER_NEAREST;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+    if (vkCreateSampler(ctx.device, &samplerInfo, nullptr, &pyramid.sampler) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create depth pyramid sampler");
+        throw std::runtime_error("Sampler creation failed");
+    }
+
+    // 0: source level (or the depth buffer), 1: destination level
+    VkDescriptorSetLayoutBinding bindings[2] = {};
+    for (uint32_t i = 0; i < 2; i++) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = i == 0 ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER : VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+    VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = 2;
+    layoutInfo.pBindings = bindings;
+    if (vkCreateDescriptorSetLayout(ctx.device, &layoutInfo, nullptr, &pyramid.setLayout) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create depth pyramid descriptor set layout");
+        throw std::runtime_error("Descriptor set layout creation failed");
+    }
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &pyramid.setLayout;
+    if (vkCreatePipelineLayout(ctx.device, &pipelineLayoutInfo, nullptr, &pyramid.pipelineLayout) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create depth pyramid pipeline layout");
+        throw std::runtime_error("Pipeline layout creation failed");
+    }
+
+    // Every set is allocated up front and only rewritten on resize
+    const uint32_t setCount = VSDL_DEPTH_PYRAMID_MAX_LEVELS + VSDL_MAX_FRAMES_IN_FLIGHT;
+    VkDescriptorPoolSize poolSizes[2] = {};
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSizes[0].descriptorCount = setCount;
+    poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    poolSizes[1].descriptorCount = setCount;
+    VkDescriptorPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = setCount;
+    poolInfo.poolSizeCount = 2;
+    poolInfo.pPoolSizes = poolSizes;
+    if (vkCreateDescriptorPool(ctx.device, &poolInfo, nullptr, &pyramid.descriptorPool) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create depth pyramid descriptor pool");
+        throw std::runtime_error("Descriptor pool creation failed");
+    }
+
+    VkDescriptorSetLayout setLayouts[setCount];
+    std::fill(setLayouts, setLayouts + setCount, pyramid.setLayout);
+    VkDescriptorSet sets[setCount];
+    VkDescriptorSetAllocateInfo allocInfo = {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = pyramid.descriptorPool;
+    allocInfo.descriptorSetCount = setCount;
+    allocInfo.pSetLayouts = setLayouts;
+    if (vkAllocateDescriptorSets(ctx.device, &allocInfo, sets) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate depth pyramid descriptor sets");
+        throw std::runtime_error("Descriptor set allocation failed");
+    }
+    std::copy(sets, sets + VSDL_DEPTH_PYRAMID_MAX_LEVELS, pyramid.levelSets);
+    std::copy(sets + VSDL_DEPTH_PYRAMID_MAX_LEVELS, sets + setCount, pyramid.depthSets);
+
+    pyramid.pipeline = vsdl_build_compute_pipeline(ctx, "shaders/depth_pyramid.comp.spv", pyramid.pipelineLayout, ctx.pipelineCache);
+    vsdl_shader_reload_register(ctx, { "depth_pyramid.comp" }, &pyramid.pipeline, [](VSDL_Context& ctx) {
+        return vsdl_build_compute_pipeline(ctx, "shaders/depth_pyramid.comp.spv", ctx.depthPyramid.pipelineLayout, ctx.pipelineCache);
+    });
+
+    create_pyramid_image(ctx);
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Depth pyramid: %u levels for %ux%u depth", pyramid.levelCount,
+                pyramid.depthExtent.width, pyramid.depthExtent.height);
+}
+
+void vsdl_destroy_depth_pyramid(VSDL_Context& ctx) {
+    VSDL_DepthPyramid& pyramid = ctx.depthPyramid;
+    destroy_pyramid_image(ctx);
+    if (pyramid.pipeline) vkDestroyPipeline(ctx.device, pyramid.pipeline, nullptr);
+    if (pyramid.pipelineLayout) vkDestroyPipelineLayout(ctx.device, pyramid.pipelineLayout, nullptr);
+    if (pyramid.descriptorPool) vkDestroyDescriptorPool(ctx.device, pyramid.descriptorPool, nullptr);
+    if (pyramid.setLayout) vkDestroyDescriptorSetLayout(ctx.device, pyramid.setLayout, nullptr);
+    if (pyramid.sampler) vkDestroySampler(ctx.device, pyramid.sampler, nullptr);
+    pyramid = VSDL_DepthPyramid{};
+}
+
+void vsdl_resize_depth_pyramid(VSDL_Context& ctx) {
+    VSDL_DepthPyramid& pyramid = ctx.depthPyramid;
+    if (!pyramid.pipelineLayout) return;
+    if (pyramid.depthExtent.width == ctx.swapchainExtent.width && pyramid.depthExtent.height == ctx.swapchainExtent.height) return;
+
+    destroy_pyramid_image(ctx);
+    create_pyramid_image(ctx);
+    for (VkDescriptorSet set : ctx.instancing.descriptorSets) {
+        if (set) vsdl_write_depth_pyramid_binding(ctx, set, 3);
+    }
+}
+
+void vsdl_write_depth_pyramid_binding(VSDL_Context& ctx, VkDescriptorSet set, uint32_t binding) {
+    VkDescriptorImageInfo imageInfo = {};
+    imageInfo.sampler = ctx.depthPyramid.sampler;
+    imageInfo.imageView = ctx.depthPyramid.view;
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+    VkWriteDescriptorSet write = {};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = set;
+    write.dstBinding = binding;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    write.pImageInfo = &imageInfo;
+    vkUpdateDescriptorSets(ctx.device, 1, &write, 0, nullptr);
+}
+
+void vsdl_depth_pyramid_prepare(VSDL_Context& ctx, VkCommandBuffer commandBuffer) {
+    VSDL_DepthPyramid& pyramid = ctx.depthPyramid;
+    if (!pyramid.needsInit) return;
+    VkImageMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = pyramid.image.image;
+    barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, pyramid.levelCount, 0, 1 };
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                         0, nullptr, 0, nullptr, 1, &barrier);
+    pyramid.needsInit = false;
+}
+
+void vsdl_record_depth_pyramid(VSDL_Context& ctx, VkCommandBuffer commandBuffer, VkImageView depthView) {
+    VSDL_DepthPyramid& pyramid = ctx.depthPyramid;
+
+    // The slot's previous use of its level 0 set has completed; the depth view may change with every resize
+    VkDescriptorSet depthSet = pyramid.depthSets[ctx.currentFrame];
+    write_level_set(ctx, depthSet, depthView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_NULL_HANDLE);
+
+    // This frame's cull pass is done reading the previous contents
+    VkImageMemoryBarrier initBarrier = {};
+    initBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    initBarrier.srcAccessMask = pyramid.needsInit ? 0 : VK_ACCESS_SHADER_READ_BIT;
+    initBarrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    initBarrier.oldLayout = pyramid.needsInit ? VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_GENERAL;
+    initBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    initBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    initBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    initBarrier.image = pyramid.image.image;
+    initBarrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, pyramid.levelCount, 0, 1 };
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                         0, nullptr, 0, nullptr, 1, &initBarrier);
+    pyramid.needsInit = false;
+
+    // One dispatch per level; each reads the level written by the previous one
+    VkMemoryBarrier levelBarrier = {};
+    levelBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    levelBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    levelBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pyramid.pipeline);
+    for (uint32_t level = 0; level < pyramid.levelCount; level++) {
+        VkDescriptorSet set = level == 0 ? depthSet : pyramid.levelSets[level];
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pyramid.pipelineLayout, 0, 1, &set, 0, nullptr);
+        VkExtent2D extent = level_extent(pyramid, level);
+        vkCmdDispatch(commandBuffer, (extent.width + VSDL_DEPTH_PYRAMID_GROUP_SIZE - 1) / VSDL_DEPTH_PYRAMID_GROUP_SIZE,
+                      (extent.height + VSDL_DEPTH_PYRAMID_GROUP_SIZE - 1) / VSDL_DEPTH_PYRAMID_GROUP_SIZE, 1);
+        // The last barrier publishes the pyramid to the next frame's cull dispatch
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                             1, &levelBarrier, 0, nullptr, 0, nullptr);
+    }
+
+    pyramid.viewProjection = ctx.camera.viewProjection;
+    pyramid.valid = true;
+}
\ No newline at end of file
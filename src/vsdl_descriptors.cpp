@@ -0,0 +1,257 @@
+#include "vsdl_descriptors.h"
+#include "vsdl_sync.h"
+#include <SDL3/SDL_log.h>
+#include <algorithm>
+#include <stdexcept>
+
+// Per-pool budget of the transient allocators; a frame that needs more chains another pool
+#define VSDL_FRAME_DESCRIPTOR_SETS 64
+
+static const VkDescriptorPoolSize frame_pool_sizes[] = {
+    { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 64 },
+    { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 16 },
+    { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 64 },
+    { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 64 },
+};
+
+// Fit the table into the device's update-after-bind limits
+static void clamp_capacity(VSDL_Context& ctx, VSDL_Descriptors& desc) {
+    VkPhysicalDeviceDescriptorIndexingProperties indexing = {};
+    indexing.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES;
+    VkPhysicalDeviceProperties2 properties2 = {};
+    properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties2.pNext = &indexing;
+    auto getProperties2 = (PFN_vkGetPhysicalDeviceProperties2)vkGetInstanceProcAddr(ctx.instance,
+        ctx.apiVersion >= VK_API_VERSION_1_1 ? "vkGetPhysicalDeviceProperties2" : "vkGetPhysicalDeviceProperties2KHR");
+    if (getProperties2) getProperties2(ctx.physicalDevice, &properties2);
+
+    uint32_t textures = std::min({ (uint32_t)VSDL_BINDLESS_MAX_TEXTURES,
+                                   indexing.maxDescriptorSetUpdateAfterBindSampledImages,
+                                   indexing.maxPerStageDescriptorUpdateAfterBindSampledImages,
+                                   indexing.maxDescriptorSetUpdateAfterBindSamplers,
+                                   indexing.maxPerStageDescriptorUpdateAfterBindSamplers });
+    uint32_t buffers = std::min({ (uint32_t)VSDL_BINDLESS_MAX_BUFFERS,
+                                  indexing.maxDescriptorSetUpdateAfterBindStorageBuffers,
+                                  indexing.maxPerStageDescriptorUpdateAfterBindStorageBuffers });
+    // Both arrays count against the per-stage resource limit
+    uint32_t resources = indexing.maxPerStageUpdateAfterBindResources;
+    if ((uint64_t)textures + buffers > resources) {
+        buffers = std::min(buffers, resources / 2);
+        textures = std::min(textures, resources - buffers);
+    }
+    desc.capacity[(uint32_t)VSDL_BindlessKind::Texture] = textures;
+    desc.capacity[(uint32_t)VSDL_BindlessKind::Buffer] = buffers;
+}
+
+bool vsdl_create_descriptors(VSDL_Context& ctx) {
+    VSDL_Descriptors& desc = ctx.descriptors;
+    if (!desc.bindless) {
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Descriptor indexing unavailable, no bindless table");
+        return true;
+    }
+    clamp_capacity(ctx, desc);
+    if (!desc.capacity[0] || !desc.capacity[1]) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Update-after-bind limits too small, no bindless table");
+        desc.bindless = false;
+        return true;
+    }
+
+    VkDescriptorSetLayoutBinding bindings[2] = {};
+    bindings[0].binding = 0;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindings[0].descriptorCount = desc.capacity[(uint32_t)VSDL_BindlessKind::Texture];
+    bindings[0].stageFlags = VK_SHADER_STAGE_ALL;
+    bindings[1].binding = 1;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[1].descriptorCount = desc.capacity[(uint32_t)VSDL_BindlessKind::Buffer];
+    bindings[1].stageFlags = VK_SHADER_STAGE_ALL;
+
+    // Slots are written while the set is bound in frames still in flight, and most stay empty
+    VkDescriptorBindingFlags bindingFlags[2] = {};
+    for (auto& flags : bindingFlags) {
+        flags = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+                VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+    }
+    VkDescriptorSetLayoutBindingFlagsCreateInfo flagsInfo = {};
+    flagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    flagsInfo.bindingCount = 2;
+    flagsInfo.pBindingFlags = bindingFlags;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.pNext = &flagsInfo;
+    layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    layoutInfo.bindingCount = 2;
+    layoutInfo.pBindings = bindings;
+    if (vkCreateDescriptorSetLayout(ctx.device, &layoutInfo, nullptr, &desc.bindlessLayout) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create bindless descriptor set layout");
+        return false;
+    }
+
+    VkDescriptorPoolSize poolSizes[2] = {
+        { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, bindings[0].descriptorCount },
+        { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, bindings[1].descriptorCount },
+    };
+    VkDescriptorPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    poolInfo.maxSets = 1;
+    poolInfo.poolSizeCount = 2;
+    poolInfo.pPoolSizes = poolSizes;
+    if (vkCreateDescriptorPool(ctx.device, &poolInfo, nullptr, &desc.bindlessPool) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create bindless descriptor pool");
+        return false;
+    }
+
+    VkDescriptorSetAllocateInfo allocInfo = {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = desc.bindlessPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &desc.bindlessLayout;
+    if (vkAllocateDescriptorSets(ctx.device, &allocInfo, &desc.bindlessSet) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate bindless descriptor set");
+        return false;
+    }
+
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Bindless table: %u textures, %u storage buffers",
+                bindings[0].descriptorCount, bindings[1].descriptorCount);
+    return true;
+}
+
+void vsdl_destroy_descriptors(VSDL_Context& ctx) {
+    VSDL_Descriptors& desc = ctx.descriptors;
+    for (auto& frame : desc.frames) {
+        for (VkDescriptorPool pool : frame.pools) vkDestroyDescriptorPool(ctx.device, pool, nullptr);
+    }
+    if (desc.bindlessPool) vkDestroyDescriptorPool(ctx.device, desc.bindlessPool, nullptr);
+    if (desc.bindlessLayout) vkDestroyDescriptorSetLayout(ctx.device, desc.bindlessLayout, nullptr);
+    desc = VSDL_Descriptors{};
+}
+
+static VSDL_BindlessHandle allocate_slot(VSDL_Descriptors& desc, VSDL_BindlessKind kind) {
+    const uint32_t k = (uint32_t)kind;
+    VSDL_BindlessHandle handle;
+    handle.kind = kind;
+    if (!desc.bindless) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Bindless descriptors are not available on this device");
+        throw std::runtime_error("Bindless descriptors unavailable");
+    }
+    if (!desc.freeSlots[k].empty()) {
+        handle.index = desc.freeSlots[k].back();
+        desc.freeSlots[k].pop_back();
+    } else if (desc.used[k] < desc.capacity[k]) {
+        handle.index = desc.used[k]++;
+    } else {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Bindless %s table full (%u)",
+                     kind == VSDL_BindlessKind::Texture ? "texture" : "buffer", desc.capacity[k]);
+        throw std::runtime_error("Bindless table full");
+    }
+    return handle;
+}
+
+VSDL_BindlessHandle vsdl_bindless_add_texture(VSDL_Context& ctx, VkImageView view, VkSampler sampler) {
+    VSDL_BindlessHandle handle = allocate_slot(ctx.descriptors, VSDL_BindlessKind::Texture);
+
+    VkDescriptorImageInfo imageInfo = {};
+    imageInfo.sampler = sampler;
+    imageInfo.imageView = view;
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    VkWriteDescriptorSet write = {};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = ctx.descriptors.bindlessSet;
+    write.dstBinding = 0;
+    write.dstArrayElement = handle.index;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    write.pImageInfo = &imageInfo;
+    vkUpdateDescriptorSets(ctx.device, 1, &write, 0, nullptr);
+    return handle;
+}
+
+VSDL_BindlessHandle vsdl_bindless_add_buffer(VSDL_Context& ctx, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range) {
+    VSDL_BindlessHandle handle = allocate_slot(ctx.descriptors, VSDL_BindlessKind::Buffer);
+
+    VkDescriptorBufferInfo bufferInfo = {};
+    bufferInfo.buffer = buffer;
+    bufferInfo.offset = offset;
+    bufferInfo.range = range;
+    VkWriteDescriptorSet write = {};
+    write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write.dstSet = ctx.descriptors.bindlessSet;
+    write.dstBinding = 1;
+    write.dstArrayElement = handle.index;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    write.pBufferInfo = &bufferInfo;
+    vkUpdateDescriptorSets(ctx.device, 1, &write, 0, nullptr);
+    return handle;
+}
+
+void vsdl_bindless_free(VSDL_Context& ctx, VSDL_BindlessHandle& handle) {
+    if (handle.index == VSDL_BINDLESS_INVALID) return;
+    // Frames up to the one being recorded may still index the slot; the descriptor itself stays valid until rewritten
+    ctx.descriptors.pendingFrees.push_back({ handle, vsdl_timeline_pending(ctx, VSDL_QueueKind::Graphics) });
+    handle.index = VSDL_BINDLESS_INVALID;
+}
+
+void vsdl_descriptors_begin_frame(VSDL_Context& ctx) {
+    VSDL_Descriptors& desc = ctx.descriptors;
+
+    uint64_t completed = vsdl_timeline_completed(ctx, VSDL_QueueKind::Graphics);
+    auto released = [&](const std::pair<VSDL_BindlessHandle, uint64_t>& entry) {
+        if (entry.second > completed) return false;
+        desc.freeSlots[(uint32_t)entry.first.kind].push_back(entry.first.index);
+        return true;
+    };
+    desc.pendingFrees.erase(std::remove_if(desc.pendingFrees.begin(), desc.pendingFrees.end(), released), desc.pendingFrees.end());
+
+    VSDL_FrameDescriptors& frame = desc.frames[ctx.currentFrame];
+    for (uint32_t i = 0; i <= frame.activePool && i < frame.pools.size(); i++) {
+        vkResetDescriptorPool(ctx.device, frame.pools[i], 0);
+    }
+    frame.activePool = 0;
+}
+
+static VkDescriptorPool create_frame_pool(VSDL_Context& ctx) {
+    VkDescriptorPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = VSDL_FRAME_DESCRIPTOR_SETS;
+    poolInfo.poolSizeCount = (uint32_t)(sizeof(frame_pool_sizes) / sizeof(frame_pool_sizes[0]));
+    poolInfo.pPoolSizes = frame_pool_sizes;
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+    if (vkCreateDescriptorPool(ctx.device, &poolInfo, nullptr, &pool) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create frame descriptor pool");
+        throw std::runtime_error("Descriptor pool creation failed");
+    }
+    return pool;
+}
+
+VkDescriptorSet vsdl_allocate_frame_set(VSDL_Context& ctx, VkDescriptorSetLayout layout) {
+    VSDL_FrameDescriptors& frame = ctx.descriptors.frames[ctx.currentFrame];
+    for (;;) {
+        // Pools are created on first use, so a frame that allocates nothing costs nothing
+        bool freshPool = frame.activePool == frame.pools.size();
+        if (freshPool) frame.pools.push_back(create_frame_pool(ctx));
+
+        VkDescriptorSetAllocateInfo allocInfo = {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = frame.pools[frame.activePool];
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &layout;
+        VkDescriptorSet set = VK_NULL_HANDLE;
+        VkResult result = vkAllocateDescriptorSets(ctx.device, &allocInfo, &set);
+        if (result == VK_SUCCESS) return set;
+
+        if ((result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL) || freshPool) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate frame descriptor set (%d)", (int)result);
+            throw std::runtime_error("Descriptor set allocation failed");
+        }
+        frame.activePool++;
+    }
+}
+
+void vsdl_bind_bindless(VSDL_Context& ctx, VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint,
+                        VkPipelineLayout layout, uint32_t setIndex) {
+    if (!ctx.descriptors.bindless) return;
+    vkCmdBindDescriptorSets(commandBuffer, bindPoint, layout, setIndex, 1, &ctx.descriptors.bindlessSet, 0, nullptr);
+}
\ No newline at end of file
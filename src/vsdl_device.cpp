@@ -0,0 +1,224 @@
+#include "vsdl_device.h"
+#include <SDL3/SDL_log.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static const char* device_type_name(VkPhysicalDeviceType type) {
+    switch (type) {
+    case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU: return "discrete";
+    case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU: return "integrated";
+    case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU: return "virtual";
+    case VK_PHYSICAL_DEVICE_TYPE_CPU: return "cpu";
+    default: return "other";
+    }
+}
+
+std::vector<VSDL_DeviceCandidate> vsdl_query_devices(VSDL_Context& ctx, std::vector<VkPhysicalDevice>& devices) {
+    uint32_t deviceCount = 0;
+    vkEnumeratePhysicalDevices(ctx.instance, &deviceCount, nullptr);
+    devices.resize(deviceCount);
+    vkEnumeratePhysicalDevices(ctx.instance, &deviceCount, devices.data());
+
+    // Core in 1.1, otherwise only there when the instance enabled VK_KHR_get_physical_device_properties2
+    auto getFeatures2 = (PFN_vkGetPhysicalDeviceFeatures2)vkGetInstanceProcAddr(ctx.instance,
+        ctx.apiVersion >= VK_API_VERSION_1_1 ? "vkGetPhysicalDeviceFeatures2" : "vkGetPhysicalDeviceFeatures2KHR");
+
+    std::vector<VSDL_DeviceCandidate> candidates(deviceCount);
+    for (uint32_t d = 0; d < deviceCount; d++) {
+        VkPhysicalDevice device = devices[d];
+        VSDL_DeviceCandidate& candidate = candidates[d];
+
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(device, &properties);
+        candidate.name = properties.deviceName;
+        candidate.vendorID = properties.vendorID;
+        candidate.deviceID = properties.deviceID;
+        candidate.type = properties.deviceType;
+        candidate.apiVersion = properties.apiVersion;
+
+        VkPhysicalDeviceMemoryProperties memory;
+        vkGetPhysicalDeviceMemoryProperties(device, &memory);
+        for (uint32_t i = 0; i < memory.memoryHeapCount; i++) {
+            if (memory.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) {
+                candidate.deviceLocalBytes = std::max(candidate.deviceLocalBytes, memory.memoryHeaps[i].size);
+            }
+        }
+
+        uint32_t familyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(device, &familyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> families(familyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(device, &familyCount, families.data());
+        for (uint32_t i = 0; i < familyCount; i++) {
+            VkQueueFlags flags = families[i].queueFlags;
+            if (flags & VK_QUEUE_GRAPHICS_BIT) candidate.graphicsQueue = true;
+            if ((flags & VK_QUEUE_COMPUTE_BIT) && !(flags & VK_QUEUE_GRAPHICS_BIT)) candidate.asyncCompute = true;
+            if ((flags & VK_QUEUE_TRANSFER_BIT) && !(flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT))) candidate.dedicatedTransfer = true;
+            VkBool32 presentSupport = false;
+            if (ctx.headless) {
+                presentSupport = (flags & VK_QUEUE_GRAPHICS_BIT) != 0; // Nothing is presented
+            } else {
+                vkGetPhysicalDeviceSurfaceSupportKHR(device, i, ctx.surface, &presentSupport);
+            }
+            if (presentSupport) candidate.presentQueue = true;
+        }
+
+        uint32_t extensionCount = 0;
+        vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+        std::vector<VkExtensionProperties> extensions(extensionCount);
+        vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, extensions.data());
+        bool hasDescriptorIndexing = false, hasMaintenance3 = false, hasTimeline = false;
+        for (const auto& extension : extensions) {
+            if (strcmp(extension.extensionName, VK_KHR_SWAPCHAIN_EXTENSION_NAME) == 0) candidate.swapchain = true;
+            if (strcmp(extension.extensionName, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) == 0) candidate.memoryBudget = true;
+            if (strcmp(extension.extensionName, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME) == 0) hasDescriptorIndexing = true;
+            if (strcmp(extension.extensionName, VK_KHR_MAINTENANCE_3_EXTENSION_NAME) == 0) hasMaintenance3 = true;
+            if (strcmp(extension.extensionName, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME) == 0) hasTimeline = true;
+        }
+        if (!getFeatures2) continue;
+
+        // Same feature sets vsdl_init enables
+        bool timelineCore = ctx.apiVersion >= VK_API_VERSION_1_2 && properties.apiVersion >= VK_API_VERSION_1_2;
+        if (timelineCore || hasTimeline) {
+            VkPhysicalDeviceTimelineSemaphoreFeatures timeline = {};
+            timeline.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+            VkPhysicalDeviceFeatures2 features2 = {};
+            features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            features2.pNext = &timeline;
+            getFeatures2(device, &features2);
+            candidate.timelineSemaphore = timeline.timelineSemaphore;
+        }
+        if (hasDescriptorIndexing && hasMaintenance3) {
+            VkPhysicalDeviceDescriptorIndexingFeatures indexing = {};
+            indexing.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+            VkPhysicalDeviceFeatures2 features2 = {};
+            features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            features2.pNext = &indexing;
+            getFeatures2(device, &features2);
+            candidate.descriptorIndexing = indexing.runtimeDescriptorArray && indexing.descriptorBindingPartiallyBound &&
+                indexing.descriptorBindingUpdateUnusedWhilePending && indexing.shaderSampledImageArrayNonUniformIndexing &&
+                indexing.descriptorBindingSampledImageUpdateAfterBind && indexing.descriptorBindingStorageBufferUpdateAfterBind;
+        }
+        if (ctx.apiVersion >= VK_API_VERSION_1_3 && properties.apiVersion >= VK_API_VERSION_1_3) {
+            VkPhysicalDeviceVulkan13Features features13 = {};
+            features13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+            VkPhysicalDeviceFeatures2 features2 = {};
+            features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            features2.pNext = &features13;
+            getFeatures2(device, &features2);
+            candidate.dynamicRendering = features13.dynamicRendering && features13.synchronization2;
+        }
+    }
+    return candidates;
+}
+
+int64_t vsdl_score_device(const VSDL_DeviceCandidate& candidate, bool headless, std::string* reason) {
+    const char* missing = nullptr;
+    if (!candidate.graphicsQueue) missing = "no graphics queue";
+    else if (!headless && !candidate.presentQueue) missing = "cannot present to the window";
+    else if (!headless && !candidate.swapchain) missing = "no VK_KHR_swapchain";
+    if (missing) {
+        if (reason) *reason = missing;
+        return -1;
+    }
+
+    // Device type dominates: a discrete GPU beats an integrated one whatever their extras, and a
+    // software rasterizer (llvmpipe, SwiftShader) is only ever the last resort. The tiers are spaced
+    // well beyond the largest possible bonus below (about 3.5k), so extras only order devices of one type.
+    int64_t typeRank = 0;
+    switch (candidate.type) {
+    case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU: typeRank = 4; break;
+    case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU: typeRank = 3; break;
+    case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU: typeRank = 2; break;
+    case VK_PHYSICAL_DEVICE_TYPE_CPU: typeRank = 0; break;
+    default: typeRank = 1; break;
+    }
+    int64_t score = typeRank * 100000;
+    // 100 per GiB of device-local memory, capped to keep a huge card from hiding missing features
+    score += (int64_t)std::min<VkDeviceSize>(candidate.deviceLocalBytes >> 30, 24) * 100;
+    if (candidate.asyncCompute) score += 200;
+    if (candidate.dedicatedTransfer) score += 150;
+    if (candidate.timelineSemaphore) score += 200;
+    if (candidate.descriptorIndexing) score += 200;
+    if (candidate.dynamicRendering) score += 100;
+    if (candidate.memoryBudget) score += 50;
+    score += VK_API_VERSION_MINOR(candidate.apiVersion) * 10;
+    if (reason) reason->clear();
+    return score;
+}
+
+static std::string lowercase(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+    return text;
+}
+
+// Index for an all-digit override, otherwise the first name containing it; -1 if nothing matches
+static int match_override(const std::vector<VSDL_DeviceCandidate>& candidates, const std::string& override) {
+    if (!override.empty() && std::all_of(override.begin(), override.end(), [](unsigned char c) { return std::isdigit(c); })) {
+        unsigned long index = strtoul(override.c_str(), nullptr, 10);
+        return index < candidates.size() ? (int)index : -1;
+    }
+    std::string needle = lowercase(override);
+    for (size_t i = 0; i < candidates.size(); i++) {
+        if (lowercase(candidates[i].name).find(needle) != std::string::npos) return (int)i;
+    }
+    return -1;
+}
+
+int vsdl_select_device(const std::vector<VSDL_DeviceCandidate>& candidates, bool headless, const std::string& override,
+                       std::string* report) {
+    std::string lines;
+    char line[512];
+    int best = -1;
+    int64_t bestScore = -1;
+    std::vector<int64_t> scores(candidates.size());
+    for (size_t i = 0; i < candidates.size(); i++) {
+        const VSDL_DeviceCandidate& candidate = candidates[i];
+        std::string reason;
+        scores[i] = vsdl_score_device(candidate, headless, &reason);
+        if (scores[i] > bestScore) {
+            best = (int)i;
+            bestScore = scores[i];
+        }
+
+        int length = snprintf(line, sizeof(line), "GPU %zu: %s (%s, %.1f GiB, Vulkan %u.%u, %04x:%04x): ", i, candidate.name.c_str(),
+                              device_type_name(candidate.type), candidate.deviceLocalBytes / (1024.0 * 1024.0 * 1024.0),
+                              VK_API_VERSION_MAJOR(candidate.apiVersion), VK_API_VERSION_MINOR(candidate.apiVersion),
+                              candidate.vendorID, candidate.deviceID);
+        if (scores[i] < 0) {
+            snprintf(line + length, sizeof(line) - length, "unusable, %s\n", reason.c_str());
+        } else {
+            snprintf(line + length, sizeof(line) - length, "score %lld%s%s%s%s%s\n", (long long)scores[i],
+                     candidate.asyncCompute ? ", async compute" : "", candidate.dedicatedTransfer ? ", transfer queue" : "",
+                     candidate.timelineSemaphore ? ", timeline" : "", candidate.descriptorIndexing ? ", bindless" : "",
+                     candidate.dynamicRendering ? ", dynamic rendering" : "");
+        }
+        lines += line;
+    }
+
+    int selected = best;
+    const char* how = "highest score";
+    if (!override.empty()) {
+        int match = match_override(candidates, override);
+        if (match < 0) {
+            snprintf(line, sizeof(line), "Device override \"%s\" matches no GPU, ignoring it\n", override.c_str());
+            lines += line;
+        } else if (scores[match] < 0) {
+            snprintf(line, sizeof(line), "Device override \"%s\" names unusable GPU %d, ignoring it\n", override.c_str(), match);
+            lines += line;
+        } else {
+            selected = match;
+            how = "override";
+        }
+    }
+    if (selected < 0) {
+        lines += "No usable GPU";
+    } else {
+        snprintf(line, sizeof(line), "Selected GPU %d: %s (%s)", selected, candidates[selected].name.c_str(), how);
+        lines += line;
+    }
+    if (report) *report = lines;
+    return selected;
+}
\ No newline at end of file
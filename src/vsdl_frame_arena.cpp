@@ -0,0 +1,173 @@
+#include "vsdl_frame_arena.h"
+#include "vsdl_memory.h"
+#include <SDL3/SDL_log.h>
+#include <algorithm>
+#include <stdexcept>
+
+static VkDeviceSize align_up(VkDeviceSize value, VkDeviceSize alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+static bool create_descriptor_set(VSDL_Context& ctx) {
+    VSDL_FrameArena& arena = ctx.frameArena;
+
+    VkDescriptorSetLayoutBinding bindings[2] = {};
+    bindings[0].binding = 0;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    bindings[0].descriptorCount = 1;
+    bindings[0].stageFlags = VK_SHADER_STAGE_ALL_GRAPHICS | VK_SHADER_STAGE_COMPUTE_BIT;
+    bindings[1] = bindings[0];
+    bindings[1].binding = 1;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = 2;
+    layoutInfo.pBindings = bindings;
+    if (vkCreateDescriptorSetLayout(ctx.device, &layoutInfo, nullptr, &arena.setLayout) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create frame arena descriptor set layout");
+        return false;
+    }
+
+    VkDescriptorPoolSize poolSizes[2] = {};
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    poolSizes[0].descriptorCount = 1;
+    poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    poolSizes[1].descriptorCount = 1;
+    VkDescriptorPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = 1;
+    poolInfo.poolSizeCount = 2;
+    poolInfo.pPoolSizes = poolSizes;
+    if (vkCreateDescriptorPool(ctx.device, &poolInfo, nullptr, &arena.descriptorPool) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create frame arena descriptor pool");
+        return false;
+    }
+
+    VkDescriptorSetAllocateInfo allocInfo = {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = arena.descriptorPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &arena.setLayout;
+    if (vkAllocateDescriptorSets(ctx.device, &allocInfo, &arena.set) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate frame arena descriptor set");
+        return false;
+    }
+
+    // Written once: slices only move the dynamic offsets
+    VkDescriptorBufferInfo bufferInfos[2] = {};
+    bufferInfos[0] = { arena.ring.buffer, 0, arena.uniformWindow };
+    bufferInfos[1] = { arena.ring.buffer, 0, arena.storageWindow };
+    VkWriteDescriptorSet writes[2] = {};
+    for (uint32_t i = 0; i < 2; i++) {
+        writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[i].dstSet = arena.set;
+        writes[i].dstBinding = i;
+        writes[i].descriptorCount = 1;
+        writes[i].descriptorType = bindings[i].descriptorType;
+        writes[i].pBufferInfo = &bufferInfos[i];
+    }
+    vkUpdateDescriptorSets(ctx.device, 2, writes, 0, nullptr);
+    return true;
+}
+
+bool vsdl_create_frame_arena(VSDL_Context& ctx) {
+    VSDL_FrameArena& arena = ctx.frameArena;
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(ctx.physicalDevice, &properties);
+    arena.uniformAlignment = std::max<VkDeviceSize>(properties.limits.minUniformBufferOffsetAlignment, 16);
+    arena.storageAlignment = std::max<VkDeviceSize>(properties.limits.minStorageBufferOffsetAlignment, 16);
+    arena.uniformWindow = std::min<VkDeviceSize>(VSDL_FRAME_UNIFORM_WINDOW, properties.limits.maxUniformBufferRange);
+    arena.storageWindow = std::min<VkDeviceSize>(VSDL_FRAME_STORAGE_WINDOW, properties.limits.maxStorageBufferRange);
+
+    arena.cpuBytesPerFrame = VSDL_FRAME_ARENA_CPU_BYTES;
+    arena.cpuMemory = new uint8_t[arena.cpuBytesPerFrame * VSDL_MAX_FRAMES_IN_FLIGHT];
+
+    // The tail pad keeps a window that starts in the last slot inside the buffer
+    arena.gpuBytesPerFrame = VSDL_FRAME_ARENA_GPU_BYTES;
+    VkDeviceSize ringSize = arena.gpuBytesPerFrame * VSDL_MAX_FRAMES_IN_FLIGHT + std::max(arena.uniformWindow, arena.storageWindow);
+    try {
+        arena.ring = vsdl_create_buffer(ctx, ringSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                        VSDL_MemoryClass::Dynamic);
+    } catch (const std::exception&) {
+        return false;
+    }
+    if (!arena.ring.mapped) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Frame arena ring is not host visible");
+        return false;
+    }
+    if (!create_descriptor_set(ctx)) {
+        return false;
+    }
+
+    arena.slot = 0;
+    arena.cpuHead = 0;
+    arena.gpuHead = 0;
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Frame arena: %llu KB CPU and %llu KB GPU per frame slot",
+                (unsigned long long)(arena.cpuBytesPerFrame / 1024), (unsigned long long)(arena.gpuBytesPerFrame / 1024));
+    return true;
+}
+
+void vsdl_destroy_frame_arena(VSDL_Context& ctx) {
+    VSDL_FrameArena& arena = ctx.frameArena;
+    if (arena.descriptorPool) vkDestroyDescriptorPool(ctx.device, arena.descriptorPool, nullptr);
+    if (arena.setLayout) vkDestroyDescriptorSetLayout(ctx.device, arena.setLayout, nullptr);
+    if (arena.ring.buffer) vsdl_destroy_buffer(ctx, arena.ring);
+    delete[] arena.cpuMemory;
+    arena = VSDL_FrameArena{};
+}
+
+void vsdl_frame_arena_begin(VSDL_Context& ctx) {
+    VSDL_FrameArena& arena = ctx.frameArena;
+    arena.slot = ctx.currentFrame;
+    arena.cpuHead = 0;
+    arena.gpuHead = 0;
+}
+
+void vsdl_frame_arena_end(VSDL_Context& ctx) {
+    VSDL_FrameArena& arena = ctx.frameArena;
+    if (arena.gpuHead > 0) {
+        vmaFlushAllocation(ctx.allocator, arena.ring.allocation, arena.slot * arena.gpuBytesPerFrame, arena.gpuHead);
+    }
+    arena.lastCpuBytes = arena.cpuHead;
+    arena.lastGpuBytes = arena.gpuHead;
+    arena.peakCpuBytes = std::max(arena.peakCpuBytes, arena.cpuHead);
+    arena.peakGpuBytes = std::max(arena.peakGpuBytes, arena.gpuHead);
+}
+
+void* vsdl_frame_alloc(VSDL_Context& ctx, size_t size, size_t alignment) {
+    VSDL_FrameArena& arena = ctx.frameArena;
+    size_t offset = (size_t)align_up(arena.cpuHead, alignment);
+    if (!arena.cpuMemory || offset + size > arena.cpuBytesPerFrame) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Frame arena out of CPU memory (%zu of %zu bytes requested)",
+                     offset + size, arena.cpuBytesPerFrame);
+        throw std::runtime_error("Frame arena exhausted");
+    }
+    arena.cpuHead = offset + size;
+    return arena.cpuMemory + arena.slot * arena.cpuBytesPerFrame + offset;
+}
+
+static VSDL_FrameSlice alloc_slice(VSDL_Context& ctx, VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize window) {
+    VSDL_FrameArena& arena = ctx.frameArena;
+    VkDeviceSize offset = align_up(arena.gpuHead, alignment);
+    if (!arena.ring.buffer || size > window || offset + size > arena.gpuBytesPerFrame) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Frame arena out of GPU memory (%llu bytes at %llu, window %llu)",
+                     (unsigned long long)size, (unsigned long long)offset, (unsigned long long)window);
+        throw std::runtime_error("Frame arena exhausted");
+    }
+    arena.gpuHead = offset + size;
+
+    VSDL_FrameSlice slice;
+    slice.buffer = arena.ring.buffer;
+    slice.offset = arena.slot * arena.gpuBytesPerFrame + offset; // Slot bases are multiples of both alignments
+    slice.size = size;
+    slice.mapped = (uint8_t*)arena.ring.mapped + slice.offset;
+    return slice;
+}
+
+VSDL_FrameSlice vsdl_frame_alloc_uniform(VSDL_Context& ctx, VkDeviceSize size) {
+    return alloc_slice(ctx, size, ctx.frameArena.uniformAlignment, ctx.frameArena.uniformWindow);
+}
+
+VSDL_FrameSlice vsdl_frame_alloc_storage(VSDL_Context& ctx, VkDeviceSize size) {
+    return alloc_slice(ctx, size, ctx.frameArena.storageAlignment, ctx.frameArena.storageWindow);
+}
\ No newline at end of file
@@ -0,0 +1,707 @@
+#include "vsdl_graph.h"
+#include "vsdl_frame_arena.h"
+#include "vsdl_profiler.h"
+#include <SDL3/SDL_log.h>
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+#define VSDL_GRAPH_MAX_COLOR_ATTACHMENTS 8
+
+// Layout, synchronization scope and usage implied by one kind of use
+struct VSDL_GraphAccessInfo {
+    VkImageLayout layout;
+    VkPipelineStageFlags2 stage;
+    VkAccessFlags2 access;
+    VkImageUsageFlags usage;
+    bool write;
+    bool attachment;
+};
+
+static VSDL_GraphAccessInfo access_info(VSDL_GraphAccess access) {
+    const VkPipelineStageFlags2 depthStages = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+    switch (access) {
+        case VSDL_GraphAccess::ColorAttachment:
+            return { VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+                     VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+                     VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, true, true };
+        case VSDL_GraphAccess::DepthAttachment:
+            return { VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, depthStages,
+                     VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                     VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, true, true };
+        case VSDL_GraphAccess::DepthRead:
+            return { VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, depthStages, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
+                     VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, false, true };
+        case VSDL_GraphAccess::Sampled:
+            return { VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                     VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                     VK_ACCESS_2_SHADER_READ_BIT, VK_IMAGE_USAGE_SAMPLED_BIT, false, false };
+        case VSDL_GraphAccess::StorageRead:
+            return { VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT,
+                     VK_IMAGE_USAGE_STORAGE_BIT, false, false };
+        case VSDL_GraphAccess::StorageWrite:
+            return { VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                     VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT, VK_IMAGE_USAGE_STORAGE_BIT, true, false };
+        case VSDL_GraphAccess::TransferSrc:
+            return { VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT,
+                     VK_IMAGE_USAGE_TRANSFER_SRC_BIT, false, false };
+        case VSDL_GraphAccess::TransferDst:
+            return { VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                     VK_IMAGE_USAGE_TRANSFER_DST_BIT, true, false };
+    }
+    return {};
+}
+
+static bool is_depth_format(VkFormat format) {
+    switch (format) {
+        case VK_FORMAT_D16_UNORM:
+        case VK_FORMAT_X8_D24_UNORM_PACK32:
+        case VK_FORMAT_D32_SFLOAT:
+        case VK_FORMAT_D16_UNORM_S8_UINT:
+        case VK_FORMAT_D24_UNORM_S8_UINT:
+        case VK_FORMAT_D32_SFLOAT_S8_UINT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static VkImageAspectFlags aspect_for(VkFormat format) {
+    if (!is_depth_format(format)) return VK_IMAGE_ASPECT_COLOR_BIT;
+    if (format == VK_FORMAT_D16_UNORM_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT || format == VK_FORMAT_D32_SFLOAT_S8_UINT) {
+        return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+    }
+    return VK_IMAGE_ASPECT_DEPTH_BIT;
+}
+
+uint32_t vsdl_graph_import_image(VSDL_RenderGraph& graph, const char* name, VkFormat format,
+                                 VkImageLayout initialLayout, VkImageLayout finalLayout) {
+    VSDL_GraphResource resource;
+    resource.name = name;
+    resource.imported = true;
+    resource.format = format;
+    resource.initialLayout = initialLayout;
+    resource.finalLayout = finalLayout;
+    graph.resources.push_back(resource);
+    return (uint32_t)graph.resources.size() - 1;
+}
+
+uint32_t vsdl_graph_create_image(VSDL_RenderGraph& graph, const char* name, VkFormat format, VkClearValue clearValue) {
+    VSDL_GraphResource resource;
+    resource.name = name;
+    resource.format = format;
+    resource.clearValue = clearValue;
+    graph.resources.push_back(resource);
+    return (uint32_t)graph.resources.size() - 1;
+}
+
+uint32_t vsdl_graph_add_pass(VSDL_RenderGraph& graph, const char* name,
+                             std::function<void(VSDL_Context&, VkCommandBuffer)> record) {
+    VSDL_GraphPass pass;
+    pass.name = name;
+    pass.record = std::move(record);
+    graph.passes.push_back(std::move(pass));
+    return (uint32_t)graph.passes.size() - 1;
+}
+
+void vsdl_graph_use(VSDL_RenderGraph& graph, uint32_t pass, uint32_t resource, VSDL_GraphAccess access) {
+    graph.passes[pass].uses.push_back({ resource, access });
+}
+
+void vsdl_graph_set_output(VSDL_RenderGraph& graph, uint32_t resource) {
+    graph.outputs.push_back(resource);
+}
+
+void vsdl_graph_bind_image(VSDL_RenderGraph& graph, uint32_t resource, VkImage image, VkImageView view) {
+    graph.resources[resource].image = image;
+    graph.resources[resource].view = view;
+}
+
+static void release_transients(VSDL_Context& ctx, VSDL_RenderGraph& graph) {
+    for (auto& resource : graph.resources) {
+        if (resource.imported) continue;
+        if (resource.view) vkDestroyImageView(ctx.device, resource.view, nullptr);
+        if (resource.image) vkDestroyImage(ctx.device, resource.image, nullptr);
+        resource.view = VK_NULL_HANDLE;
+        resource.image = VK_NULL_HANDLE;
+    }
+    if (graph.transientMemory) vmaFreeMemory(ctx.allocator, graph.transientMemory);
+    graph.transientMemory = VK_NULL_HANDLE;
+    graph.transientBytes = 0;
+    graph.unaliasedBytes = 0;
+}
+
+// Walk back from the outputs: a pass survives if it writes something a surviving pass (or the output) needs
+static void cull_passes(VSDL_RenderGraph& graph) {
+    std::vector<bool> needed(graph.resources.size(), false);
+    for (uint32_t output : graph.outputs) needed[output] = true;
+    for (size_t i = graph.passes.size(); i-- > 0;) {
+        VSDL_GraphPass& pass = graph.passes[i];
+        pass.culled = true;
+        for (const auto& use : pass.uses) {
+            if (access_info(use.access).write && needed[use.resource]) pass.culled = false;
+        }
+        if (pass.culled) continue;
+        // Later writers load the previous contents, so every resource touched keeps its producers alive
+        for (const auto& use : pass.uses) needed[use.resource] = true;
+    }
+}
+
+// Per-resource hazard tracking while walking the live passes in order
+struct VSDL_GraphState {
+    bool touched = false;
+    VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    VkPipelineStageFlags2 writeStage = 0;
+    VkAccessFlags2 writeAccess = 0;
+    VkPipelineStageFlags2 readStages = 0;    // Reads since the last write (or transition)
+    VkPipelineStageFlags2 visibleStages = 0; // Stages the last write has been made visible to
+};
+
+static void compute_barriers(VSDL_RenderGraph& graph) {
+    std::vector<VSDL_GraphState> states(graph.resources.size());
+    for (uint32_t p = 0; p < graph.passes.size(); p++) {
+        VSDL_GraphPass& pass = graph.passes[p];
+        pass.barriers.clear();
+        if (pass.culled) continue;
+
+        // Merge repeated uses of one resource, they must agree on the layout
+        std::vector<std::pair<uint32_t, VSDL_GraphAccessInfo>> merged;
+        for (const auto& use : pass.uses) {
+            VSDL_GraphAccessInfo info = access_info(use.access);
+            auto it = std::find_if(merged.begin(), merged.end(), [&](const auto& entry) { return entry.first == use.resource; });
+            if (it == merged.end()) {
+                merged.push_back({ use.resource, info });
+                continue;
+            }
+            if (it->second.layout != info.layout) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Render graph: pass %s uses %s in two layouts",
+                             pass.name, graph.resources[use.resource].name);
+                throw std::runtime_error("Render graph compilation failed");
+            }
+            it->second.stage |= info.stage;
+            it->second.access |= info.access;
+            it->second.write = it->second.write || info.write;
+        }
+
+        for (const auto& [index, info] : merged) {
+            const VSDL_GraphResource& resource = graph.resources[index];
+            VSDL_GraphState& state = states[index];
+            VSDL_GraphBarrier barrier;
+            barrier.resource = index;
+            barrier.newLayout = info.layout;
+            barrier.dstStage = info.stage;
+            barrier.dstAccess = info.access;
+            bool emit = false;
+
+            if (!state.touched) {
+                if (resource.imported) {
+                    // Chained to the acquire semaphore, which is waited at the same stage
+                    barrier.oldLayout = resource.initialLayout;
+                    barrier.srcStage = info.stage;
+                    emit = resource.initialLayout != info.layout;
+                } else {
+                    // Transient memory may still hold another image or the previous frame's use of this one
+                    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+                    barrier.srcStage = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+                    barrier.srcAccess = VK_ACCESS_2_MEMORY_WRITE_BIT;
+                    emit = true;
+                }
+            } else if (state.layout != info.layout || info.write) {
+                // Transition, write-after-write or write-after-read
+                barrier.oldLayout = state.layout;
+                barrier.srcStage = state.writeStage | state.readStages;
+                barrier.srcAccess = state.writeAccess;
+                emit = state.layout != info.layout || barrier.srcStage != 0;
+            } else if (state.writeStage && (info.stage & ~state.visibleStages)) {
+                // Read-after-write at a stage that hasn't seen the write yet; chains through earlier readers
+                barrier.oldLayout = state.layout;
+                barrier.srcStage = state.writeStage | state.readStages;
+                barrier.srcAccess = state.writeAccess;
+                emit = true;
+            }
+            if (emit) pass.barriers.push_back(barrier);
+
+            bool transitioned = !state.touched || state.layout != info.layout;
+            state.touched = true;
+            state.layout = info.layout;
+            if (info.write) {
+                state.writeStage = info.stage;
+                state.writeAccess = info.access & (VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+                                                   VK_ACCESS_2_SHADER_WRITE_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT);
+                state.readStages = 0;
+                state.visibleStages = 0;
+            } else {
+                state.readStages = transitioned ? info.stage : (state.readStages | info.stage);
+                if (emit) state.visibleStages |= info.stage;
+            }
+        }
+    }
+
+    graph.finalBarriers.clear();
+    for (uint32_t i = 0; i < graph.resources.size(); i++) {
+        const VSDL_GraphResource& resource = graph.resources[i];
+        const VSDL_GraphState& state = states[i];
+        if (!resource.imported || !state.touched || resource.finalLayout == VK_IMAGE_LAYOUT_UNDEFINED) continue;
+        if (resource.finalLayout == state.layout) continue;
+
+        VSDL_GraphBarrier barrier;
+        barrier.resource = i;
+        barrier.oldLayout = state.layout;
+        barrier.newLayout = resource.finalLayout;
+        barrier.srcStage = state.writeStage | state.readStages;
+        barrier.srcAccess = state.writeAccess;
+        if (resource.finalLayout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL) {
+            barrier.dstStage = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+            barrier.dstAccess = VK_ACCESS_2_TRANSFER_READ_BIT;
+        } else if (resource.finalLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
+            barrier.dstStage = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+            barrier.dstAccess = VK_ACCESS_2_SHADER_READ_BIT;
+        }
+        // PRESENT_SRC: presentation is ordered by the render-finished semaphore, no destination scope
+        graph.finalBarriers.push_back(barrier);
+    }
+}
+
+// Place transients into one allocation: images whose live ranges don't overlap may share bytes
+static void allocate_transients(VSDL_Context& ctx, VSDL_RenderGraph& graph) {
+    struct Placement {
+        uint32_t resource;
+        VkMemoryRequirements requirements;
+    };
+    std::vector<Placement> placements;
+    for (uint32_t i = 0; i < graph.resources.size(); i++) {
+        VSDL_GraphResource& resource = graph.resources[i];
+        if (resource.imported || resource.firstPass == UINT32_MAX) continue;
+
+        VkImageCreateInfo imageInfo = {};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.format = resource.format;
+        imageInfo.extent = { graph.extent.width, graph.extent.height, 1 };
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.usage = resource.usage;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        if (vkCreateImage(ctx.device, &imageInfo, nullptr, &resource.image) != VK_SUCCESS) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Render graph: failed to create image %s", resource.name);
+            throw std::runtime_error("Render graph image creation failed");
+        }
+        Placement placement = { i, {} };
+        vkGetImageMemoryRequirements(ctx.device, resource.image, &placement.requirements);
+        placements.push_back(placement);
+    }
+    if (placements.empty()) return;
+
+    // Largest first, each at the lowest offset that is free for its whole lifetime
+    std::sort(placements.begin(), placements.end(), [](const Placement& a, const Placement& b) {
+        return a.requirements.size > b.requirements.size;
+    });
+    VkMemoryRequirements combined = {};
+    combined.memoryTypeBits = ~0u;
+    combined.alignment = 1;
+    std::vector<uint32_t> placed;
+    for (const auto& placement : placements) {
+        VSDL_GraphResource& resource = graph.resources[placement.resource];
+        const VkDeviceSize alignment = placement.requirements.alignment;
+        const VkDeviceSize size = placement.requirements.size;
+
+        std::vector<VkDeviceSize> candidates = { 0 };
+        for (uint32_t other : placed) {
+            const VSDL_GraphResource& o = graph.resources[other];
+            if (o.lastPass < resource.firstPass || resource.lastPass < o.firstPass) continue;
+            candidates.push_back((o.memoryOffset + o.memorySize + alignment - 1) / alignment * alignment);
+        }
+        std::sort(candidates.begin(), candidates.end());
+        for (VkDeviceSize offset : candidates) {
+            bool fits = true;
+            for (uint32_t other : placed) {
+                const VSDL_GraphResource& o = graph.resources[other];
+                if (o.lastPass < resource.firstPass || resource.lastPass < o.firstPass) continue;
+                if (offset < o.memoryOffset + o.memorySize && o.memoryOffset < offset + size) {
+                    fits = false;
+                    break;
+                }
+            }
+            if (fits) {
+                resource.memoryOffset = offset;
+                break;
+            }
+        }
+        resource.memorySize = size;
+        placed.push_back(placement.resource);
+
+        combined.size = std::max(combined.size, resource.memoryOffset + size);
+        combined.alignment = std::max(combined.alignment, alignment);
+        combined.memoryTypeBits &= placement.requirements.memoryTypeBits;
+        graph.unaliasedBytes += (size + alignment - 1) / alignment * alignment;
+    }
+    if (combined.memoryTypeBits == 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Render graph: transient images share no memory type");
+        throw std::runtime_error("Render graph aliasing failed");
+    }
+
+    VmaAllocationCreateInfo allocInfo = {};
+    allocInfo.preferredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    if (vmaAllocateMemory(ctx.allocator, &combined, &allocInfo, &graph.transientMemory, nullptr) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Render graph: failed to allocate %llu bytes of transient memory",
+                     (unsigned long long)combined.size);
+        throw std::runtime_error("Render graph allocation failed");
+    }
+    graph.transientBytes = combined.size;
+
+    for (uint32_t index : placed) {
+        VSDL_GraphResource& resource = graph.resources[index];
+        if (vmaBindImageMemory2(ctx.allocator, graph.transientMemory, resource.memoryOffset, resource.image, nullptr) != VK_SUCCESS) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Render graph: failed to bind image %s", resource.name);
+            throw std::runtime_error("Render graph allocation failed");
+        }
+
+        VkImageViewCreateInfo viewInfo = {};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = resource.image;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = resource.format;
+        viewInfo.subresourceRange.aspectMask = aspect_for(resource.format);
+        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.layerCount = 1;
+        if (vkCreateImageView(ctx.device, &viewInfo, nullptr, &resource.view) != VK_SUCCESS) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Render graph: failed to create view for %s", resource.name);
+            throw std::runtime_error("Render graph image view creation failed");
+        }
+    }
+}
+
+void vsdl_graph_compile(VSDL_Context& ctx, VSDL_RenderGraph& graph) {
+    release_transients(ctx, graph);
+    cull_passes(graph);
+
+    for (auto& resource : graph.resources) {
+        resource.firstPass = UINT32_MAX;
+        resource.lastPass = 0;
+        resource.usage = 0;
+        resource.memoryOffset = 0;
+        resource.memorySize = 0;
+    }
+    for (uint32_t p = 0; p < graph.passes.size(); p++) {
+        if (graph.passes[p].culled) continue;
+        for (const auto& use : graph.passes[p].uses) {
+            VSDL_GraphResource& resource = graph.resources[use.resource];
+            resource.firstPass = std::min(resource.firstPass, p);
+            resource.lastPass = std::max(resource.lastPass, p);
+            resource.usage |= access_info(use.access).usage;
+        }
+    }
+
+    compute_barriers(graph);
+    allocate_transients(ctx, graph);
+    graph.compiled = true;
+}
+
+static void emit_barriers(VSDL_Context& ctx, const VSDL_RenderGraph& graph, VkCommandBuffer commandBuffer,
+                          const std::vector<VSDL_GraphBarrier>& barriers) {
+    if (barriers.empty()) return;
+
+    if (ctx.dynamicRendering.enabled) {
+        VkImageMemoryBarrier2* imageBarriers = vsdl_frame_alloc_array<VkImageMemoryBarrier2>(ctx, barriers.size());
+        for (size_t i = 0; i < barriers.size(); i++) {
+            const VSDL_GraphBarrier& barrier = barriers[i];
+            const VSDL_GraphResource& resource = graph.resources[barrier.resource];
+            VkImageMemoryBarrier2& imageBarrier = imageBarriers[i];
+            imageBarrier = {};
+            imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+            imageBarrier.srcStageMask = barrier.srcStage;
+            imageBarrier.srcAccessMask = barrier.srcAccess;
+            imageBarrier.dstStageMask = barrier.dstStage;
+            imageBarrier.dstAccessMask = barrier.dstAccess;
+            imageBarrier.oldLayout = barrier.oldLayout;
+            imageBarrier.newLayout = barrier.newLayout;
+            imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            imageBarrier.image = resource.image;
+            imageBarrier.subresourceRange = { aspect_for(resource.format), 0, 1, 0, 1 };
+        }
+        VkDependencyInfo dependencyInfo = {};
+        dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dependencyInfo.imageMemoryBarrierCount = (uint32_t)barriers.size();
+        dependencyInfo.pImageMemoryBarriers = imageBarriers;
+        ctx.dynamicRendering.cmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+        return;
+    }
+
+    // 1.0 path: one barrier call with the union of the stages; the flags only use bits shared with sync1
+    VkImageMemoryBarrier* imageBarriers = vsdl_frame_alloc_array<VkImageMemoryBarrier>(ctx, barriers.size());
+    VkPipelineStageFlags srcStages = 0, dstStages = 0;
+    for (size_t i = 0; i < barriers.size(); i++) {
+        const VSDL_GraphBarrier& barrier = barriers[i];
+        const VSDL_GraphResource& resource = graph.resources[barrier.resource];
+        VkImageMemoryBarrier& imageBarrier = imageBarriers[i];
+        imageBarrier = {};
+        imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        imageBarrier.srcAccessMask = (VkAccessFlags)barrier.srcAccess;
+        imageBarrier.dstAccessMask = (VkAccessFlags)barrier.dstAccess;
+        imageBarrier.oldLayout = barrier.oldLayout;
+        imageBarrier.newLayout = barrier.newLayout;
+        imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        imageBarrier.image = resource.image;
+        imageBarrier.subresourceRange = { aspect_for(resource.format), 0, 1, 0, 1 };
+        srcStages |= (VkPipelineStageFlags)barrier.srcStage;
+        dstStages |= (VkPipelineStageFlags)barrier.dstStage;
+    }
+    if (!srcStages) srcStages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+    if (!dstStages) dstStages = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+    vkCmdPipelineBarrier(commandBuffer, srcStages, dstStages, 0, 0, nullptr, 0, nullptr,
+                         (uint32_t)barriers.size(), imageBarriers);
+}
+
+static void begin_rendering(VSDL_Context& ctx, const VSDL_RenderGraph& graph, uint32_t passIndex, VkCommandBuffer commandBuffer) {
+    const VSDL_GraphPass& pass = graph.passes[passIndex];
+    VkRenderingAttachmentInfo colorAttachments[VSDL_GRAPH_MAX_COLOR_ATTACHMENTS] = {};
+    VkRenderingAttachmentInfo depthAttachment = {};
+    uint32_t colorCount = 0;
+    bool hasDepth = false;
+
+    for (const auto& use : pass.uses) {
+        VSDL_GraphAccessInfo info = access_info(use.access);
+        if (!info.attachment) continue;
+        const VSDL_GraphResource& resource = graph.resources[use.resource];
+
+        VkRenderingAttachmentInfo attachment = {};
+        attachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+        attachment.imageView = resource.view;
+        attachment.imageLayout = info.layout;
+        // First writer clears, later passes build on it; transients die with their last reader
+        attachment.loadOp = (info.write && resource.firstPass == passIndex) ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_LOAD;
+        attachment.storeOp = (!resource.imported && resource.lastPass == passIndex) ? VK_ATTACHMENT_STORE_OP_DONT_CARE : VK_ATTACHMENT_STORE_OP_STORE;
+        attachment.clearValue = resource.clearValue;
+
+        if (is_depth_format(resource.format)) {
+            depthAttachment = attachment;
+            hasDepth = true;
+        } else if (colorCount < VSDL_GRAPH_MAX_COLOR_ATTACHMENTS) {
+            colorAttachments[colorCount++] = attachment;
+        }
+    }
+
+    VkRenderingInfo renderingInfo = {};
+    renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+    renderingInfo.flags = pass.secondaryContents ? VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT : 0;
+    renderingInfo.renderArea.extent = graph.extent;
+    renderingInfo.layerCount = 1;
+    renderingInfo.colorAttachmentCount = colorCount;
+    renderingInfo.pColorAttachments = colorAttachments;
+    renderingInfo.pDepthAttachment = hasDepth ? &depthAttachment : nullptr;
+    ctx.dynamicRendering.cmdBeginRendering(commandBuffer, &renderingInfo);
+}
+
+void vsdl_graph_execute(VSDL_Context& ctx, VSDL_RenderGraph& graph, VkCommandBuffer commandBuffer) {
+    for (uint32_t p = 0; p < graph.passes.size(); p++) {
+        const VSDL_GraphPass& pass = graph.passes[p];
+        if (pass.culled) continue;
+
+        bool rendering = std::any_of(pass.uses.begin(), pass.uses.end(),
+                                     [](const VSDL_GraphUse& use) { return access_info(use.access).attachment; });
+        if (rendering && !ctx.dynamicRendering.enabled) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Render graph: pass %s needs dynamic rendering", pass.name);
+            throw std::runtime_error("Render graph execution failed");
+        }
+
+        emit_barriers(ctx, graph, commandBuffer, pass.barriers);
+        vsdl_gpu_scope_begin(ctx, commandBuffer, pass.name);
+        if (rendering) begin_rendering(ctx, graph, p, commandBuffer);
+        if (pass.record) pass.record(ctx, commandBuffer);
+        if (rendering) ctx.dynamicRendering.cmdEndRendering(commandBuffer);
+        vsdl_gpu_scope_end(ctx, commandBuffer);
+    }
+    emit_barriers(ctx, graph, commandBuffer, graph.finalBarriers);
+}
+
+void vsdl_graph_destroy(VSDL_Context& ctx, VSDL_RenderGraph& graph) {
+    release_transients(ctx, graph);
+    graph = VSDL_RenderGraph{};
+}
+
+static const char* layout_name(VkImageLayout layout) {
+    switch (layout) {
+        case VK_IMAGE_LAYOUT_UNDEFINED: return "UNDEFINED";
+        case VK_IMAGE_LAYOUT_GENERAL: return "GENERAL";
+        case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL: return "COLOR_ATTACHMENT";
+        case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL: return "DEPTH_ATTACHMENT";
+        case VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL: return "DEPTH_READ_ONLY";
+        case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL: return "SHADER_READ_ONLY";
+        case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL: return "TRANSFER_SRC";
+        case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL: return "TRANSFER_DST";
+        case VK_IMAGE_LAYOUT_PRESENT_SRC_KHR: return "PRESENT_SRC";
+        default: return "OTHER";
+    }
+}
+
+static const char* access_name(VSDL_GraphAccess access) {
+    switch (access) {
+        case VSDL_GraphAccess::ColorAttachment: return "color";
+        case VSDL_GraphAccess::DepthAttachment: return "depth";
+        case VSDL_GraphAccess::DepthRead: return "depth-read";
+        case VSDL_GraphAccess::Sampled: return "sampled";
+        case VSDL_GraphAccess::StorageRead: return "storage-read";
+        case VSDL_GraphAccess::StorageWrite: return "storage-write";
+        case VSDL_GraphAccess::TransferSrc: return "transfer-src";
+        case VSDL_GraphAccess::TransferDst: return "transfer-dst";
+    }
+    return "unknown";
+}
+
+static std::string stage_names(VkPipelineStageFlags2 stages) {
+    static const std::pair<VkPipelineStageFlags2, const char*> names[] = {
+        { VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, "ALL_COMMANDS" },
+        { VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT, "EARLY_FRAGMENT_TESTS" },
+        { VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT, "LATE_FRAGMENT_TESTS" },
+        { VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, "FRAGMENT_SHADER" },
+        { VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, "COLOR_ATTACHMENT_OUTPUT" },
+        { VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, "COMPUTE_SHADER" },
+        { VK_PIPELINE_STAGE_2_TRANSFER_BIT, "TRANSFER" },
+    };
+    if (!stages) return "NONE";
+    std::string result;
+    for (const auto& [bit, name] : names) {
+        if (!(stages & bit)) continue;
+        if (!result.empty()) result += "|";
+        result += name;
+    }
+    return result;
+}
+
+static std::string access_flag_names(VkAccessFlags2 access) {
+    static const std::pair<VkAccessFlags2, const char*> names[] = {
+        { VK_ACCESS_2_MEMORY_WRITE_BIT, "MEMORY_WRITE" },
+        { VK_ACCESS_2_SHADER_READ_BIT, "SHADER_READ" },
+        { VK_ACCESS_2_SHADER_WRITE_BIT, "SHADER_WRITE" },
+        { VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT, "COLOR_READ" },
+        { VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT, "COLOR_WRITE" },
+        { VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT, "DEPTH_READ" },
+        { VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, "DEPTH_WRITE" },
+        { VK_ACCESS_2_TRANSFER_READ_BIT, "TRANSFER_READ" },
+        { VK_ACCESS_2_TRANSFER_WRITE_BIT, "TRANSFER_WRITE" },
+    };
+    if (!access) return "0";
+    std::string result;
+    for (const auto& [bit, name] : names) {
+        if (!(access & bit)) continue;
+        if (!result.empty()) result += "|";
+        result += name;
+    }
+    return result;
+}
+
+static void append_barrier(std::string& out, const VSDL_RenderGraph& graph, const VSDL_GraphBarrier& barrier) {
+    char line[512];
+    snprintf(line, sizeof(line), "      barrier %-12s %s -> %s  src %s [%s]  dst %s [%s]\n",
+             graph.resources[barrier.resource].name, layout_name(barrier.oldLayout), layout_name(barrier.newLayout),
+             stage_names(barrier.srcStage).c_str(), access_flag_names(barrier.srcAccess).c_str(),
+             stage_names(barrier.dstStage).c_str(), access_flag_names(barrier.dstAccess).c_str());
+    out += line;
+}
+
+std::string vsdl_graph_dump(const VSDL_RenderGraph& graph) {
+    std::string out;
+    char line[512];
+    uint32_t culled = 0, barrierCount = (uint32_t)graph.finalBarriers.size();
+    for (const auto& pass : graph.passes) {
+        culled += pass.culled ? 1 : 0;
+        barrierCount += (uint32_t)pass.barriers.size();
+    }
+    snprintf(line, sizeof(line), "Render graph: %zu passes (%u culled), %zu resources, %u barriers, %ux%u\n",
+             graph.passes.size(), culled, graph.resources.size(), barrierCount, graph.extent.width, graph.extent.height);
+    out += line;
+
+    out += "Resources:\n";
+    for (size_t i = 0; i < graph.resources.size(); i++) {
+        const VSDL_GraphResource& resource = graph.resources[i];
+        if (resource.firstPass == UINT32_MAX) {
+            snprintf(line, sizeof(line), "  [%zu] %-12s %-9s format %d, unused\n", i, resource.name,
+                     resource.imported ? "imported" : "transient", (int)resource.format);
+        } else if (resource.imported) {
+            snprintf(line, sizeof(line), "  [%zu] %-12s imported  format %d, passes %u..%u, %s -> %s\n", i, resource.name,
+                     (int)resource.format, resource.firstPass, resource.lastPass,
+                     layout_name(resource.initialLayout), layout_name(resource.finalLayout));
+        } else {
+            snprintf(line, sizeof(line), "  [%zu] %-12s transient format %d, passes %u..%u, offset %llu KB, size %llu KB\n", i,
+                     resource.name, (int)resource.format, resource.firstPass, resource.lastPass,
+                     (unsigned long long)(resource.memoryOffset / 1024), (unsigned long long)(resource.memorySize / 1024));
+        }
+        out += line;
+    }
+
+    out += "Passes:\n";
+    for (size_t i = 0; i < graph.passes.size(); i++) {
+        const VSDL_GraphPass& pass = graph.passes[i];
+        snprintf(line, sizeof(line), "  [%zu] %s%s\n", i, pass.name, pass.culled ? " (culled: no path to an output)" : "");
+        out += line;
+        for (const auto& use : pass.uses) {
+            snprintf(line, sizeof(line), "      %-5s %-12s %s\n", access_info(use.access).write ? "write" : "read",
+                     graph.resources[use.resource].name, access_name(use.access));
+            out += line;
+        }
+        for (const auto& barrier : pass.barriers) append_barrier(out, graph, barrier);
+    }
+
+    out += "Final:\n";
+    for (const auto& barrier : graph.finalBarriers) append_barrier(out, graph, barrier);
+
+    double saved = graph.unaliasedBytes ? 100.0 * (1.0 - (double)graph.transientBytes / (double)graph.unaliasedBytes) : 0.0;
+    snprintf(line, sizeof(line), "Transient memory: %.2f MB aliased, %.2f MB without aliasing (%.0f%% saved)\n",
+             graph.transientBytes / (1024.0 * 1024.0), graph.unaliasedBytes / (1024.0 * 1024.0), saved);
+    out += line;
+    return out;
+}
+
+std::string vsdl_graph_dump_demo(VSDL_Context& ctx) {
+    VSDL_RenderGraph graph;
+    graph.extent = ctx.swapchainExtent;
+
+    VkClearValue clearDepth = {};
+    clearDepth.depthStencil.depth = 0.0f; // Reverse-Z: 0 is the far plane
+    uint32_t backbuffer = vsdl_graph_import_image(graph, "backbuffer", ctx.swapchainImageFormat, VK_IMAGE_LAYOUT_UNDEFINED,
+                                                  ctx.headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+    uint32_t albedo = vsdl_graph_create_image(graph, "albedo", VK_FORMAT_R8G8B8A8_UNORM);
+    uint32_t normal = vsdl_graph_create_image(graph, "normal", VK_FORMAT_R16G16B16A16_SFLOAT);
+    uint32_t depth = vsdl_graph_create_image(graph, "depth", VK_FORMAT_D32_SFLOAT, clearDepth);
+    uint32_t hdr = vsdl_graph_create_image(graph, "hdr", VK_FORMAT_R16G16B16A16_SFLOAT);
+    uint32_t bloom = vsdl_graph_create_image(graph, "bloom", VK_FORMAT_R16G16B16A16_SFLOAT);
+    uint32_t debugView = vsdl_graph_create_image(graph, "debug_view", VK_FORMAT_R8G8B8A8_UNORM);
+
+    uint32_t pass = vsdl_graph_add_pass(graph, "gbuffer", nullptr);
+    vsdl_graph_use(graph, pass, albedo, VSDL_GraphAccess::ColorAttachment);
+    vsdl_graph_use(graph, pass, normal, VSDL_GraphAccess::ColorAttachment);
+    vsdl_graph_use(graph, pass, depth, VSDL_GraphAccess::DepthAttachment);
+
+    pass = vsdl_graph_add_pass(graph, "lighting", nullptr);
+    vsdl_graph_use(graph, pass, albedo, VSDL_GraphAccess::Sampled);
+    vsdl_graph_use(graph, pass, normal, VSDL_GraphAccess::Sampled);
+    vsdl_graph_use(graph, pass, depth, VSDL_GraphAccess::Sampled);
+    vsdl_graph_use(graph, pass, hdr, VSDL_GraphAccess::ColorAttachment);
+
+    pass = vsdl_graph_add_pass(graph, "bloom", nullptr);
+    vsdl_graph_use(graph, pass, hdr, VSDL_GraphAccess::Sampled);
+    vsdl_graph_use(graph, pass, bloom, VSDL_GraphAccess::StorageWrite);
+
+    pass = vsdl_graph_add_pass(graph, "debug_normals", nullptr);
+    vsdl_graph_use(graph, pass, normal, VSDL_GraphAccess::Sampled);
+    vsdl_graph_use(graph, pass, debugView, VSDL_GraphAccess::ColorAttachment);
+
+    pass = vsdl_graph_add_pass(graph, "tonemap", nullptr);
+    vsdl_graph_use(graph, pass, hdr, VSDL_GraphAccess::Sampled);
+    vsdl_graph_use(graph, pass, bloom, VSDL_GraphAccess::Sampled);
+    vsdl_graph_use(graph, pass, backbuffer, VSDL_GraphAccess::ColorAttachment);
+
+    pass = vsdl_graph_add_pass(graph, "ui", nullptr);
+    vsdl_graph_use(graph, pass, backbuffer, VSDL_GraphAccess::ColorAttachment);
+
+    vsdl_graph_set_output(graph, backbuffer);
+    vsdl_graph_compile(ctx, graph);
+    std::string dump = vsdl_graph_dump(graph);
+    vsdl_graph_destroy(ctx, graph);
+    return dump;
+}
\ No newline at end of file
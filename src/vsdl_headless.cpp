@@ -0,0 +1,322 @@
+#include "vsdl_headless.h"
+#include "vsdl_renderer.h"
+#include "vsdl_particles.h"
+#include "vsdl_shader_reload.h"
+#include "vsdl_descriptors.h"
+#include "vsdl_frame_arena.h"
+#include "vsdl_texture_stream.h"
+#include "vsdl_sync.h"
+#include "vsdl_imgui.h"
+#include "vsdl_memory.h"
+#include "vsdl_upload.h"
+#include "vsdl_profiler.h"
+#include <SDL3/SDL_log.h>
+#include <SDL3/SDL_timer.h>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+bool vsdl_create_offscreen_targets(VSDL_Context& ctx) {
+    if (ctx.framesInFlight < 1) ctx.framesInFlight = 1;
+    if (ctx.framesInFlight > VSDL_MAX_FRAMES_IN_FLIGHT) ctx.framesInFlight = VSDL_MAX_FRAMES_IN_FLIGHT;
+
+    // RGBA8 keeps the readback trivially convertible to image files
+    ctx.swapchainImageFormat = VK_FORMAT_R8G8B8A8_UNORM;
+    ctx.swapchainExtent = { ctx.headlessConfig.width, ctx.headlessConfig.height };
+    VkDeviceSize imageSize = (VkDeviceSize)ctx.swapchainExtent.width * ctx.swapchainExtent.height * 4;
+
+    // One target per frame slot, so a slot's readback is consumed once the slot comes around again
+    uint32_t targetCount = ctx.framesInFlight;
+    ctx.offscreenTargets.resize(targetCount);
+    ctx.swapchainImages.resize(targetCount);
+    ctx.swapchainImageViews.resize(targetCount);
+    ctx.imagesInFlight.assign(targetCount, 0);
+
+    for (uint32_t i = 0; i < targetCount; i++) {
+        VSDL_OffscreenTarget& target = ctx.offscreenTargets[i];
+
+        VkImageCreateInfo imageInfo = {};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.format = ctx.swapchainImageFormat;
+        imageInfo.extent = { ctx.swapchainExtent.width, ctx.swapchainExtent.height, 1 };
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        try {
+            target.image = vsdl_create_image(ctx, imageInfo, true);
+        } catch (const std::exception&) {
+            return false;
+        }
+        ctx.swapchainImages[i] = target.image.image;
+
+        VkImageViewCreateInfo viewInfo = {};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = target.image.image;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = ctx.swapchainImageFormat;
+        viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.layerCount = 1;
+        if (vkCreateImageView(ctx.device, &viewInfo, nullptr, &ctx.swapchainImageViews[i]) != VK_SUCCESS) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create offscreen image view %u", i);
+            return false;
+        }
+
+        // Persistently mapped, cached host memory: the CPU reads every byte back
+        try {
+            target.readback = vsdl_create_buffer(ctx, imageSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VSDL_MemoryClass::Readback);
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Created %u offscreen targets %ux%u",
+                targetCount, ctx.swapchainExtent.width, ctx.swapchainExtent.height);
+    return true;
+}
+
+void vsdl_destroy_offscreen_targets(VSDL_Context& ctx) {
+    for (auto& target : ctx.offscreenTargets) {
+        vsdl_destroy_buffer(ctx, target.readback);
+        vsdl_destroy_image(ctx, target.image);
+    }
+    ctx.offscreenTargets.clear();
+}
+
+namespace {
+    struct DumpedFrame {
+        uint64_t frameIndex = 0;
+        std::vector<uint8_t> pixels; // RGBA8
+    };
+
+    // Writes frames to disk on a background thread so file I/O doesn't stall submission
+    class FrameWriter {
+    public:
+        FrameWriter(const std::string& outputDir, uint32_t width, uint32_t height)
+            : outputDir_(outputDir), width_(width), height_(height) {
+            thread_ = std::thread([this] { run(); });
+        }
+
+        ~FrameWriter() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                done_ = true;
+            }
+            wakeWriter_.notify_one();
+            thread_.join();
+        }
+
+        void push(DumpedFrame&& frame) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            // Bounded queue: apply back-pressure instead of buffering unbounded memory when the disk is slow
+            wakeProducer_.wait(lock, [this] { return queue_.size() < kMaxQueuedFrames; });
+            queue_.push_back(std::move(frame));
+            lock.unlock();
+            wakeWriter_.notify_one();
+        }
+
+    private:
+        static constexpr size_t kMaxQueuedFrames = 16;
+
+        void run() {
+            for (;;) {
+                DumpedFrame frame;
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    wakeWriter_.wait(lock, [this] { return done_ || !queue_.empty(); });
+                    if (queue_.empty()) return;
+                    frame = std::move(queue_.front());
+                    queue_.pop_front();
+                }
+                wakeProducer_.notify_one();
+                write(frame);
+            }
+        }
+
+        void write(const DumpedFrame& frame) {
+            char name[64];
+            snprintf(name, sizeof(name), "frame_%05llu.ppm", (unsigned long long)frame.frameIndex);
+            std::string path = (std::filesystem::path(outputDir_) / name).string();
+            FILE* file = fopen(path.c_str(), "wb");
+            if (!file) {
+                SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Failed to open %s for writing", path.c_str());
+                return;
+            }
+            fprintf(file, "P6\n%u %u\n255\n", width_, height_);
+            std::vector<uint8_t> row(width_ * 3);
+            for (uint32_t y = 0; y < height_; y++) {
+                const uint8_t* src = frame.pixels.data() + (size_t)y * width_ * 4;
+                for (uint32_t x = 0; x < width_; x++) {
+                    row[x * 3 + 0] = src[x * 4 + 0];
+                    row[x * 3 + 1] = src[x * 4 + 1];
+                    row[x * 3 + 2] = src[x * 4 + 2];
+                }
+                fwrite(row.data(), 1, row.size(), file);
+            }
+            fclose(file);
+        }
+
+        std::string outputDir_;
+        uint32_t width_;
+        uint32_t height_;
+        std::thread thread_;
+        std::mutex mutex_;
+        std::condition_variable wakeWriter_;
+        std::condition_variable wakeProducer_;
+        std::deque<DumpedFrame> queue_;
+        bool done_ = false;
+    };
+}
+
+// Hand the finished readback of a slot to the writer (if dumping) and mark it consumed
+static void consume_readback(VSDL_Context& ctx, VSDL_OffscreenTarget& target, FrameWriter* writer) {
+    if (!target.pending) return;
+    target.pending = false;
+    if (!writer) return;
+
+    VkDeviceSize size = (VkDeviceSize)ctx.swapchainExtent.width * ctx.swapchainExtent.height * 4;
+    vmaInvalidateAllocation(ctx.allocator, target.readback.allocation, 0, VK_WHOLE_SIZE);
+
+    DumpedFrame frame;
+    frame.frameIndex = target.frameIndex;
+    frame.pixels.resize((size_t)size);
+    memcpy(frame.pixels.data(), target.readback.mapped, (size_t)size);
+    writer->push(std::move(frame));
+}
+
+static void record_readback(VSDL_Context& ctx, VkCommandBuffer commandBuffer, VSDL_OffscreenTarget& target) {
+    // The render pass leaves the image in TRANSFER_SRC_OPTIMAL; make the color writes visible to the copy
+    VkImageMemoryBarrier toTransfer = {};
+    toTransfer.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    toTransfer.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    toTransfer.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    toTransfer.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    toTransfer.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    toTransfer.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toTransfer.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toTransfer.image = target.image.image;
+    toTransfer.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    toTransfer.subresourceRange.levelCount = 1;
+    toTransfer.subresourceRange.layerCount = 1;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         0, 0, nullptr, 0, nullptr, 1, &toTransfer);
+
+    VkBufferImageCopy region = {};
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.layerCount = 1;
+    region.imageExtent = { ctx.swapchainExtent.width, ctx.swapchainExtent.height, 1 };
+    vkCmdCopyImageToBuffer(commandBuffer, target.image.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, target.readback.buffer, 1, &region);
+
+    VkBufferMemoryBarrier toHost = {};
+    toHost.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    toHost.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    toHost.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    toHost.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toHost.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toHost.buffer = target.readback.buffer;
+    toHost.size = VK_WHOLE_SIZE;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+                         0, 0, nullptr, 1, &toHost, 0, nullptr);
+}
+
+void vsdl_headless_loop(VSDL_Context& ctx) {
+    if (!ctx.frames[0].commandBuffer) vsdl_create_frames(ctx);
+
+    const VSDL_HeadlessConfig& config = ctx.headlessConfig;
+    std::unique_ptr<FrameWriter> writer;
+    if (!config.outputDir.empty()) {
+        std::error_code error;
+        std::filesystem::create_directories(config.outputDir, error);
+        if (error) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create output directory %s", config.outputDir.c_str());
+            throw std::runtime_error("Output directory creation failed");
+        }
+        writer = std::make_unique<FrameWriter>(config.outputDir, ctx.swapchainExtent.width, ctx.swapchainExtent.height);
+    }
+
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+    const Uint64 start = SDL_GetPerformanceCounter();
+
+    for (uint32_t frameIndex = 0; frameIndex < config.frameCount; frameIndex++) {
+        // Pace to the target throughput instead of rendering as fast as possible
+        if (config.targetFps > 0.0f) {
+            Uint64 due = start + (Uint64)((double)frameIndex * (double)frequency / config.targetFps);
+            Uint64 now = SDL_GetPerformanceCounter();
+            if (due > now) SDL_DelayNS((Uint64)((double)(due - now) * 1e9 / (double)frequency));
+        }
+
+        SDL_Event event;
+        while (SDL_PollEvent(&event)) {
+            vsdl::imgui_new_frame(ctx, event);
+        }
+
+        VSDL_Frame& frame = ctx.frames[ctx.currentFrame];
+        VSDL_OffscreenTarget& target = ctx.offscreenTargets[ctx.currentFrame];
+
+        // The slot's previous frame has finished, so its readback is complete: no GPU stall here
+        vsdl_timeline_wait(ctx, VSDL_QueueKind::Graphics, frame.timelineValue);
+        consume_readback(ctx, target, writer.get());
+        vsdl_profiler_resolve(ctx, ctx.currentFrame);
+        vsdl_shader_reload_apply(ctx);
+        vsdl_descriptors_begin_frame(ctx);
+        vsdl_frame_arena_begin(ctx);
+        vsdl_stream_update(ctx);
+        vsdl_particles_simulate(ctx);
+
+        vsdl_build_ui(ctx);
+
+        VkCommandBuffer commandBuffer = frame.commandBuffer;
+        vkResetCommandBuffer(commandBuffer, 0);
+        VkCommandBufferBeginInfo beginInfo = {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to begin command buffer");
+            throw std::runtime_error("Command buffer begin failed");
+        }
+
+        vsdl_record_frame(ctx, commandBuffer, ctx.currentFrame);
+        record_readback(ctx, commandBuffer, target);
+
+        if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to end command buffer");
+            throw std::runtime_error("Command buffer end failed");
+        }
+
+        std::vector<VSDL_QueueWait> waits = vsdl_flush_uploads(ctx);
+        vsdl_particles_graphics_waits(ctx, waits);
+        frame.timelineValue = vsdl_queue_submit(ctx, VSDL_QueueKind::Graphics, commandBuffer, waits);
+        target.pending = true;
+        target.frameIndex = frameIndex;
+
+        ctx.currentFrame = (ctx.currentFrame + 1) % ctx.framesInFlight;
+    }
+
+    // Drain the ring in submission order so the last frames are dumped too
+    for (uint32_t i = 0; i < ctx.framesInFlight; i++) {
+        VSDL_Frame& frame = ctx.frames[ctx.currentFrame];
+        vsdl_timeline_wait(ctx, VSDL_QueueKind::Graphics, frame.timelineValue);
+        consume_readback(ctx, ctx.offscreenTargets[ctx.currentFrame], writer.get());
+        ctx.currentFrame = (ctx.currentFrame + 1) % ctx.framesInFlight;
+    }
+    writer.reset(); // Joins the writer thread once the queue is flushed
+
+    double seconds = (double)(SDL_GetPerformanceCounter() - start) / (double)frequency;
+    double frameBytes = (double)ctx.swapchainExtent.width * ctx.swapchainExtent.height * 4;
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Headless: %u frames in %.3f s (%.1f FPS, %.1f MB/s readback)%s",
+                config.frameCount, seconds, config.frameCount / seconds,
+                config.frameCount * frameBytes / seconds / (1024.0 * 1024.0),
+                config.outputDir.empty() ? "" : ", frames written to output directory");
+}
\ No newline at end of file
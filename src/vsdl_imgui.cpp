@@ -1,8 +1,13 @@
 #include "vsdl_imgui.h"
+#include "vsdl_texture_stream.h"
+#include "vsdl_ui_cache.h"
 #include <SDL3/SDL_log.h>
 #include "imgui.h"
 #include "imgui_impl_sdl3.h"
 #include "imgui_impl_vulkan.h"
+#include <algorithm>
+
+#define VSDL_IMGUI_MAX_TEXTURES 16
 
 namespace vsdl {
     bool init_imgui(VSDL_Context& ctx) {
@@ -17,24 +22,15 @@ namespace vsdl {
             return false;
         }
 
-        // Create descriptor pool for ImGui
+        // The Vulkan backend only allocates one combined image sampler set per texture (the font atlas
+        // plus any user textures shown in the UI), so the pool is sized for that and nothing else
         VkDescriptorPoolSize poolSizes[] = {
-            { VK_DESCRIPTOR_TYPE_SAMPLER, 1000 },
-            { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1000 },
-            { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1000 },
-            { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1000 },
-            { VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, 1000 },
-            { VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER, 1000 },
-            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1000 },
-            { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1000 },
-            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1000 },
-            { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1000 },
-            { VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 1000 }
+            { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VSDL_IMGUI_MAX_TEXTURES }
         };
         VkDescriptorPoolCreateInfo poolInfo = {};
         poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
         poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
-        poolInfo.maxSets = 1000 * IM_ARRAYSIZE(poolSizes);
+        poolInfo.maxSets = VSDL_IMGUI_MAX_TEXTURES;
         poolInfo.poolSizeCount = (uint32_t)IM_ARRAYSIZE(poolSizes);
         poolInfo.pPoolSizes = poolSizes;
 
@@ -50,12 +46,20 @@ namespace vsdl {
         initInfo.Device = ctx.device;
         initInfo.QueueFamily = ctx.graphicsQueueFamilyIndex; // Use the stored index
         initInfo.Queue = ctx.graphicsQueue;
-        initInfo.PipelineCache = VK_NULL_HANDLE;
+        initInfo.PipelineCache = ctx.pipelineCache;
         initInfo.DescriptorPool = ctx.imguiDescriptorPool;
         initInfo.RenderPass = ctx.renderPass;
+        if (ctx.dynamicRendering.enabled) {
+            initInfo.UseDynamicRendering = true;
+            initInfo.PipelineRenderingCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+            initInfo.PipelineRenderingCreateInfo.colorAttachmentCount = 1;
+            initInfo.PipelineRenderingCreateInfo.pColorAttachmentFormats = &ctx.swapchainImageFormat;
+            initInfo.PipelineRenderingCreateInfo.depthAttachmentFormat = ctx.depthFormat;
+        }
         initInfo.Allocator = nullptr;
-        initInfo.MinImageCount = 2;
-        initInfo.ImageCount = static_cast<uint32_t>(ctx.swapchainImages.size());
+        initInfo.MinImageCount = ctx.swapchainMinImageCount;
+        // ImGui rotates its vertex buffers over ImageCount frames; never fewer than our frames in flight
+        initInfo.ImageCount = std::max(static_cast<uint32_t>(ctx.swapchainImages.size()), (uint32_t)VSDL_MAX_FRAMES_IN_FLIGHT);
         initInfo.CheckVkResultFn = nullptr;
 
         if (!ImGui_ImplVulkan_Init(&initInfo)) {
@@ -63,43 +67,20 @@ namespace vsdl {
             return false;
         }
 
-        // Upload fonts
-        VkCommandPoolCreateInfo tempPoolInfo = {};
-        tempPoolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-        tempPoolInfo.queueFamilyIndex = ctx.graphicsQueueFamilyIndex; // Use the stored index
-        tempPoolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
-        VkCommandPool tempCommandPool;
-        if (vkCreateCommandPool(ctx.device, &tempPoolInfo, nullptr, &tempCommandPool) != VK_SUCCESS) {
-            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create temporary command pool for ImGui");
+        // Upload fonts through the texture streamer: the CPU only waits on the transfer queue, and the
+        // backend's own path (a vkQueueWaitIdle on graphics) is never taken since its NewFrame isn't called
+        ImGuiIO& io = ImGui::GetIO();
+        unsigned char* pixels = nullptr;
+        int width = 0, height = 0;
+        io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+        ctx.fontTexture = vsdl_stream_texture_pixels(ctx, "imgui_font", std::vector<uint8_t>(pixels, pixels + (size_t)width * height * 4),
+                                                     (uint32_t)width, (uint32_t)height, false);
+        if (!vsdl_stream_wait(ctx, ctx.fontTexture)) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to upload ImGui font texture");
             return false;
         }
-
-        VkCommandBufferAllocateInfo allocInfo = {};
-        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-        allocInfo.commandPool = tempCommandPool;
-        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-        allocInfo.commandBufferCount = 1;
-        VkCommandBuffer fontCmdBuffer;
-        vkAllocateCommandBuffers(ctx.device, &allocInfo, &fontCmdBuffer);
-
-        VkCommandBufferBeginInfo beginInfo = {};
-        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-        vkBeginCommandBuffer(fontCmdBuffer, &beginInfo);
-
-        ImGui_ImplVulkan_CreateFontsTexture();
-
-        vkEndCommandBuffer(fontCmdBuffer);
-
-        VkSubmitInfo submitInfo = {};
-        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = &fontCmdBuffer;
-        vkQueueSubmit(ctx.graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-        vkQueueWaitIdle(ctx.graphicsQueue);
-
-        vkFreeCommandBuffers(ctx.device, tempCommandPool, 1, &fontCmdBuffer);
-        vkDestroyCommandPool(ctx.device, tempCommandPool, nullptr);
+        const VSDL_Texture& font = vsdl_get_texture(ctx, ctx.fontTexture);
+        io.Fonts->SetTexID((ImTextureID)ImGui_ImplVulkan_AddTexture(font.sampler, font.view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL));
 
         SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "ImGui initialized successfully");
         return true;
@@ -109,9 +90,19 @@ namespace vsdl {
         ImGui_ImplSDL3_ProcessEvent(&event); // Only process events here
     }
 
-    void imgui_render(VSDL_Context& ctx, VkCommandBuffer commandBuffer) {
+    void imgui_prepare(VSDL_Context& ctx) {
+        // The threaded loop hands over a finished snapshot, the ImGui context belongs to the simulation thread
+        if (ctx.uiDrawData) {
+            vsdl_ui_begin_frame(ctx, ctx.uiDrawData);
+            return;
+        }
         ImGui::Render();
-        ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), commandBuffer);
+        vsdl_ui_begin_frame(ctx, ImGui::GetDrawData());
+    }
+
+    void imgui_render(VSDL_Context& ctx, VkCommandBuffer commandBuffer) {
+        if (vsdl_record_ui(ctx, commandBuffer)) return;
+        ImGui_ImplVulkan_RenderDrawData(ctx.ui.drawData, commandBuffer);
     }
 
     void shutdown_imgui(VSDL_Context& ctx) {
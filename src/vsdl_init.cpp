@@ -1,5 +1,17 @@
 #include "vsdl_init.h"
+#include "vsdl_device.h"
+#include "vsdl_swapchain.h"
+#include "vsdl_headless.h"
+#include "vsdl_pipeline_cache.h"
+#include "vsdl_memory.h"
+#include "vsdl_upload.h"
+#include "vsdl_frame_arena.h"
+#include "vsdl_profiler.h"
+#include "vsdl_descriptors.h"
+#include "vsdl_texture_stream.h"
+#include "vsdl_sync.h"
 #include <SDL3/SDL_log.h>
+#include <cstring>
 #include <stdexcept>
 
 // Debug callback function for validation layers
@@ -15,12 +27,21 @@ static VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(
 #endif
 
 bool vsdl_init(VSDL_Context& ctx) {
+    if (ctx.headless) {
+        // No display needed: the dummy driver still gives ImGui's SDL backend a window to query
+        SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "dummy");
+    }
+
     if (!SDL_Init(SDL_INIT_VIDEO)) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "SDL_Init failed: %s", SDL_GetError());
         return false;
     }
 
-    ctx.window = SDL_CreateWindow("Vulkan Triangle", 800, 600, SDL_WINDOW_VULKAN);
+    if (ctx.headless) {
+        ctx.window = SDL_CreateWindow("Vulkan Triangle (headless)", (int)ctx.headlessConfig.width, (int)ctx.headlessConfig.height, SDL_WINDOW_HIDDEN);
+    } else {
+        ctx.window = SDL_CreateWindow("Vulkan Triangle", 800, 600, SDL_WINDOW_VULKAN | SDL_WINDOW_RESIZABLE);
+    }
     if (!ctx.window) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Window creation failed: %s", SDL_GetError());
         return false;
@@ -55,10 +76,28 @@ bool vsdl_init(VSDL_Context& ctx) {
     bool layersAvailable = false;
 #endif
 
+    // Headless mode needs no surface extensions
     Uint32 extensionCount = 0;
-    if (!SDL_Vulkan_GetInstanceExtensions(&extensionCount)) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to get extension count: %s", SDL_GetError());
-        return false;
+    const char* const* sdlExtensions = nullptr;
+    if (!ctx.headless) {
+        sdlExtensions = SDL_Vulkan_GetInstanceExtensions(&extensionCount);
+        if (!sdlExtensions) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to get extension count: %s", SDL_GetError());
+            return false;
+        }
+    }
+
+    // Dynamic rendering needs a 1.3 instance; vkEnumerateInstanceVersion itself is missing from 1.0 loaders
+    if (ctx.requestDynamicRendering) {
+        auto enumerateInstanceVersion = (PFN_vkEnumerateInstanceVersion)vkGetInstanceProcAddr(nullptr, "vkEnumerateInstanceVersion");
+        uint32_t loaderVersion = VK_API_VERSION_1_0;
+        if (enumerateInstanceVersion) enumerateInstanceVersion(&loaderVersion);
+        if (loaderVersion >= VK_API_VERSION_1_3) {
+            ctx.apiVersion = VK_API_VERSION_1_3;
+        } else {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Vulkan loader %u.%u has no 1.3 support, using render passes",
+                        VK_API_VERSION_MAJOR(loaderVersion), VK_API_VERSION_MINOR(loaderVersion));
+        }
     }
 
     VkApplicationInfo appInfo = {};
@@ -67,15 +106,27 @@ bool vsdl_init(VSDL_Context& ctx) {
     appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
     appInfo.pEngineName = "No Engine";
     appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-    appInfo.apiVersion = VK_API_VERSION_1_0;
+    appInfo.apiVersion = ctx.apiVersion;
 
     VkInstanceCreateInfo createInfo = {};
     createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
     createInfo.pApplicationInfo = &appInfo;
-    createInfo.enabledExtensionCount = extensionCount;
-    createInfo.ppEnabledExtensionNames = SDL_Vulkan_GetInstanceExtensions(&extensionCount);
 
-    std::vector<const char*> extensions(createInfo.ppEnabledExtensionNames, createInfo.ppEnabledExtensionNames + extensionCount);
+    std::vector<const char*> extensions(sdlExtensions, sdlExtensions + extensionCount);
+
+    // VK_EXT_memory_budget on a 1.0 instance needs physical_device_properties2
+    uint32_t availableExtensionCount = 0;
+    vkEnumerateInstanceExtensionProperties(nullptr, &availableExtensionCount, nullptr);
+    std::vector<VkExtensionProperties> availableExtensions(availableExtensionCount);
+    vkEnumerateInstanceExtensionProperties(nullptr, &availableExtensionCount, availableExtensions.data());
+    bool hasProperties2 = false;
+    for (const auto& extension : availableExtensions) {
+        if (strcmp(extension.extensionName, VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME) == 0) {
+            extensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+            hasProperties2 = true;
+            break;
+        }
+    }
 #if VSDL_ENABLE_VALIDATION_LAYERS
     if (layersAvailable) {
         extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
@@ -96,7 +147,7 @@ bool vsdl_init(VSDL_Context& ctx) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create Vulkan instance");
         return false;
     }
-    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Vulkan instance created with %u extensions", extensionCount);
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Vulkan instance created with %u extensions", (uint32_t)extensions.size());
 
 #if VSDL_ENABLE_VALIDATION_LAYERS
     if (layersAvailable) {
@@ -120,20 +171,29 @@ bool vsdl_init(VSDL_Context& ctx) {
     }
 #endif
 
-    if (!SDL_Vulkan_CreateSurface(ctx.window, ctx.instance, nullptr, &ctx.surface)) {
+    if (!ctx.headless && !SDL_Vulkan_CreateSurface(ctx.window, ctx.instance, nullptr, &ctx.surface)) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create Vulkan surface: %s", SDL_GetError());
         return false;
     }
 
-    uint32_t deviceCount = 0;
-    vkEnumeratePhysicalDevices(ctx.instance, &deviceCount, nullptr);
-    if (deviceCount == 0) {
+    std::vector<VkPhysicalDevice> devices;
+    std::vector<VSDL_DeviceCandidate> candidates = vsdl_query_devices(ctx, devices);
+    if (devices.empty()) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "No Vulkan-capable devices found");
         return false;
     }
-    std::vector<VkPhysicalDevice> devices(deviceCount);
-    vkEnumeratePhysicalDevices(ctx.instance, &deviceCount, devices.data());
-    ctx.physicalDevice = devices[0];
+    // --device wins over the VSDL_DEVICE environment variable
+    std::string deviceOverride = ctx.deviceOverride;
+    const char* environmentOverride = SDL_getenv("VSDL_DEVICE");
+    if (deviceOverride.empty() && environmentOverride) deviceOverride = environmentOverride;
+    std::string selectionReport;
+    int selectedDevice = vsdl_select_device(candidates, ctx.headless, deviceOverride, &selectionReport);
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Device selection:\n%s", selectionReport.c_str());
+    if (selectedDevice < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "No Vulkan device can run this renderer");
+        return false;
+    }
+    ctx.physicalDevice = devices[selectedDevice];
 
     uint32_t queueFamilyCount = 0;
     vkGetPhysicalDeviceQueueFamilyProperties(ctx.physicalDevice, &queueFamilyCount, nullptr);
@@ -147,7 +207,11 @@ bool vsdl_init(VSDL_Context& ctx) {
             graphicsFamily = i;
         }
         VkBool32 presentSupport = false;
-        vkGetPhysicalDeviceSurfaceSupportKHR(ctx.physicalDevice, i, ctx.surface, &presentSupport);
+        if (ctx.headless) {
+            presentSupport = (queueFamilies[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0; // Nothing is presented
+        } else {
+            vkGetPhysicalDeviceSurfaceSupportKHR(ctx.physicalDevice, i, ctx.surface, &presentSupport);
+        }
         if (presentSupport) {
             presentFamily = i;
         }
@@ -161,6 +225,28 @@ bool vsdl_init(VSDL_Context& ctx) {
 
     ctx.graphicsQueueFamilyIndex = graphicsFamily;
 
+    // Prefer a transfer-only family (DMA engine) so uploads overlap rendering
+    uint32_t transferFamily = graphicsFamily;
+    for (uint32_t i = 0; i < queueFamilyCount; i++) {
+        VkQueueFlags flags = queueFamilies[i].queueFlags;
+        if ((flags & VK_QUEUE_TRANSFER_BIT) && !(flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT))) {
+            transferFamily = i;
+            break;
+        }
+    }
+    ctx.transferQueueFamilyIndex = transferFamily;
+
+    // A compute family without graphics is an async compute engine that runs beside the graphics queue
+    uint32_t computeFamily = graphicsFamily;
+    for (uint32_t i = 0; i < queueFamilyCount; i++) {
+        VkQueueFlags flags = queueFamilies[i].queueFlags;
+        if ((flags & VK_QUEUE_COMPUTE_BIT) && !(flags & VK_QUEUE_GRAPHICS_BIT)) {
+            computeFamily = i;
+            break;
+        }
+    }
+    ctx.computeQueueFamilyIndex = computeFamily;
+
     std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
     float queuePriority = 1.0f;
     VkDeviceQueueCreateInfo queueCreateInfo = {};
@@ -173,6 +259,14 @@ bool vsdl_init(VSDL_Context& ctx) {
         queueCreateInfo.queueFamilyIndex = presentFamily;
         queueCreateInfos.push_back(queueCreateInfo);
     }
+    if (transferFamily != graphicsFamily && transferFamily != presentFamily) {
+        queueCreateInfo.queueFamilyIndex = transferFamily;
+        queueCreateInfos.push_back(queueCreateInfo);
+    }
+    if (computeFamily != graphicsFamily && computeFamily != presentFamily && computeFamily != transferFamily) {
+        queueCreateInfo.queueFamilyIndex = computeFamily;
+        queueCreateInfos.push_back(queueCreateInfo);
+    }
 
     VkPhysicalDeviceFeatures deviceFeatures = {};
     VkDeviceCreateInfo deviceCreateInfo = {};
@@ -180,9 +274,101 @@ bool vsdl_init(VSDL_Context& ctx) {
     deviceCreateInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
     deviceCreateInfo.pQueueCreateInfos = queueCreateInfos.data();
     deviceCreateInfo.pEnabledFeatures = &deviceFeatures;
-    deviceCreateInfo.enabledExtensionCount = 1;
-    const char* deviceExtensions[] = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
-    deviceCreateInfo.ppEnabledExtensionNames = deviceExtensions;
+    std::vector<const char*> deviceExtensions;
+    if (!ctx.headless) {
+        deviceExtensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+    }
+
+    uint32_t deviceExtensionCount = 0;
+    vkEnumerateDeviceExtensionProperties(ctx.physicalDevice, nullptr, &deviceExtensionCount, nullptr);
+    std::vector<VkExtensionProperties> availableDeviceExtensions(deviceExtensionCount);
+    vkEnumerateDeviceExtensionProperties(ctx.physicalDevice, nullptr, &deviceExtensionCount, availableDeviceExtensions.data());
+    bool hasDescriptorIndexing = false;
+    bool hasMaintenance3 = false;
+    bool hasTimelineSemaphore = false;
+    for (const auto& extension : availableDeviceExtensions) {
+        if (hasProperties2 && strcmp(extension.extensionName, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) == 0) {
+            deviceExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+            ctx.memoryBudgetSupported = true;
+        }
+        if (strcmp(extension.extensionName, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME) == 0) hasDescriptorIndexing = true;
+        if (strcmp(extension.extensionName, VK_KHR_MAINTENANCE_3_EXTENSION_NAME) == 0) hasMaintenance3 = true;
+        if (strcmp(extension.extensionName, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME) == 0) hasTimelineSemaphore = true;
+    }
+    // Opt-in 1.3 path: both features are required, otherwise keep the VkRenderPass path
+    VkPhysicalDeviceVulkan13Features enabledFeatures13 = {};
+    enabledFeatures13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+    if (ctx.apiVersion >= VK_API_VERSION_1_3) {
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(ctx.physicalDevice, &properties);
+        VkPhysicalDeviceVulkan13Features features13 = {};
+        features13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+        VkPhysicalDeviceFeatures2 features2 = {};
+        features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features2.pNext = &features13;
+        auto getFeatures2 = (PFN_vkGetPhysicalDeviceFeatures2)vkGetInstanceProcAddr(ctx.instance, "vkGetPhysicalDeviceFeatures2");
+        if (properties.apiVersion >= VK_API_VERSION_1_3 && getFeatures2) getFeatures2(ctx.physicalDevice, &features2);
+        if (features13.dynamicRendering && features13.synchronization2) {
+            enabledFeatures13.dynamicRendering = VK_TRUE;
+            enabledFeatures13.synchronization2 = VK_TRUE;
+            deviceCreateInfo.pNext = &enabledFeatures13;
+        } else {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Device lacks Vulkan 1.3 dynamic rendering/synchronization2, using render passes");
+        }
+    }
+
+    // Bindless table: descriptor indexing with update-after-bind, core in 1.2 and an extension before
+    VkPhysicalDeviceDescriptorIndexingFeatures enabledIndexing = {};
+    enabledIndexing.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+    auto getFeatures2 = (PFN_vkGetPhysicalDeviceFeatures2)vkGetInstanceProcAddr(ctx.instance,
+        ctx.apiVersion >= VK_API_VERSION_1_1 ? "vkGetPhysicalDeviceFeatures2" : "vkGetPhysicalDeviceFeatures2KHR");
+    if (hasDescriptorIndexing && hasMaintenance3 && (hasProperties2 || ctx.apiVersion >= VK_API_VERSION_1_1) && getFeatures2) {
+        VkPhysicalDeviceDescriptorIndexingFeatures indexing = {};
+        indexing.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+        VkPhysicalDeviceFeatures2 features2 = {};
+        features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features2.pNext = &indexing;
+        getFeatures2(ctx.physicalDevice, &features2);
+        if (indexing.runtimeDescriptorArray && indexing.descriptorBindingPartiallyBound &&
+            indexing.descriptorBindingUpdateUnusedWhilePending && indexing.shaderSampledImageArrayNonUniformIndexing &&
+            indexing.descriptorBindingSampledImageUpdateAfterBind && indexing.descriptorBindingStorageBufferUpdateAfterBind) {
+            enabledIndexing.runtimeDescriptorArray = VK_TRUE;
+            enabledIndexing.descriptorBindingPartiallyBound = VK_TRUE;
+            enabledIndexing.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+            enabledIndexing.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+            enabledIndexing.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+            enabledIndexing.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+            enabledIndexing.pNext = (void*)deviceCreateInfo.pNext;
+            deviceCreateInfo.pNext = &enabledIndexing;
+            deviceExtensions.push_back(VK_KHR_MAINTENANCE_3_EXTENSION_NAME);
+            deviceExtensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+            ctx.descriptors.bindless = true;
+        }
+    }
+
+    // Timeline semaphores: core in 1.2, VK_KHR_timeline_semaphore before; without them vsdl_sync uses fences
+    VkPhysicalDeviceTimelineSemaphoreFeatures enabledTimeline = {};
+    enabledTimeline.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+    VkPhysicalDeviceProperties deviceProperties;
+    vkGetPhysicalDeviceProperties(ctx.physicalDevice, &deviceProperties);
+    bool timelineCore = ctx.apiVersion >= VK_API_VERSION_1_2 && deviceProperties.apiVersion >= VK_API_VERSION_1_2;
+    if (ctx.requestTimeline && (timelineCore || (hasTimelineSemaphore && hasProperties2)) && getFeatures2) {
+        VkPhysicalDeviceTimelineSemaphoreFeatures timeline = {};
+        timeline.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+        VkPhysicalDeviceFeatures2 features2 = {};
+        features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features2.pNext = &timeline;
+        getFeatures2(ctx.physicalDevice, &features2);
+        if (timeline.timelineSemaphore) {
+            enabledTimeline.timelineSemaphore = VK_TRUE;
+            enabledTimeline.pNext = (void*)deviceCreateInfo.pNext;
+            deviceCreateInfo.pNext = &enabledTimeline;
+            if (!timelineCore) deviceExtensions.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+            ctx.sync.timeline = true;
+        }
+    }
+    deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
+    deviceCreateInfo.ppEnabledExtensionNames = deviceExtensions.data();
 
     if (vkCreateDevice(ctx.physicalDevice, &deviceCreateInfo, nullptr, &ctx.device) != VK_SUCCESS) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create logical device");
@@ -191,64 +377,62 @@ bool vsdl_init(VSDL_Context& ctx) {
 
     vkGetDeviceQueue(ctx.device, graphicsFamily, 0, &ctx.graphicsQueue);
     vkGetDeviceQueue(ctx.device, presentFamily, 0, &ctx.presentQueue);
+    vkGetDeviceQueue(ctx.device, transferFamily, 0, &ctx.transferQueue);
+    vkGetDeviceQueue(ctx.device, computeFamily, 0, &ctx.computeQueue);
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Queue families: graphics %u, present %u, transfer %u, compute %u%s", graphicsFamily,
+                presentFamily, transferFamily, computeFamily, computeFamily != graphicsFamily ? " (async)" : "");
 
-    VkSurfaceCapabilitiesKHR capabilities;
-    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(ctx.physicalDevice, ctx.surface, &capabilities);
-
-    uint32_t formatCount;
-    vkGetPhysicalDeviceSurfaceFormatsKHR(ctx.physicalDevice, ctx.surface, &formatCount, nullptr);
-    std::vector<VkSurfaceFormatKHR> formats(formatCount);
-    vkGetPhysicalDeviceSurfaceFormatsKHR(ctx.physicalDevice, ctx.surface, &formatCount, formats.data());
-    ctx.swapchainImageFormat = formats[0].format;
-
-    VkSwapchainCreateInfoKHR swapchainInfo = {};
-    swapchainInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
-    swapchainInfo.surface = ctx.surface;
-    swapchainInfo.minImageCount = 2;
-    swapchainInfo.imageFormat = ctx.swapchainImageFormat;
-    swapchainInfo.imageColorSpace = formats[0].colorSpace;
-    swapchainInfo.imageExtent = capabilities.currentExtent;
-    swapchainInfo.imageArrayLayers = 1;
-    swapchainInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
-    swapchainInfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
-    swapchainInfo.preTransform = capabilities.currentTransform;
-    swapchainInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
-    swapchainInfo.presentMode = VK_PRESENT_MODE_FIFO_KHR;
-    swapchainInfo.clipped = VK_TRUE;
-
-    if (vkCreateSwapchainKHR(ctx.device, &swapchainInfo, nullptr, &ctx.swapchain) != VK_SUCCESS) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create swapchain");
+    if (ctx.sync.timeline) {
+        ctx.sync.waitSemaphores = (PFN_vkWaitSemaphores)vkGetDeviceProcAddr(ctx.device, timelineCore ? "vkWaitSemaphores" : "vkWaitSemaphoresKHR");
+        ctx.sync.getSemaphoreCounterValue = (PFN_vkGetSemaphoreCounterValue)vkGetDeviceProcAddr(ctx.device,
+            timelineCore ? "vkGetSemaphoreCounterValue" : "vkGetSemaphoreCounterValueKHR");
+        ctx.sync.timeline = ctx.sync.waitSemaphores && ctx.sync.getSemaphoreCounterValue;
+    }
+    if (!vsdl_create_sync(ctx)) {
         return false;
     }
 
-    ctx.swapchainExtent = capabilities.currentExtent;
-    uint32_t imageCount;
-    vkGetSwapchainImagesKHR(ctx.device, ctx.swapchain, &imageCount, nullptr);
-    ctx.swapchainImages.resize(imageCount);
-    vkGetSwapchainImagesKHR(ctx.device, ctx.swapchain, &imageCount, ctx.swapchainImages.data());
-
-    ctx.swapchainImageViews.resize(imageCount);
-    for (size_t i = 0; i < imageCount; i++) {
-        VkImageViewCreateInfo viewInfo = {};
-        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-        viewInfo.image = ctx.swapchainImages[i];
-        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-        viewInfo.format = ctx.swapchainImageFormat;
-        viewInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
-        viewInfo.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
-        viewInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
-        viewInfo.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
-        viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        viewInfo.subresourceRange.baseMipLevel = 0;
-        viewInfo.subresourceRange.levelCount = 1;
-        viewInfo.subresourceRange.baseArrayLayer = 0;
-        viewInfo.subresourceRange.layerCount = 1;
-
-        if (vkCreateImageView(ctx.device, &viewInfo, nullptr, &ctx.swapchainImageViews[i]) != VK_SUCCESS) {
-            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create image view %zu", i);
+    if (enabledFeatures13.dynamicRendering) {
+        VSDL_DynamicRendering& dynamic = ctx.dynamicRendering;
+        dynamic.cmdBeginRendering = (PFN_vkCmdBeginRendering)vkGetDeviceProcAddr(ctx.device, "vkCmdBeginRendering");
+        dynamic.cmdEndRendering = (PFN_vkCmdEndRendering)vkGetDeviceProcAddr(ctx.device, "vkCmdEndRendering");
+        dynamic.cmdPipelineBarrier2 = (PFN_vkCmdPipelineBarrier2)vkGetDeviceProcAddr(ctx.device, "vkCmdPipelineBarrier2");
+        dynamic.enabled = dynamic.cmdBeginRendering && dynamic.cmdEndRendering && dynamic.cmdPipelineBarrier2;
+    }
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Rendering path: %s",
+                ctx.dynamicRendering.enabled ? "dynamic rendering + synchronization2 (Vulkan 1.3)" : "VkRenderPass (Vulkan 1.0)");
+
+    if (!vsdl_create_allocator(ctx)) {
+        return false;
+    }
+    if (!vsdl_create_descriptors(ctx)) {
+        return false;
+    }
+    if (!vsdl_create_upload_queue(ctx)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create upload queue");
+        return false;
+    }
+    if (!vsdl_create_texture_streamer(ctx)) {
+        return false;
+    }
+    if (!vsdl_create_frame_arena(ctx)) {
+        return false;
+    }
+
+    if (ctx.headless) {
+        if (!vsdl_create_offscreen_targets(ctx)) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create offscreen targets");
             return false;
         }
+    } else if (!vsdl_create_swapchain(ctx)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create swapchain");
+        return false;
+    }
+
+    if (!vsdl_create_pipeline_cache(ctx)) {
+        return false;
     }
+    vsdl_create_profiler(ctx);
 
     return true;
 }
\ No newline at end of file
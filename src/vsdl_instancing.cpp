@@ -0,0 +1,333 @@
+#include "vsdl_instancing.h"
+#include "vsdl_depth_pyramid.h"
+#include "vsdl_frame_arena.h"
+#include "vsdl_memory.h"
+#include "vsdl_mesh.h"
+#include "vsdl_pipeline.h"
+#include "vsdl_profiler.h"
+#include "vsdl_renderer.h"
+#include "vsdl_shader_reload.h"
+#include "vsdl_upload.h"
+#include "vsdl_imgui.h"
+#include <SDL3/SDL_log.h>
+#include <SDL3/SDL_timer.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#define VSDL_CULL_GROUP_SIZE 64
+
+// Matches the Cull uniform (std140) of cull.comp; instanced.vert reads only the matrix
+struct VSDL_CullParams {
+    glm::mat4 viewProjection;
+    glm::mat4 occlusionViewProjection; // Camera the depth pyramid was built with
+    glm::vec4 frustumPlanes[6]; // xyz normal (unit length or zero), w distance; inside is >= 0
+    glm::vec2 depthSize; // Depth buffer the pyramid was reduced from, in pixels
+    uint32_t pyramidLevels;
+    uint32_t occlusion; // 0 skips the pyramid test
+    uint32_t instanceCount;
+    uint32_t padding[3];
+};
+
+// Gribb-Hartmann planes: the w row plus or minus the x, y and z rows. With reverse-Z the near plane is
+// z <= w and the far plane z >= 0; the infinite projection leaves the far plane degenerate (never culls).
+static void extract_frustum_planes(const glm::mat4& viewProjection, glm::vec4* planes) {
+    glm::mat4 rows = glm::transpose(viewProjection);
+    planes[0] = rows[3] + rows[0];
+    planes[1] = rows[3] - rows[0];
+    planes[2] = rows[3] + rows[1];
+    planes[3] = rows[3] - rows[1];
+    planes[4] = rows[3] - rows[2];
+    planes[5] = rows[2];
+    for (uint32_t i = 0; i < 6; i++) {
+        float length = glm::length(glm::vec3(planes[i]));
+        planes[i] = length > 1e-6f ? planes[i] / length : glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+}
+
+void vsdl_create_instancing(VSDL_Context& ctx) {
+    VSDL_Instancing& inst = ctx.instancing;
+
+    // 0: instances, 1: visible indices, 2: indirect command and counters, 3: depth pyramid
+    VkDescriptorSetLayoutBinding bindings[4] = {};
+    for (uint32_t i = 0; i < 4; i++) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = i < 3 ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER : VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT | (i < 2 ? VK_SHADER_STAGE_VERTEX_BIT : 0);
+    }
+    VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = 4;
+    layoutInfo.pBindings = bindings;
+    if (vkCreateDescriptorSetLayout(ctx.device, &layoutInfo, nullptr, &inst.setLayout) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create instancing descriptor set layout");
+        throw std::runtime_error("Descriptor set layout creation failed");
+    }
+
+    // Set 1 is the frame arena, holding this frame's VSDL_CullParams for both the cull and draw pipelines
+    VkDescriptorSetLayout pipelineSetLayouts[2] = { inst.setLayout, ctx.frameArena.setLayout };
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 2;
+    pipelineLayoutInfo.pSetLayouts = pipelineSetLayouts;
+    if (vkCreatePipelineLayout(ctx.device, &pipelineLayoutInfo, nullptr, &inst.pipelineLayout) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create instancing pipeline layout");
+        throw std::runtime_error("Pipeline layout creation failed");
+    }
+
+    VkDescriptorPoolSize poolSizes[2] = {};
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSizes[0].descriptorCount = 3 * VSDL_MAX_FRAMES_IN_FLIGHT;
+    poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSizes[1].descriptorCount = VSDL_MAX_FRAMES_IN_FLIGHT;
+    VkDescriptorPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = VSDL_MAX_FRAMES_IN_FLIGHT;
+    poolInfo.poolSizeCount = 2;
+    poolInfo.pPoolSizes = poolSizes;
+    if (vkCreateDescriptorPool(ctx.device, &poolInfo, nullptr, &inst.descriptorPool) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create instancing descriptor pool");
+        throw std::runtime_error("Descriptor pool creation failed");
+    }
+
+    VkDescriptorSetLayout setLayouts[VSDL_MAX_FRAMES_IN_FLIGHT];
+    std::fill(setLayouts, setLayouts + VSDL_MAX_FRAMES_IN_FLIGHT, inst.setLayout);
+    VkDescriptorSetAllocateInfo allocInfo = {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = inst.descriptorPool;
+    allocInfo.descriptorSetCount = VSDL_MAX_FRAMES_IN_FLIGHT;
+    allocInfo.pSetLayouts = setLayouts;
+    if (vkAllocateDescriptorSets(ctx.device, &allocInfo, inst.descriptorSets) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate instancing descriptor sets");
+        throw std::runtime_error("Descriptor set allocation failed");
+    }
+
+    vsdl_create_depth_pyramid(ctx);
+    inst.cullPipeline = vsdl_build_compute_pipeline(ctx, "shaders/cull.comp.spv", inst.pipelineLayout, ctx.pipelineCache);
+    std::vector<VSDL_PipelineKey> keys = { vsdl_pipeline_key(ctx, "shaders/instanced.vert.spv", "shaders/tri.frag.spv", inst.pipelineLayout) };
+    if (ctx.depthPrepass) keys.push_back(vsdl_pipeline_key(ctx, "shaders/instanced.vert.spv", std::string(), inst.pipelineLayout));
+    std::vector<VSDL_PipelineId> ids = vsdl_prewarm_pipelines(ctx, keys);
+    inst.drawPipeline = ids[0];
+    if (ctx.depthPrepass) inst.depthPipeline = ids[1];
+    vsdl_shader_reload_register(ctx, { "cull.comp" }, &inst.cullPipeline, [](VSDL_Context& ctx) {
+        return vsdl_build_compute_pipeline(ctx, "shaders/cull.comp.spv", ctx.instancing.pipelineLayout, ctx.pipelineCache);
+    });
+}
+
+std::vector<VSDL_InstanceData> vsdl_generate_instances(uint32_t count) {
+    // Scatter instances a bit past the screen edges so culling has work to do
+    std::vector<VSDL_InstanceData> instances(count);
+    uint32_t seed = 0x9E3779B9u;
+    auto random01 = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return (float)(seed >> 8) / (float)(1u << 24);
+    };
+    float scale = std::clamp(0.6f / std::sqrt((float)std::max(count, 1u)), 0.004f, 0.5f);
+    for (auto& instance : instances) {
+        instance.positionScale[0] = random01() * 2.4f - 1.2f;
+        instance.positionScale[1] = random01() * 2.4f - 1.2f;
+        instance.positionScale[2] = 0.0f;
+        instance.positionScale[3] = scale;
+        instance.color[0] = 0.5f + 0.5f * random01();
+        instance.color[1] = 0.5f + 0.5f * random01();
+        instance.color[2] = 0.5f + 0.5f * random01();
+        instance.color[3] = 1.0f;
+    }
+    return instances;
+}
+
+static void destroy_instance_buffers(VSDL_Context& ctx) {
+    VSDL_Instancing& inst = ctx.instancing;
+    vsdl_destroy_buffer(ctx, inst.instanceBuffer);
+    for (uint32_t i = 0; i < VSDL_MAX_FRAMES_IN_FLIGHT; i++) {
+        vsdl_destroy_buffer(ctx, inst.visibleBuffers[i]);
+        vsdl_destroy_buffer(ctx, inst.indirectBuffers[i]);
+        vsdl_destroy_buffer(ctx, inst.statsReadback[i]);
+        inst.statsPending[i] = false;
+    }
+    inst.lastStats = {};
+}
+
+void vsdl_set_instance_count(VSDL_Context& ctx, uint32_t instanceCount) {
+    VSDL_Instancing& inst = ctx.instancing;
+    // Keep the dispatch within the guaranteed maxComputeWorkGroupCount[0]
+    instanceCount = std::min(instanceCount, 65535u * VSDL_CULL_GROUP_SIZE);
+
+    vkDeviceWaitIdle(ctx.device);
+    destroy_instance_buffers(ctx);
+    inst.instanceCount = instanceCount;
+    if (instanceCount == 0) return;
+
+    std::vector<VSDL_InstanceData> instances = vsdl_generate_instances(instanceCount);
+
+    VkDeviceSize instanceBytes = sizeof(VSDL_InstanceData) * instanceCount;
+    inst.instanceBuffer = vsdl_create_buffer(ctx, instanceBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                             VSDL_MemoryClass::Static);
+    vsdl_upload_buffer(ctx, instances.data(), instanceBytes, inst.instanceBuffer);
+
+    for (uint32_t i = 0; i < VSDL_MAX_FRAMES_IN_FLIGHT; i++) {
+        inst.visibleBuffers[i] = vsdl_create_buffer(ctx, sizeof(uint32_t) * instanceCount, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                    VSDL_MemoryClass::Static);
+        inst.indirectBuffers[i] = vsdl_create_buffer(ctx, sizeof(VSDL_CullOutput),
+                                                     VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                                     VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                     VSDL_MemoryClass::Static);
+        inst.statsReadback[i] = vsdl_create_buffer(ctx, sizeof(VSDL_CullOutput), VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                   VSDL_MemoryClass::Readback);
+
+        VkDescriptorBufferInfo bufferInfos[3] = {};
+        bufferInfos[0].buffer = inst.instanceBuffer.buffer;
+        bufferInfos[0].range = VK_WHOLE_SIZE;
+        bufferInfos[1].buffer = inst.visibleBuffers[i].buffer;
+        bufferInfos[1].range = VK_WHOLE_SIZE;
+        bufferInfos[2].buffer = inst.indirectBuffers[i].buffer;
+        bufferInfos[2].range = VK_WHOLE_SIZE;
+
+        VkWriteDescriptorSet writes[3] = {};
+        for (uint32_t b = 0; b < 3; b++) {
+            writes[b].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[b].dstSet = inst.descriptorSets[i];
+            writes[b].dstBinding = b;
+            writes[b].descriptorCount = 1;
+            writes[b].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            writes[b].pBufferInfo = &bufferInfos[b];
+        }
+        vkUpdateDescriptorSets(ctx.device, 3, writes, 0, nullptr);
+        vsdl_write_depth_pyramid_binding(ctx, inst.descriptorSets[i], 3);
+    }
+
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Instancing: %u instances (%.1f MB)", instanceCount,
+                instanceBytes / (1024.0 * 1024.0));
+}
+
+void vsdl_destroy_instancing(VSDL_Context& ctx) {
+    VSDL_Instancing& inst = ctx.instancing;
+    destroy_instance_buffers(ctx);
+    vsdl_destroy_depth_pyramid(ctx);
+    if (inst.cullPipeline) vkDestroyPipeline(ctx.device, inst.cullPipeline, nullptr);
+    if (inst.pipelineLayout) vkDestroyPipelineLayout(ctx.device, inst.pipelineLayout, nullptr);
+    if (inst.descriptorPool) vkDestroyDescriptorPool(ctx.device, inst.descriptorPool, nullptr);
+    if (inst.setLayout) vkDestroyDescriptorSetLayout(ctx.device, inst.setLayout, nullptr);
+    inst = VSDL_Instancing{};
+}
+
+void vsdl_record_instancing_cull(VSDL_Context& ctx, VkCommandBuffer commandBuffer, uint32_t frameSlot) {
+    VSDL_Instancing& inst = ctx.instancing;
+
+    // The slot's fence was waited on, so the previous frame using these buffers is done with them and its
+    // statistics copy has landed: reading it here never stalls
+    if (inst.statsPending[frameSlot]) {
+        vmaInvalidateAllocation(ctx.allocator, inst.statsReadback[frameSlot].allocation, 0, VK_WHOLE_SIZE);
+        memcpy(&inst.lastStats, inst.statsReadback[frameSlot].mapped, sizeof(VSDL_CullOutput));
+        inst.statsPending[frameSlot] = false;
+    }
+
+    // Shared with the draw, which only reads the matrix
+    const VSDL_DepthPyramid& pyramid = ctx.depthPyramid;
+    VSDL_FrameSlice paramsSlice = vsdl_frame_alloc_uniform(ctx, sizeof(VSDL_CullParams));
+    VSDL_CullParams* params = static_cast<VSDL_CullParams*>(paramsSlice.mapped);
+    params->viewProjection = ctx.camera.viewProjection;
+    params->occlusionViewProjection = pyramid.viewProjection;
+    extract_frustum_planes(ctx.camera.viewProjection, params->frustumPlanes);
+    params->depthSize = glm::vec2((float)pyramid.depthExtent.width, (float)pyramid.depthExtent.height);
+    params->pyramidLevels = pyramid.levelCount;
+    params->occlusion = inst.occlusionCulling && pyramid.valid ? 1u : 0u;
+    params->instanceCount = inst.instanceCount;
+    inst.paramsOffset = (uint32_t)paramsSlice.offset;
+    vsdl_depth_pyramid_prepare(ctx, commandBuffer);
+
+    VSDL_CullOutput output = {};
+    output.command.indexCount = ctx.meshes[0].indexCount;
+    vkCmdUpdateBuffer(commandBuffer, inst.indirectBuffers[frameSlot].buffer, 0, sizeof(output), &output);
+
+    VkMemoryBarrier resetBarrier = {};
+    resetBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    resetBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    resetBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                         1, &resetBarrier, 0, nullptr, 0, nullptr);
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, inst.cullPipeline);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, inst.pipelineLayout, 0, 1,
+                            &inst.descriptorSets[frameSlot], 0, nullptr);
+    uint32_t dynamicOffsets[2] = { inst.paramsOffset, 0 };
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, inst.pipelineLayout, 1, 1, &ctx.frameArena.set, 2, dynamicOffsets);
+    vkCmdDispatch(commandBuffer, (inst.instanceCount + VSDL_CULL_GROUP_SIZE - 1) / VSDL_CULL_GROUP_SIZE, 1, 1);
+
+    VkMemoryBarrier cullBarrier = {};
+    cullBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    cullBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    cullBarrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                         1, &cullBarrier, 0, nullptr, 0, nullptr);
+
+    // Read back when this slot comes around again; the copy and the indirect read don't conflict
+    VkBufferCopy copy = {};
+    copy.size = sizeof(VSDL_CullOutput);
+    vkCmdCopyBuffer(commandBuffer, inst.indirectBuffers[frameSlot].buffer, inst.statsReadback[frameSlot].buffer, 1, &copy);
+    inst.statsPending[frameSlot] = true;
+}
+
+void vsdl_record_instancing_draw(VSDL_Context& ctx, VkCommandBuffer commandBuffer, uint32_t frameSlot, bool depthOnly) {
+    VSDL_Instancing& inst = ctx.instancing;
+    const VSDL_Mesh& mesh = ctx.meshes[0];
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vsdl_pipeline(ctx, depthOnly ? inst.depthPipeline : inst.drawPipeline));
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, inst.pipelineLayout, 0, 1,
+                            &inst.descriptorSets[frameSlot], 0, nullptr);
+    uint32_t dynamicOffsets[2] = { inst.paramsOffset, 0 };
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, inst.pipelineLayout, 1, 1, &ctx.frameArena.set, 2, dynamicOffsets);
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &mesh.vertexBuffer.buffer, &offset);
+    vkCmdBindIndexBuffer(commandBuffer, mesh.indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT32);
+    // One draw call regardless of instance count; the cull pass filled in instanceCount
+    vkCmdDrawIndexedIndirect(commandBuffer, inst.indirectBuffers[frameSlot].buffer, 0, 1, sizeof(VSDL_CullOutput));
+}
+
+void vsdl_benchmark_instances(VSDL_Context& ctx, uint32_t frameCount) {
+    const uint32_t warmupFrames = 30;
+    const uint32_t instanceCounts[] = { 1000, 10000, 100000, 1000000 };
+    const uint32_t originalCount = ctx.instancing.instanceCount;
+    if (ctx.presentMode == VK_PRESENT_MODE_FIFO_KHR) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Benchmark running with FIFO present mode, frame times are capped at vsync");
+    }
+    if (ctx.frames[0].commandBuffer == VK_NULL_HANDLE) vsdl_create_frames(ctx);
+
+    for (uint32_t count : instanceCounts) {
+        vsdl_set_instance_count(ctx, count);
+
+        double recordMs = 0.0, gpuMs = 0.0;
+        Uint64 start = 0;
+        for (uint32_t i = 0; i < warmupFrames + frameCount; i++) {
+            if (i == warmupFrames) start = SDL_GetPerformanceCounter();
+
+            SDL_Event event;
+            while (SDL_PollEvent(&event)) {
+                vsdl::imgui_new_frame(ctx, event);
+                if (event.type == SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED) ctx.swapchainOutOfDate = true;
+                if (event.type == SDL_EVENT_QUIT) {
+                    SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Benchmark aborted");
+                    return;
+                }
+            }
+
+            vsdl_build_ui(ctx);
+            vsdl_draw_frame(ctx);
+            if (i >= warmupFrames) {
+                recordMs += ctx.lastRecordMs;
+                gpuMs += vsdl_profiler_last_ms(ctx, "cull") + vsdl_profiler_last_ms(ctx, "scene") + vsdl_profiler_last_ms(ctx, "depth pyramid");
+            }
+        }
+        vkDeviceWaitIdle(ctx.device);
+        double frameMs = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / (double)SDL_GetPerformanceFrequency() / frameCount;
+
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Benchmark: %7u instances (%u visible): record %.3f ms, GPU cull+draw %.3f ms, frame %.3f ms, 1 draw call",
+                    count, ctx.instancing.lastStats.command.instanceCount, recordMs / frameCount, gpuMs / frameCount, frameMs);
+    }
+
+    vsdl_set_instance_count(ctx, originalCount);
+}
\ No newline at end of file
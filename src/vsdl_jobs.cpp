@@ -0,0 +1,69 @@
+#include "vsdl_jobs.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct VSDL_JobSystem {
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::condition_variable workDone;
+    std::deque<std::pair<std::function<void(uint32_t)>, uint32_t>> queue;
+    uint32_t outstanding = 0; // Queued or running jobs
+    bool quit = false;
+};
+
+static void worker_main(VSDL_JobSystem* jobs) {
+    std::unique_lock<std::mutex> lock(jobs->mutex);
+    for (;;) {
+        jobs->workAvailable.wait(lock, [jobs] { return jobs->quit || !jobs->queue.empty(); });
+        if (jobs->queue.empty()) return; // quit with nothing left to run
+
+        auto job = std::move(jobs->queue.front());
+        jobs->queue.pop_front();
+        lock.unlock();
+        job.first(job.second);
+        lock.lock();
+
+        if (--jobs->outstanding == 0) jobs->workDone.notify_all();
+    }
+}
+
+VSDL_JobSystem* vsdl_create_job_system(uint32_t workerCount) {
+    VSDL_JobSystem* jobs = new VSDL_JobSystem();
+    for (uint32_t i = 0; i < workerCount; i++) {
+        jobs->workers.emplace_back(worker_main, jobs);
+    }
+    return jobs;
+}
+
+void vsdl_destroy_job_system(VSDL_JobSystem* jobs) {
+    if (!jobs) return;
+    {
+        std::lock_guard<std::mutex> lock(jobs->mutex);
+        jobs->quit = true;
+    }
+    jobs->workAvailable.notify_all();
+    for (auto& worker : jobs->workers) {
+        worker.join();
+    }
+    delete jobs;
+}
+
+void vsdl_jobs_dispatch(VSDL_JobSystem* jobs, uint32_t count, const std::function<void(uint32_t)>& job) {
+    {
+        std::lock_guard<std::mutex> lock(jobs->mutex);
+        for (uint32_t i = 0; i < count; i++) {
+            jobs->queue.emplace_back(job, i);
+        }
+        jobs->outstanding += count;
+    }
+    jobs->workAvailable.notify_all();
+}
+
+void vsdl_jobs_wait(VSDL_JobSystem* jobs) {
+    std::unique_lock<std::mutex> lock(jobs->mutex);
+    jobs->workDone.wait(lock, [jobs] { return jobs->outstanding == 0; });
+}
\ No newline at end of file
@@ -0,0 +1,236 @@
+#include "vsdl_memory.h"
+#include <SDL3/SDL_log.h>
+#include <algorithm>
+#include <stdexcept>
+
+const char* vsdl_memory_class_name(VSDL_MemoryClass memoryClass) {
+    switch (memoryClass) {
+        case VSDL_MemoryClass::Static: return "static";
+        case VSDL_MemoryClass::Dynamic: return "dynamic";
+        case VSDL_MemoryClass::Staging: return "staging";
+        case VSDL_MemoryClass::Readback: return "readback";
+    }
+    return "unknown";
+}
+
+// Allocation parameters shared by the pool setup and the buffer helpers
+static VmaAllocationCreateInfo allocation_info_for(VSDL_MemoryClass memoryClass) {
+    VmaAllocationCreateInfo allocInfo = {};
+    switch (memoryClass) {
+        case VSDL_MemoryClass::Static:
+            allocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+            break;
+        case VSDL_MemoryClass::Dynamic:
+            // Written once per frame by the CPU and read by the GPU; lands in BAR memory when available
+            allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+            allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+            break;
+        case VSDL_MemoryClass::Staging:
+            allocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
+            allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+            break;
+        case VSDL_MemoryClass::Readback:
+            allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+            allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+            break;
+    }
+    return allocInfo;
+}
+
+// Representative usage of each pooled class, used to pick the pool's memory type
+static VkBufferUsageFlags pool_buffer_usage(VSDL_MemoryClass memoryClass) {
+    switch (memoryClass) {
+        case VSDL_MemoryClass::Static:
+            return VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
+                   VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        case VSDL_MemoryClass::Dynamic:
+            return VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                   VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+        case VSDL_MemoryClass::Staging:
+            return VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        default:
+            return 0;
+    }
+}
+
+static VkDeviceSize pool_block_size(VSDL_MemoryClass memoryClass) {
+    switch (memoryClass) {
+        case VSDL_MemoryClass::Static: return 64ull * 1024 * 1024;
+        case VSDL_MemoryClass::Dynamic: return 16ull * 1024 * 1024;
+        case VSDL_MemoryClass::Staging: return 32ull * 1024 * 1024;
+        default: return 0;
+    }
+}
+
+bool vsdl_create_allocator(VSDL_Context& ctx) {
+    VmaVulkanFunctions vulkanFunctions = {};
+    vulkanFunctions.vkGetInstanceProcAddr = vkGetInstanceProcAddr;
+    vulkanFunctions.vkGetDeviceProcAddr = vkGetDeviceProcAddr;
+
+    VmaAllocatorCreateInfo allocatorInfo = {};
+    // The version the device actually runs at, so VMA calls the core 1.1+ entry points (memory requirements 2,
+    // bind memory 2, dedicated allocations) instead of assuming 1.0
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(ctx.physicalDevice, &properties);
+    uint32_t deviceVersion = VK_MAKE_API_VERSION(0, VK_API_VERSION_MAJOR(properties.apiVersion), VK_API_VERSION_MINOR(properties.apiVersion), 0);
+    allocatorInfo.vulkanApiVersion = std::min(ctx.apiVersion, deviceVersion);
+    allocatorInfo.physicalDevice = ctx.physicalDevice;
+    allocatorInfo.device = ctx.device;
+    allocatorInfo.instance = ctx.instance;
+    allocatorInfo.pVulkanFunctions = &vulkanFunctions;
+    if (ctx.memoryBudgetSupported) {
+        allocatorInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+    }
+    if (vmaCreateAllocator(&allocatorInfo, &ctx.allocator) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create VMA allocator");
+        return false;
+    }
+
+    for (uint32_t i = 0; i < VSDL_MEMORY_POOL_COUNT; i++) {
+        VSDL_MemoryClass memoryClass = (VSDL_MemoryClass)i;
+
+        VkBufferCreateInfo sampleBufferInfo = {};
+        sampleBufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        sampleBufferInfo.size = 1024; // Doesn't matter, only the usage selects the memory type
+        sampleBufferInfo.usage = pool_buffer_usage(memoryClass);
+        VmaAllocationCreateInfo sampleAllocInfo = allocation_info_for(memoryClass);
+
+        uint32_t memoryTypeIndex = 0;
+        if (vmaFindMemoryTypeIndexForBufferInfo(ctx.allocator, &sampleBufferInfo, &sampleAllocInfo, &memoryTypeIndex) != VK_SUCCESS) {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "No memory type for %s pool, using default allocations", vsdl_memory_class_name(memoryClass));
+            continue;
+        }
+
+        VmaPoolCreateInfo poolInfo = {};
+        poolInfo.memoryTypeIndex = memoryTypeIndex;
+        poolInfo.blockSize = pool_block_size(memoryClass);
+        poolInfo.minBlockCount = 0; // Blocks are created lazily on first use
+        if (vmaCreatePool(ctx.allocator, &poolInfo, &ctx.memoryPools[i]) != VK_SUCCESS) {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Failed to create %s pool, using default allocations", vsdl_memory_class_name(memoryClass));
+            continue;
+        }
+        vmaSetPoolName(ctx.allocator, ctx.memoryPools[i], vsdl_memory_class_name(memoryClass));
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Memory pool %s: type %u, %llu MB blocks", vsdl_memory_class_name(memoryClass),
+                    memoryTypeIndex, (unsigned long long)(poolInfo.blockSize / (1024 * 1024)));
+    }
+    return true;
+}
+
+void vsdl_destroy_allocator(VSDL_Context& ctx) {
+    if (!ctx.allocator) return;
+    for (uint32_t i = 0; i < VSDL_MEMORY_POOL_COUNT; i++) {
+        if (ctx.memoryPools[i]) {
+            vmaDestroyPool(ctx.allocator, ctx.memoryPools[i]);
+            ctx.memoryPools[i] = VK_NULL_HANDLE;
+        }
+    }
+    vmaDestroyAllocator(ctx.allocator);
+    ctx.allocator = VK_NULL_HANDLE;
+}
+
+VSDL_Buffer vsdl_create_buffer(VSDL_Context& ctx, VkDeviceSize size, VkBufferUsageFlags usage, VSDL_MemoryClass memoryClass) {
+    VkBufferCreateInfo bufferInfo = {};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = size;
+    bufferInfo.usage = usage;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    // Static data is written by the transfer queue and read by graphics; concurrent sharing
+    // avoids queue family ownership transfers for buffers. GPU-written buffers without TRANSFER_DST
+    // stay exclusive so other families (async compute) can take them over with explicit transfers.
+    uint32_t queueFamilies[] = { ctx.graphicsQueueFamilyIndex, ctx.transferQueueFamilyIndex };
+    if (memoryClass == VSDL_MemoryClass::Static && (usage & VK_BUFFER_USAGE_TRANSFER_DST_BIT) &&
+        ctx.transferQueueFamilyIndex != ctx.graphicsQueueFamilyIndex) {
+        bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        bufferInfo.queueFamilyIndexCount = 2;
+        bufferInfo.pQueueFamilyIndices = queueFamilies;
+    }
+
+    VmaAllocationCreateInfo allocInfo = allocation_info_for(memoryClass);
+    if ((uint32_t)memoryClass < VSDL_MEMORY_POOL_COUNT) {
+        allocInfo.pool = ctx.memoryPools[(uint32_t)memoryClass];
+    }
+
+    VSDL_Buffer buffer;
+    VmaAllocationInfo allocationInfo = {};
+    VkResult result = vmaCreateBuffer(ctx.allocator, &bufferInfo, &allocInfo, &buffer.buffer, &buffer.allocation, &allocationInfo);
+    if (result != VK_SUCCESS && allocInfo.pool) {
+        // Usage flags outside the pool's memory type: fall back to a regular allocation
+        allocInfo.pool = VK_NULL_HANDLE;
+        result = vmaCreateBuffer(ctx.allocator, &bufferInfo, &allocInfo, &buffer.buffer, &buffer.allocation, &allocationInfo);
+    }
+    if (result != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create %s buffer of %llu bytes",
+                     vsdl_memory_class_name(memoryClass), (unsigned long long)size);
+        throw std::runtime_error("Buffer creation failed");
+    }
+    buffer.size = size;
+    buffer.mapped = allocationInfo.pMappedData;
+    return buffer;
+}
+
+void vsdl_destroy_buffer(VSDL_Context& ctx, VSDL_Buffer& buffer) {
+    if (buffer.buffer) vmaDestroyBuffer(ctx.allocator, buffer.buffer, buffer.allocation);
+    buffer = VSDL_Buffer{};
+}
+
+VSDL_Image vsdl_create_image(VSDL_Context& ctx, const VkImageCreateInfo& imageInfo, bool dedicated) {
+    VmaAllocationCreateInfo allocInfo = {};
+    allocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+    if (dedicated) {
+        // Render targets are large and long-lived; a dedicated allocation helps some drivers compress them
+        allocInfo.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+    }
+
+    VSDL_Image image;
+    if (vmaCreateImage(ctx.allocator, &imageInfo, &allocInfo, &image.image, &image.allocation, nullptr) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create %ux%u image", imageInfo.extent.width, imageInfo.extent.height);
+        throw std::runtime_error("Image creation failed");
+    }
+    image.format = imageInfo.format;
+    image.extent = imageInfo.extent;
+    return image;
+}
+
+void vsdl_destroy_image(VSDL_Context& ctx, VSDL_Image& image) {
+    if (image.image) vmaDestroyImage(ctx.allocator, image.image, image.allocation);
+    image = VSDL_Image{};
+}
+
+uint32_t vsdl_get_memory_budgets(VSDL_Context& ctx, VmaBudget* budgets) {
+    const VkPhysicalDeviceMemoryProperties* memoryProperties = nullptr;
+    vmaGetMemoryProperties(ctx.allocator, &memoryProperties);
+    vmaGetHeapBudgets(ctx.allocator, budgets);
+    return memoryProperties->memoryHeapCount;
+}
+
+VmaStatistics vsdl_get_pool_statistics(VSDL_Context& ctx, VSDL_MemoryClass memoryClass) {
+    VmaStatistics statistics = {};
+    if ((uint32_t)memoryClass < VSDL_MEMORY_POOL_COUNT && ctx.memoryPools[(uint32_t)memoryClass]) {
+        vmaGetPoolStatistics(ctx.allocator, ctx.memoryPools[(uint32_t)memoryClass], &statistics);
+    }
+    return statistics;
+}
+
+void vsdl_log_memory_stats(VSDL_Context& ctx) {
+    VmaTotalStatistics total = {};
+    vmaCalculateStatistics(ctx.allocator, &total);
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "GPU memory: %u blocks (%llu KB), %u allocations (%llu KB)",
+                total.total.statistics.blockCount, (unsigned long long)(total.total.statistics.blockBytes / 1024),
+                total.total.statistics.allocationCount, (unsigned long long)(total.total.statistics.allocationBytes / 1024));
+
+    for (uint32_t i = 0; i < VSDL_MEMORY_POOL_COUNT; i++) {
+        VmaStatistics statistics = vsdl_get_pool_statistics(ctx, (VSDL_MemoryClass)i);
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "  pool %s: %u blocks (%llu KB), %u allocations (%llu KB)",
+                    vsdl_memory_class_name((VSDL_MemoryClass)i), statistics.blockCount, (unsigned long long)(statistics.blockBytes / 1024),
+                    statistics.allocationCount, (unsigned long long)(statistics.allocationBytes / 1024));
+    }
+
+    VmaBudget budgets[VK_MAX_MEMORY_HEAPS] = {};
+    uint32_t heapCount = vsdl_get_memory_budgets(ctx, budgets);
+    for (uint32_t i = 0; i < heapCount; i++) {
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "  heap %u: %llu / %llu MB used%s", i,
+                    (unsigned long long)(budgets[i].usage / (1024 * 1024)), (unsigned long long)(budgets[i].budget / (1024 * 1024)),
+                    ctx.memoryBudgetSupported ? "" : " (estimated)");
+    }
+}
\ No newline at end of file
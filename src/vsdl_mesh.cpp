@@ -1,6 +1,69 @@
 #include "vsdl_mesh.h"
+#include "vsdl_memory.h"
+#include "vsdl_upload.h"
 #include <SDL3/SDL_log.h>
+#include <cstddef>
+
+VkVertexInputBindingDescription vsdl_vertex_binding() {
+    VkVertexInputBindingDescription binding = {};
+    binding.binding = 0;
+    binding.stride = sizeof(VSDL_Vertex);
+    binding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+    return binding;
+}
+
+std::vector<VkVertexInputAttributeDescription> vsdl_vertex_attributes() {
+    std::vector<VkVertexInputAttributeDescription> attributes(2);
+    attributes[0].location = 0;
+    attributes[0].binding = 0;
+    attributes[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+    attributes[0].offset = offsetof(VSDL_Vertex, position);
+    attributes[1].location = 1;
+    attributes[1].binding = 0;
+    attributes[1].format = VK_FORMAT_R32G32B32_SFLOAT;
+    attributes[1].offset = offsetof(VSDL_Vertex, color);
+    return attributes;
+}
+
+VSDL_Mesh vsdl_create_mesh(VSDL_Context& ctx, const std::vector<VSDL_Vertex>& vertices, const std::vector<uint32_t>& indices) {
+    VSDL_Mesh mesh;
+    VkDeviceSize vertexBytes = sizeof(VSDL_Vertex) * vertices.size();
+    VkDeviceSize indexBytes = sizeof(uint32_t) * indices.size();
+
+    mesh.vertexBuffer = vsdl_create_buffer(ctx, vertexBytes, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                           VSDL_MemoryClass::Static);
+    mesh.indexBuffer = vsdl_create_buffer(ctx, indexBytes, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                          VSDL_MemoryClass::Static);
+    mesh.vertexCount = (uint32_t)vertices.size();
+    mesh.indexCount = (uint32_t)indices.size();
+
+    // Recorded into the current upload batch; the frame that first draws the mesh waits on it
+    vsdl_upload_buffer(ctx, vertices.data(), vertexBytes, mesh.vertexBuffer);
+    vsdl_upload_buffer(ctx, indices.data(), indexBytes, mesh.indexBuffer);
+    return mesh;
+}
+
+void vsdl_destroy_mesh(VSDL_Context& ctx, VSDL_Mesh& mesh) {
+    vsdl_destroy_buffer(ctx, mesh.vertexBuffer);
+    vsdl_destroy_buffer(ctx, mesh.indexBuffer);
+    mesh = VSDL_Mesh{};
+}
+
+void vsdl_draw_mesh(VkCommandBuffer commandBuffer, const VSDL_Mesh& mesh) {
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &mesh.vertexBuffer.buffer, &offset);
+    vkCmdBindIndexBuffer(commandBuffer, mesh.indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT32);
+    vkCmdDrawIndexed(commandBuffer, mesh.indexCount, 1, 0, 0, 0);
+}
 
 void vsdl_create_triangle(VSDL_Context& ctx) {
-    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Triangle defined in shader, no mesh buffer needed");
+    // World space is Y up; the camera's projection flips it into Vulkan's Y-down clip space
+    std::vector<VSDL_Vertex> vertices = {
+        { {  0.0f,  0.5f, 0.0f }, { 1.0f, 0.0f, 0.0f } },
+        { {  0.5f, -0.5f, 0.0f }, { 0.0f, 1.0f, 0.0f } },
+        { { -0.5f, -0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
+    };
+    std::vector<uint32_t> indices = { 0, 1, 2 };
+    ctx.meshes.push_back(vsdl_create_mesh(ctx, vertices, indices));
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Triangle mesh created (%u vertices)", ctx.meshes.back().vertexCount);
 }
\ No newline at end of file
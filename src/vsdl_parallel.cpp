@@ -0,0 +1,286 @@
+#include "vsdl_parallel.h"
+#include "vsdl_frame_arena.h"
+#include "vsdl_jobs.h"
+#include "vsdl_mesh.h"
+#include "vsdl_particles.h"
+#include "vsdl_pipeline.h"
+#include "vsdl_renderer.h"
+#include "vsdl_transforms.h"
+#include "vsdl_imgui.h"
+#include <SDL3/SDL_log.h>
+#include <SDL3/SDL_timer.h>
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#define VSDL_MAX_WORKERS 8
+
+void vsdl_create_parallel(VSDL_Context& ctx) {
+    VSDL_ParallelRecording& par = ctx.parallel;
+
+    // Camera and objects come from the frame arena; each draw only pushes its object index
+    VkPushConstantRange pushRange = {};
+    pushRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    pushRange.size = sizeof(uint32_t);
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &ctx.frameArena.setLayout;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushRange;
+    if (vkCreatePipelineLayout(ctx.device, &pipelineLayoutInfo, nullptr, &par.pipelineLayout) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create direct-draw pipeline layout");
+        throw std::runtime_error("Pipeline layout creation failed");
+    }
+
+    std::vector<VSDL_PipelineKey> keys = { vsdl_pipeline_key(ctx, "shaders/direct.vert.spv", "shaders/tri.frag.spv", par.pipelineLayout) };
+    if (ctx.depthPrepass) keys.push_back(vsdl_pipeline_key(ctx, "shaders/direct.vert.spv", std::string(), par.pipelineLayout));
+    std::vector<VSDL_PipelineId> ids = vsdl_prewarm_pipelines(ctx, keys);
+    par.pipeline = ids[0];
+    if (ctx.depthPrepass) par.depthPipeline = ids[1];
+}
+
+static void destroy_worker_frames(VSDL_Context& ctx) {
+    VSDL_ParallelRecording& par = ctx.parallel;
+    auto destroyFrame = [&ctx](VSDL_WorkerFrame& frame) {
+        // Destroying the pool frees its command buffer
+        if (frame.commandPool) vkDestroyCommandPool(ctx.device, frame.commandPool, nullptr);
+        frame = VSDL_WorkerFrame{};
+    };
+    for (uint32_t slot = 0; slot < VSDL_MAX_FRAMES_IN_FLIGHT; slot++) {
+        for (auto& frame : par.workerFrames[slot]) destroyFrame(frame);
+        par.workerFrames[slot].clear();
+        destroyFrame(par.uiFrames[slot]);
+    }
+}
+
+static void create_worker_frame(VSDL_Context& ctx, VSDL_WorkerFrame& frame) {
+    // Transient pools are reset wholesale every frame instead of per command buffer
+    VkCommandPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.queueFamilyIndex = ctx.graphicsQueueFamilyIndex;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    if (vkCreateCommandPool(ctx.device, &poolInfo, nullptr, &frame.commandPool) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create worker command pool");
+        throw std::runtime_error("Command pool creation failed");
+    }
+
+    VkCommandBufferAllocateInfo allocInfo = {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = frame.commandPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+    allocInfo.commandBufferCount = 1;
+    if (vkAllocateCommandBuffers(ctx.device, &allocInfo, &frame.commandBuffer) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate worker command buffer");
+        throw std::runtime_error("Command buffer allocation failed");
+    }
+}
+
+void vsdl_set_direct_draw_count(VSDL_Context& ctx, uint32_t drawCount) {
+    // All objects of a frame must fit one storage slice next to the camera
+    const uint32_t maxDraws = (uint32_t)((VSDL_FRAME_ARENA_GPU_BYTES - VSDL_FRAME_UNIFORM_WINDOW) / sizeof(VSDL_ObjectData));
+    if (drawCount > maxDraws) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Direct draw count %u clamped to %u", drawCount, maxDraws);
+        drawCount = maxDraws;
+    }
+    vsdl_generate_transforms(ctx.parallel.objects, drawCount);
+    ctx.parallel.lastUpdateNs = 0;
+}
+
+void vsdl_prepare_direct_draws(VSDL_Context& ctx) {
+    VSDL_ParallelRecording& par = ctx.parallel;
+    Uint64 now = SDL_GetTicksNS();
+    // Clamped so a hitch doesn't spin the objects past the single wrap in vsdl_update_transforms
+    float dt = par.lastUpdateNs ? std::min((float)(now - par.lastUpdateNs) / (float)SDL_NS_PER_SECOND, 0.25f) : 0.0f;
+    par.lastUpdateNs = now;
+
+    VSDL_FrameSlice camera = vsdl_frame_alloc_uniform(ctx, sizeof(glm::mat4));
+    memcpy(camera.mapped, glm::value_ptr(ctx.camera.viewProjection), sizeof(glm::mat4));
+    VSDL_FrameSlice objects = vsdl_frame_alloc_storage(ctx, sizeof(VSDL_ObjectData) * par.objects.count);
+    vsdl_update_transforms(par.objects, dt, static_cast<VSDL_ObjectData*>(objects.mapped));
+    par.cameraOffset = (uint32_t)camera.offset;
+    par.objectOffset = (uint32_t)objects.offset;
+}
+
+void vsdl_set_worker_count(VSDL_Context& ctx, uint32_t workerCount) {
+    VSDL_ParallelRecording& par = ctx.parallel;
+    vkDeviceWaitIdle(ctx.device);
+
+    vsdl_destroy_job_system(par.jobs);
+    par.jobs = nullptr;
+    destroy_worker_frames(ctx);
+
+    par.workerCount = std::min(workerCount, (uint32_t)VSDL_MAX_WORKERS);
+    if (par.workerCount == 0) return;
+
+    // One pool per job and frame slot: a pool is only ever touched by the job recording into it
+    for (uint32_t slot = 0; slot < VSDL_MAX_FRAMES_IN_FLIGHT; slot++) {
+        par.workerFrames[slot].resize(par.workerCount);
+        for (auto& frame : par.workerFrames[slot]) create_worker_frame(ctx, frame);
+        create_worker_frame(ctx, par.uiFrames[slot]);
+    }
+    par.jobs = vsdl_create_job_system(par.workerCount);
+
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Recording %u draws on %u worker thread(s)",
+                par.objects.count, par.workerCount);
+}
+
+void vsdl_destroy_parallel(VSDL_Context& ctx) {
+    VSDL_ParallelRecording& par = ctx.parallel;
+    vsdl_destroy_job_system(par.jobs);
+    par.jobs = nullptr;
+    destroy_worker_frames(ctx);
+    if (par.pipelineLayout) vkDestroyPipelineLayout(ctx.device, par.pipelineLayout, nullptr);
+    par = VSDL_ParallelRecording{};
+}
+
+void vsdl_record_direct_draws(VSDL_Context& ctx, VkCommandBuffer commandBuffer, uint32_t first, uint32_t count, bool depthOnly) {
+    if (count == 0 || ctx.meshes.empty()) return;
+    const VSDL_Mesh& mesh = ctx.meshes[0];
+
+    const VSDL_ParallelRecording& par = ctx.parallel;
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vsdl_pipeline(ctx, depthOnly ? par.depthPipeline : par.pipeline));
+    uint32_t dynamicOffsets[2] = { par.cameraOffset, par.objectOffset };
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, par.pipelineLayout, 0, 1, &ctx.frameArena.set, 2, dynamicOffsets);
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &mesh.vertexBuffer.buffer, &offset);
+    vkCmdBindIndexBuffer(commandBuffer, mesh.indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT32);
+    for (uint32_t i = first; i < first + count; i++) {
+        vkCmdPushConstants(commandBuffer, par.pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(uint32_t), &i);
+        vkCmdDrawIndexed(commandBuffer, mesh.indexCount, 1, 0, 0, 0);
+    }
+}
+
+// Begin a secondary command buffer that continues the scene render pass
+static void begin_secondary(VSDL_Context& ctx, VSDL_WorkerFrame& frame, VkFramebuffer framebuffer) {
+    vkResetCommandPool(ctx.device, frame.commandPool, 0);
+
+    // Dynamic rendering has no render pass to inherit, the attachment formats are declared instead
+    VkCommandBufferInheritanceRenderingInfo renderingInfo = {};
+    renderingInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO;
+    renderingInfo.colorAttachmentCount = 1;
+    renderingInfo.pColorAttachmentFormats = &ctx.swapchainImageFormat;
+    renderingInfo.depthAttachmentFormat = ctx.depthFormat;
+    renderingInfo.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    VkCommandBufferInheritanceInfo inheritanceInfo = {};
+    inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritanceInfo.pNext = ctx.dynamicRendering.enabled ? &renderingInfo : nullptr;
+    inheritanceInfo.renderPass = ctx.renderPass;
+    inheritanceInfo.subpass = 0;
+    inheritanceInfo.framebuffer = framebuffer;
+    VkCommandBufferBeginInfo beginInfo = {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    beginInfo.pInheritanceInfo = &inheritanceInfo;
+    if (vkBeginCommandBuffer(frame.commandBuffer, &beginInfo) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to begin secondary command buffer");
+        throw std::runtime_error("Command buffer begin failed");
+    }
+
+    // Dynamic state is not inherited from the primary
+    VkViewport viewport = {};
+    viewport.width = (float)ctx.swapchainExtent.width;
+    viewport.height = (float)ctx.swapchainExtent.height;
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(frame.commandBuffer, 0, 1, &viewport);
+    VkRect2D scissor = {};
+    scissor.extent = ctx.swapchainExtent;
+    vkCmdSetScissor(frame.commandBuffer, 0, 1, &scissor);
+}
+
+void vsdl_execute_parallel_scene(VSDL_Context& ctx, VkCommandBuffer commandBuffer, VkFramebuffer framebuffer) {
+    VSDL_ParallelRecording& par = ctx.parallel;
+    std::vector<VSDL_WorkerFrame>& workerFrames = par.workerFrames[ctx.currentFrame];
+    const uint32_t objectCount = par.objects.count;
+    const uint32_t chunkSize = (objectCount + par.workerCount - 1) / par.workerCount;
+
+    // Exceptions can't cross the worker threads, so jobs only report failure
+    char* failed = vsdl_frame_alloc_array<char>(ctx, par.workerCount);
+    std::fill(failed, failed + par.workerCount, 0);
+    vsdl_jobs_dispatch(par.jobs, par.workerCount, [&](uint32_t job) {
+        VSDL_WorkerFrame& frame = workerFrames[job];
+        uint32_t first = std::min(job * chunkSize, objectCount);
+        uint32_t count = std::min(chunkSize, objectCount - first);
+        try {
+            begin_secondary(ctx, frame, framebuffer);
+            // Each job lays down depth for its own range first; later ranges may still cover earlier ones,
+            // which stays correct and only costs some of the prepass's savings
+            if (ctx.depthPrepass) vsdl_record_direct_draws(ctx, frame.commandBuffer, first, count, true);
+            vsdl_record_direct_draws(ctx, frame.commandBuffer, first, count, false);
+            if (vkEndCommandBuffer(frame.commandBuffer) != VK_SUCCESS) failed[job] = 1;
+        } catch (const std::exception&) {
+            failed[job] = 1;
+        }
+    });
+
+    // ImGui state is not thread safe, the main thread records it while the workers run. The particles go
+    // in the same buffer, after every object and before the UI, as they do when recording inline.
+    VSDL_WorkerFrame& uiFrame = par.uiFrames[ctx.currentFrame];
+    begin_secondary(ctx, uiFrame, framebuffer);
+    vsdl_record_particles_draw(ctx, uiFrame.commandBuffer);
+    vsdl::imgui_render(ctx, uiFrame.commandBuffer);
+    bool uiFailed = vkEndCommandBuffer(uiFrame.commandBuffer) != VK_SUCCESS;
+
+    vsdl_jobs_wait(par.jobs);
+    if (uiFailed || std::find(failed, failed + par.workerCount, 1) != failed + par.workerCount) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to record secondary command buffers");
+        throw std::runtime_error("Parallel command recording failed");
+    }
+
+    // Submission order follows the job order, so the draw order matches inline recording
+    uint32_t secondaryCount = (uint32_t)workerFrames.size() + 1;
+    VkCommandBuffer* secondaries = vsdl_frame_alloc_array<VkCommandBuffer>(ctx, secondaryCount);
+    for (uint32_t i = 0; i < (uint32_t)workerFrames.size(); i++) secondaries[i] = workerFrames[i].commandBuffer;
+    secondaries[secondaryCount - 1] = uiFrame.commandBuffer;
+    vkCmdExecuteCommands(commandBuffer, secondaryCount, secondaries);
+}
+
+void vsdl_benchmark_workers(VSDL_Context& ctx, uint32_t frameCount) {
+    const uint32_t warmupFrames = 30;
+    const uint32_t workerCounts[] = { 0, 1, 2, 4, 8 };
+    const uint32_t originalCount = ctx.parallel.workerCount;
+    const uint32_t hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    if (ctx.presentMode == VK_PRESENT_MODE_FIFO_KHR) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Benchmark running with FIFO present mode, frame times are capped at vsync");
+    }
+    if (ctx.frames[0].commandBuffer == VK_NULL_HANDLE) vsdl_create_frames(ctx);
+
+    double baselineRecordMs = 0.0;
+    for (uint32_t count : workerCounts) {
+        if (count > hardwareThreads) break;
+        vsdl_set_worker_count(ctx, count);
+
+        double recordMs = 0.0;
+        Uint64 start = 0;
+        for (uint32_t i = 0; i < warmupFrames + frameCount; i++) {
+            if (i == warmupFrames) start = SDL_GetPerformanceCounter();
+
+            SDL_Event event;
+            while (SDL_PollEvent(&event)) {
+                vsdl::imgui_new_frame(ctx, event);
+                if (event.type == SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED) ctx.swapchainOutOfDate = true;
+                if (event.type == SDL_EVENT_QUIT) {
+                    SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Benchmark aborted");
+                    return;
+                }
+            }
+
+            vsdl_build_ui(ctx);
+            vsdl_draw_frame(ctx);
+            if (i >= warmupFrames) recordMs += ctx.lastRecordMs;
+        }
+        vkDeviceWaitIdle(ctx.device);
+        double frameMs = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / (double)SDL_GetPerformanceFrequency() / frameCount;
+
+        recordMs /= frameCount;
+        if (count == 0) baselineRecordMs = recordMs;
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Benchmark: %u draws, %u worker(s): record %.3f ms (%.2fx), frame %.3f ms",
+                    ctx.parallel.objects.count, count, recordMs, baselineRecordMs / recordMs, frameMs);
+    }
+
+    vsdl_set_worker_count(ctx, originalCount);
+}
\ No newline at end of file
@@ -0,0 +1,394 @@
+#include "vsdl_particles.h"
+#include "vsdl_memory.h"
+#include "vsdl_pipeline.h"
+#include "vsdl_profiler.h"
+#include "vsdl_renderer.h"
+#include "vsdl_shader_reload.h"
+#include "vsdl_sync.h"
+#include "vsdl_imgui.h"
+#include <SDL3/SDL_log.h>
+#include <SDL3/SDL_timer.h>
+#include <algorithm>
+#include <stdexcept>
+
+#define VSDL_PARTICLE_GROUP_SIZE 256
+#define VSDL_PARTICLE_DT (1.0f / 60.0f) // Fixed step so both benchmark modes simulate the same thing
+#define VSDL_PARTICLE_SEED 0x2545F491u
+
+struct VSDL_ParticlePush {
+    float dt;
+    float time;
+    uint32_t count;
+    uint32_t seed; // Nonzero reseeds instead of integrating
+};
+
+// Overlap needs a second hardware queue, and cross-queue waits on compute need timeline semaphores
+static bool async_available(VSDL_Context& ctx) {
+    return ctx.computeQueueFamilyIndex != ctx.graphicsQueueFamilyIndex && ctx.sync.timeline;
+}
+
+// Release and acquire halves of one ownership transfer must use identical families and ranges
+static void transfer_ownership(VkCommandBuffer commandBuffer, VkBuffer buffer, uint32_t srcFamily, uint32_t dstFamily,
+                               VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+                               VkPipelineStageFlags dstStage, VkAccessFlags dstAccess) {
+    VkBufferMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstAccessMask = dstAccess;
+    barrier.srcQueueFamilyIndex = srcFamily;
+    barrier.dstQueueFamilyIndex = dstFamily;
+    barrier.buffer = buffer;
+    barrier.offset = 0;
+    barrier.size = VK_WHOLE_SIZE;
+    vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+}
+
+// One simulation step into positions[target]; the caller has ordered it after the previous step
+static void record_step(VSDL_Context& ctx, VkCommandBuffer commandBuffer, uint32_t target) {
+    VSDL_Particles& particles = ctx.particles;
+    VSDL_ParticlePush push = {};
+    push.dt = VSDL_PARTICLE_DT;
+    push.time = particles.time;
+    push.count = particles.count;
+    push.seed = particles.needsInit ? VSDL_PARTICLE_SEED : 0u;
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, particles.simulatePipeline);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, particles.pipelineLayout, 0, 1,
+                            &particles.descriptorSets[target], 0, nullptr);
+    vkCmdPushConstants(commandBuffer, particles.pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(push), &push);
+    vkCmdDispatch(commandBuffer, (particles.count + VSDL_PARTICLE_GROUP_SIZE - 1) / VSDL_PARTICLE_GROUP_SIZE, 1, 1);
+
+    particles.needsInit = false;
+    particles.time += VSDL_PARTICLE_DT;
+    particles.step++;
+}
+
+static void reset_simulation(VSDL_Particles& particles) {
+    particles.needsInit = true;
+    particles.step = 0;
+    particles.drawBuffer = UINT32_MAX;
+    particles.time = 0.0f;
+    std::fill(particles.computeValues, particles.computeValues + 2, 0);
+    std::fill(particles.releaseValues, particles.releaseValues + 2, 0);
+}
+
+void vsdl_create_particles(VSDL_Context& ctx, uint32_t count) {
+    VSDL_Particles& particles = ctx.particles;
+    // Keep the dispatch within the guaranteed maxComputeWorkGroupCount[0]
+    particles.count = std::min(count, 65535u * VSDL_PARTICLE_GROUP_SIZE);
+    if (particles.count == 0) return;
+
+    // 0: simulation state, 1: positions (also read by the point draw)
+    VkDescriptorSetLayoutBinding bindings[2] = {};
+    for (uint32_t i = 0; i < 2; i++) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT | (i == 1 ? VK_SHADER_STAGE_VERTEX_BIT : 0);
+    }
+    VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = 2;
+    layoutInfo.pBindings = bindings;
+    if (vkCreateDescriptorSetLayout(ctx.device, &layoutInfo, nullptr, &particles.setLayout) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create particle descriptor set layout");
+        throw std::runtime_error("Descriptor set layout creation failed");
+    }
+
+    VkPushConstantRange pushRange = {};
+    pushRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushRange.size = sizeof(VSDL_ParticlePush);
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &particles.setLayout;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushRange;
+    if (vkCreatePipelineLayout(ctx.device, &pipelineLayoutInfo, nullptr, &particles.pipelineLayout) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create particle pipeline layout");
+        throw std::runtime_error("Pipeline layout creation failed");
+    }
+
+    VkDescriptorPoolSize poolSize = {};
+    poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSize.descriptorCount = 2 * 2;
+    VkDescriptorPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = 2;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    if (vkCreateDescriptorPool(ctx.device, &poolInfo, nullptr, &particles.descriptorPool) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create particle descriptor pool");
+        throw std::runtime_error("Descriptor pool creation failed");
+    }
+
+    VkDescriptorSetLayout setLayouts[2] = { particles.setLayout, particles.setLayout };
+    VkDescriptorSetAllocateInfo allocInfo = {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = particles.descriptorPool;
+    allocInfo.descriptorSetCount = 2;
+    allocInfo.pSetLayouts = setLayouts;
+    if (vkAllocateDescriptorSets(ctx.device, &allocInfo, particles.descriptorSets) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate particle descriptor sets");
+        throw std::runtime_error("Descriptor set allocation failed");
+    }
+
+    // No TRANSFER_DST: the buffers stay exclusive and are seeded by the first step, not uploaded
+    VkDeviceSize stateBytes = (VkDeviceSize)particles.count * 2 * 4 * sizeof(float);
+    VkDeviceSize positionBytes = (VkDeviceSize)particles.count * 4 * sizeof(float);
+    particles.state = vsdl_create_buffer(ctx, stateBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VSDL_MemoryClass::Static);
+    for (uint32_t i = 0; i < 2; i++) {
+        particles.positions[i] = vsdl_create_buffer(ctx, positionBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VSDL_MemoryClass::Static);
+
+        VkDescriptorBufferInfo bufferInfos[2] = {};
+        bufferInfos[0].buffer = particles.state.buffer;
+        bufferInfos[0].range = VK_WHOLE_SIZE;
+        bufferInfos[1].buffer = particles.positions[i].buffer;
+        bufferInfos[1].range = VK_WHOLE_SIZE;
+
+        VkWriteDescriptorSet writes[2] = {};
+        for (uint32_t b = 0; b < 2; b++) {
+            writes[b].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[b].dstSet = particles.descriptorSets[i];
+            writes[b].dstBinding = b;
+            writes[b].descriptorCount = 1;
+            writes[b].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            writes[b].pBufferInfo = &bufferInfos[b];
+        }
+        vkUpdateDescriptorSets(ctx.device, 2, writes, 0, nullptr);
+    }
+
+    particles.simulatePipeline = vsdl_build_compute_pipeline(ctx, "shaders/particles.comp.spv", particles.pipelineLayout,
+                                                             ctx.pipelineCache);
+    // Depth tested but not written, so the points never hide each other
+    VSDL_PipelineKey drawKey = vsdl_pipeline_key(ctx, "shaders/particles.vert.spv", "shaders/particles.frag.spv",
+                                                 particles.pipelineLayout);
+    drawKey.topology = VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
+    drawKey.depth = VSDL_DepthMode::Translucent;
+    particles.drawPipeline = vsdl_get_pipeline(ctx, drawKey);
+    vsdl_shader_reload_register(ctx, { "particles.comp" }, &particles.simulatePipeline, [](VSDL_Context& ctx) {
+        return vsdl_build_compute_pipeline(ctx, "shaders/particles.comp.spv", ctx.particles.pipelineLayout, ctx.pipelineCache);
+    });
+
+    if (async_available(ctx)) {
+        VkCommandPoolCreateInfo commandPoolInfo = {};
+        commandPoolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        commandPoolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        commandPoolInfo.queueFamilyIndex = ctx.computeQueueFamilyIndex;
+        if (vkCreateCommandPool(ctx.device, &commandPoolInfo, nullptr, &particles.computePool) != VK_SUCCESS) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create compute command pool");
+            throw std::runtime_error("Command pool creation failed");
+        }
+        VkCommandBufferAllocateInfo commandBufferInfo = {};
+        commandBufferInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        commandBufferInfo.commandPool = particles.computePool;
+        commandBufferInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        commandBufferInfo.commandBufferCount = VSDL_MAX_FRAMES_IN_FLIGHT;
+        if (vkAllocateCommandBuffers(ctx.device, &commandBufferInfo, particles.computeCommandBuffers) != VK_SUCCESS) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate compute command buffers");
+            throw std::runtime_error("Command buffer allocation failed");
+        }
+    }
+
+    reset_simulation(particles);
+    particles.async = async_available(ctx);
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Particles: %u (%.1f MB), %s", particles.count,
+                (stateBytes + 2 * positionBytes) / (1024.0 * 1024.0),
+                particles.async ? "async compute queue" : "inline on the graphics queue");
+}
+
+void vsdl_destroy_particles(VSDL_Context& ctx) {
+    VSDL_Particles& particles = ctx.particles;
+    vsdl_destroy_buffer(ctx, particles.state);
+    for (auto& buffer : particles.positions) vsdl_destroy_buffer(ctx, buffer);
+    if (particles.computePool) vkDestroyCommandPool(ctx.device, particles.computePool, nullptr);
+    if (particles.simulatePipeline) vkDestroyPipeline(ctx.device, particles.simulatePipeline, nullptr);
+    if (particles.pipelineLayout) vkDestroyPipelineLayout(ctx.device, particles.pipelineLayout, nullptr);
+    if (particles.descriptorPool) vkDestroyDescriptorPool(ctx.device, particles.descriptorPool, nullptr);
+    if (particles.setLayout) vkDestroyDescriptorSetLayout(ctx.device, particles.setLayout, nullptr);
+    particles = VSDL_Particles{};
+}
+
+bool vsdl_set_particles_async(VSDL_Context& ctx, bool async) {
+    VSDL_Particles& particles = ctx.particles;
+    // Idle, so no transfer is half done; the reseed rewrites every buffer whichever family owned it
+    vkDeviceWaitIdle(ctx.device);
+    particles.async = async && async_available(ctx);
+    reset_simulation(particles);
+    return particles.async == async;
+}
+
+void vsdl_particles_simulate(VSDL_Context& ctx) {
+    VSDL_Particles& particles = ctx.particles;
+    if (particles.count == 0 || !particles.async) return;
+
+    // The command buffer of this slot was submitted framesInFlight frames ago and is normally long done
+    uint32_t slot = ctx.currentFrame;
+    vsdl_timeline_wait(ctx, VSDL_QueueKind::Compute, particles.computeSlotValues[slot]);
+    VkCommandBuffer commandBuffer = particles.computeCommandBuffers[slot];
+    vkResetCommandBuffer(commandBuffer, 0);
+    VkCommandBufferBeginInfo beginInfo = {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to begin compute command buffer");
+        throw std::runtime_error("Command buffer begin failed");
+    }
+
+    uint32_t target = (uint32_t)(particles.step % 2);
+    std::vector<VSDL_QueueWait> waits;
+    if (particles.releaseValues[target]) {
+        // Graphics drew this buffer two steps ago; take it back once that frame's release has executed
+        transfer_ownership(commandBuffer, particles.positions[target].buffer, ctx.graphicsQueueFamilyIndex,
+                           ctx.computeQueueFamilyIndex, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0,
+                           VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT);
+        VSDL_QueueWait wait;
+        wait.kind = VSDL_QueueKind::Graphics;
+        wait.value = particles.releaseValues[target];
+        wait.stages = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        waits.push_back(wait);
+    }
+    // The state buffer never leaves this queue; order against the previous step only
+    VkMemoryBarrier stateBarrier = {};
+    stateBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    stateBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    stateBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                         1, &stateBarrier, 0, nullptr, 0, nullptr);
+
+    record_step(ctx, commandBuffer, target);
+
+    transfer_ownership(commandBuffer, particles.positions[target].buffer, ctx.computeQueueFamilyIndex,
+                       ctx.graphicsQueueFamilyIndex, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                       VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0);
+
+    if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to end compute command buffer");
+        throw std::runtime_error("Command buffer end failed");
+    }
+    uint64_t value = vsdl_queue_submit(ctx, VSDL_QueueKind::Compute, commandBuffer, waits);
+    particles.computeSlotValues[slot] = value;
+    particles.computeValues[target] = value;
+
+    // This frame draws the previous step, so the step just submitted overlaps the graphics work
+    uint32_t previous = 1 - target;
+    particles.drawBuffer = particles.computeValues[previous] ? previous : UINT32_MAX;
+}
+
+void vsdl_record_particles_pre_pass(VSDL_Context& ctx, VkCommandBuffer commandBuffer) {
+    VSDL_Particles& particles = ctx.particles;
+    if (particles.count == 0) return;
+
+    if (!particles.async) {
+        uint32_t target = (uint32_t)(particles.step % 2);
+        vsdl_gpu_scope_begin(ctx, commandBuffer, "particles");
+        // After the previous step (state) and the vertex reads of the frame that drew this buffer
+        VkMemoryBarrier stepBarrier = {};
+        stepBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        stepBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        stepBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &stepBarrier, 0, nullptr, 0, nullptr);
+        record_step(ctx, commandBuffer, target);
+        VkMemoryBarrier drawBarrier = {};
+        drawBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        drawBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        drawBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, 0,
+                             1, &drawBarrier, 0, nullptr, 0, nullptr);
+        vsdl_gpu_scope_end(ctx, commandBuffer);
+        particles.drawBuffer = target;
+        return;
+    }
+
+    if (particles.drawBuffer == UINT32_MAX) return;
+    transfer_ownership(commandBuffer, particles.positions[particles.drawBuffer].buffer, ctx.computeQueueFamilyIndex,
+                       ctx.graphicsQueueFamilyIndex, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0,
+                       VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+}
+
+void vsdl_record_particles_post_pass(VSDL_Context& ctx, VkCommandBuffer commandBuffer) {
+    VSDL_Particles& particles = ctx.particles;
+    if (particles.count == 0 || !particles.async || particles.drawBuffer == UINT32_MAX) return;
+    // Read-only use, so the release only has to wait for the vertex reads to finish
+    transfer_ownership(commandBuffer, particles.positions[particles.drawBuffer].buffer, ctx.graphicsQueueFamilyIndex,
+                       ctx.computeQueueFamilyIndex, VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, 0,
+                       VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0);
+    particles.releaseValues[particles.drawBuffer] = vsdl_timeline_pending(ctx, VSDL_QueueKind::Graphics);
+}
+
+void vsdl_record_particles_draw(VSDL_Context& ctx, VkCommandBuffer commandBuffer) {
+    VSDL_Particles& particles = ctx.particles;
+    if (particles.count == 0 || particles.drawBuffer == UINT32_MAX) return;
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vsdl_pipeline(ctx, particles.drawPipeline));
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, particles.pipelineLayout, 0, 1,
+                            &particles.descriptorSets[particles.drawBuffer], 0, nullptr);
+    vkCmdDraw(commandBuffer, particles.count, 1, 0, 0);
+}
+
+void vsdl_particles_graphics_waits(VSDL_Context& ctx, std::vector<VSDL_QueueWait>& waits) {
+    VSDL_Particles& particles = ctx.particles;
+    if (particles.count == 0 || !particles.async || particles.drawBuffer == UINT32_MAX) return;
+    VSDL_QueueWait wait;
+    wait.kind = VSDL_QueueKind::Compute;
+    wait.value = particles.computeValues[particles.drawBuffer];
+    wait.stages = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT;
+    waits.push_back(wait);
+}
+
+void vsdl_benchmark_particles(VSDL_Context& ctx, uint32_t frameCount) {
+    const uint32_t warmupFrames = 30;
+    const bool originalAsync = ctx.particles.async;
+    if (ctx.particles.count == 0) return;
+    if (ctx.presentMode == VK_PRESENT_MODE_FIFO_KHR) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Benchmark running with FIFO present mode, frame times are capped at vsync");
+    }
+    if (ctx.frames[0].commandBuffer == VK_NULL_HANDLE) vsdl_create_frames(ctx);
+
+    // Async first: its runs leave no "particles" GPU scope behind that the inline runs could read
+    double frameMsByMode[2] = {};
+    for (int mode = 0; mode < 2; mode++) {
+        bool async = mode == 0;
+        if (!vsdl_set_particles_async(ctx, async)) {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Benchmark: no dedicated compute family or timeline semaphores, "
+                        "skipping the async run");
+            continue;
+        }
+
+        double graphicsMs = 0.0, simulateMs = 0.0;
+        Uint64 start = 0;
+        for (uint32_t i = 0; i < warmupFrames + frameCount; i++) {
+            if (i == warmupFrames) start = SDL_GetPerformanceCounter();
+
+            SDL_Event event;
+            while (SDL_PollEvent(&event)) {
+                vsdl::imgui_new_frame(ctx, event);
+                if (event.type == SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED) ctx.swapchainOutOfDate = true;
+                if (event.type == SDL_EVENT_QUIT) {
+                    SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Benchmark aborted");
+                    vsdl_set_particles_async(ctx, originalAsync);
+                    return;
+                }
+            }
+
+            vsdl_build_ui(ctx);
+            vsdl_draw_frame(ctx);
+            if (i >= warmupFrames) {
+                graphicsMs += vsdl_profiler_last_ms(ctx, "frame");
+                if (!async) simulateMs += vsdl_profiler_last_ms(ctx, "particles");
+            }
+        }
+        vkDeviceWaitIdle(ctx.device);
+        frameMsByMode[mode] = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / (double)SDL_GetPerformanceFrequency() / frameCount;
+
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Benchmark: %u particles, %-11s: frame %.3f ms, graphics queue %.3f ms "
+                    "(simulation %.3f ms of it)", ctx.particles.count, async ? "async queue" : "same queue",
+                    frameMsByMode[mode], graphicsMs / frameCount, simulateMs / frameCount);
+    }
+    if (frameMsByMode[0] > 0.0 && frameMsByMode[1] > 0.0) {
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Benchmark: async compute overlap saves %.3f ms per frame (%.1f%%)",
+                    frameMsByMode[1] - frameMsByMode[0], 100.0 * (frameMsByMode[1] - frameMsByMode[0]) / frameMsByMode[1]);
+    }
+
+    vsdl_set_particles_async(ctx, originalAsync);
+}
\ No newline at end of file
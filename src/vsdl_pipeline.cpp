@@ -1,8 +1,20 @@
 #include "vsdl_pipeline.h"
 #include "vsdl_imgui.h"  // Add this include
+#include "vsdl_swapchain.h"
+#include "vsdl_mesh.h"
+#include "vsdl_archive.h"
+#include "vsdl_shader_reload.h"
+#include "vsdl_jobs.h"
+#include "vsdl_ui_cache.h"
+#include "imgui.h"
 #include <SDL3/SDL_log.h>
+#include <SDL3/SDL_timer.h>
+#include <algorithm>
+#include <cstddef>
+#include <exception>
 #include <fstream>
 #include <stdexcept>
+#include <thread>
 
 static std::vector<char> readFile(const std::string& filename) {
     std::ifstream file(filename, std::ios::ate | std::ios::binary);
@@ -18,24 +30,97 @@ static std::vector<char> readFile(const std::string& filename) {
     return buffer;
 }
 
-void vsdl_create_pipeline(VSDL_Context& ctx) {
-    auto vertShaderCode = readFile("shaders/tri.vert.spv");
-    auto fragShaderCode = readFile("shaders/tri.frag.spv");
+VkShaderModule vsdl_create_shader_module(VSDL_Context& ctx, const std::string& path) {
+    // Packed modules are used in place from the mapping; hot-reload writes loose files, so it skips the archive
+    size_t packedSize = 0;
+    const uint8_t* packed = ctx.shaderReloader ? nullptr : vsdl_archive_find(ctx.archive, path, &packedSize);
+    std::vector<char> code;
+    if (!packed) code = readFile(path);
 
-    VkShaderModule vertShaderModule, fragShaderModule;
     VkShaderModuleCreateInfo createInfo = {};
     createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-    createInfo.codeSize = vertShaderCode.size();
-    createInfo.pCode = reinterpret_cast<const uint32_t*>(vertShaderCode.data());
-    if (vkCreateShaderModule(ctx.device, &createInfo, nullptr, &vertShaderModule) != VK_SUCCESS) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create vertex shader module");
+    createInfo.codeSize = packed ? packedSize : code.size();
+    createInfo.pCode = packed ? reinterpret_cast<const uint32_t*>(packed) : reinterpret_cast<const uint32_t*>(code.data());
+    VkShaderModule shaderModule;
+    if (vkCreateShaderModule(ctx.device, &createInfo, nullptr, &shaderModule) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create shader module %s", path.c_str());
         throw std::runtime_error("Shader module creation failed");
     }
-    createInfo.codeSize = fragShaderCode.size();
-    createInfo.pCode = reinterpret_cast<const uint32_t*>(fragShaderCode.data());
-    if (vkCreateShaderModule(ctx.device, &createInfo, nullptr, &fragShaderModule) != VK_SUCCESS) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create fragment shader module");
-        throw std::runtime_error("Shader module creation failed");
+    return shaderModule;
+}
+
+bool VSDL_PipelineKey::operator==(const VSDL_PipelineKey& other) const {
+    return vertShader == other.vertShader && fragShader == other.fragShader && layout == other.layout &&
+           topology == other.topology && vertexInput == other.vertexInput && cullMode == other.cullMode && blend == other.blend && depth == other.depth &&
+           renderPass == other.renderPass && colorFormat == other.colorFormat && depthFormat == other.depthFormat;
+}
+
+// Fed field by field rather than as raw bytes so struct padding never reaches the hash
+size_t VSDL_PipelineKeyHash::operator()(const VSDL_PipelineKey& key) const {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](uint64_t value) {
+        for (int i = 0; i < 8; i++) {
+            hash ^= (value >> (i * 8)) & 0xff;
+            hash *= 1099511628211ull;
+        }
+    };
+    mix(key.vertShader);
+    mix(key.fragShader);
+    mix((uint64_t)key.layout);
+    mix(key.topology);
+    mix((uint64_t)key.vertexInput);
+    mix(key.cullMode);
+    mix((uint64_t)key.blend);
+    mix((uint64_t)key.depth);
+    mix((uint64_t)key.renderPass);
+    mix(key.colorFormat);
+    mix(key.depthFormat);
+    return (size_t)hash;
+}
+
+uint32_t vsdl_pipeline_shader(VSDL_Context& ctx, const std::string& path) {
+    VSDL_PipelineLibrary& library = ctx.pipelineLibrary;
+    std::lock_guard<std::mutex> lock(library.mutex);
+    for (uint32_t i = 0; i < (uint32_t)library.shaders.size(); i++) {
+        if (library.shaders[i] == path) return i;
+    }
+    library.shaders.push_back(path);
+    return (uint32_t)library.shaders.size() - 1;
+}
+
+static std::string shader_path(VSDL_Context& ctx, uint32_t shader) {
+    std::lock_guard<std::mutex> lock(ctx.pipelineLibrary.mutex);
+    return ctx.pipelineLibrary.shaders[shader];
+}
+
+VSDL_PipelineKey vsdl_pipeline_key(VSDL_Context& ctx, const std::string& vertPath, const std::string& fragPath,
+                                   VkPipelineLayout layout) {
+    VSDL_PipelineKey key;
+    key.vertShader = vsdl_pipeline_shader(ctx, vertPath);
+    if (!fragPath.empty()) key.fragShader = vsdl_pipeline_shader(ctx, fragPath);
+    key.layout = layout;
+    if (fragPath.empty()) {
+        key.depth = VSDL_DepthMode::Prepass;
+    } else if (ctx.depthPrepass) {
+        key.depth = VSDL_DepthMode::Equal;
+    }
+    key.renderPass = ctx.renderPass;
+    key.colorFormat = ctx.swapchainImageFormat;
+    key.depthFormat = ctx.depthFormat;
+    return key;
+}
+
+// Point lists pull their vertices from storage buffers, whatever their key's vertex input says
+VkPipeline vsdl_build_pipeline(VSDL_Context& ctx, const VSDL_PipelineKey& key, VkPipelineCache cache, double* outCreateMs) {
+    VkShaderModule vertShaderModule = vsdl_create_shader_module(ctx, shader_path(ctx, key.vertShader));
+    VkShaderModule fragShaderModule = VK_NULL_HANDLE;
+    if (key.fragShader != VSDL_NO_SHADER) {
+        try {
+            fragShaderModule = vsdl_create_shader_module(ctx, shader_path(ctx, key.fragShader));
+        } catch (...) {
+            vkDestroyShaderModule(ctx.device, vertShaderModule, nullptr);
+            throw;
+        }
     }
 
     VkPipelineShaderStageCreateInfo vertStageInfo = {};
@@ -54,36 +139,46 @@ void vsdl_create_pipeline(VSDL_Context& ctx) {
 
     VkPipelineVertexInputStateCreateInfo vertexInputInfo = {};
     vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    VkVertexInputBindingDescription vertexBinding = vsdl_vertex_binding();
+    std::vector<VkVertexInputAttributeDescription> vertexAttributes = vsdl_vertex_attributes();
+    if (key.vertexInput == VSDL_VertexInput::ImGui) {
+        // ImDrawVert: position, uv, packed RGBA8 color
+        vertexBinding = { 0, (uint32_t)sizeof(ImDrawVert), VK_VERTEX_INPUT_RATE_VERTEX };
+        vertexAttributes = {
+            { 0, 0, VK_FORMAT_R32G32_SFLOAT, (uint32_t)offsetof(ImDrawVert, pos) },
+            { 1, 0, VK_FORMAT_R32G32_SFLOAT, (uint32_t)offsetof(ImDrawVert, uv) },
+            { 2, 0, VK_FORMAT_R8G8B8A8_UNORM, (uint32_t)offsetof(ImDrawVert, col) },
+        };
+    }
+    if (key.topology != VK_PRIMITIVE_TOPOLOGY_POINT_LIST && key.vertexInput != VSDL_VertexInput::None) {
+        vertexInputInfo.vertexBindingDescriptionCount = 1;
+        vertexInputInfo.pVertexBindingDescriptions = &vertexBinding;
+        vertexInputInfo.vertexAttributeDescriptionCount = (uint32_t)vertexAttributes.size();
+        vertexInputInfo.pVertexAttributeDescriptions = vertexAttributes.data();
+    }
 
     VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
     inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    inputAssembly.topology = key.topology;
     inputAssembly.primitiveRestartEnable = VK_FALSE;
 
-    VkViewport viewport = {};
-    viewport.x = 0.0f;
-    viewport.y = 0.0f;
-    viewport.width = (float)ctx.swapchainExtent.width;
-    viewport.height = (float)ctx.swapchainExtent.height;
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
-
-    VkRect2D scissor = {};
-    scissor.offset = {0, 0};
-    scissor.extent = ctx.swapchainExtent;
-
+    // Viewport and scissor are set at record time so resizes don't invalidate the pipeline
     VkPipelineViewportStateCreateInfo viewportState = {};
     viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
     viewportState.viewportCount = 1;
-    viewportState.pViewports = &viewport;
     viewportState.scissorCount = 1;
-    viewportState.pScissors = &scissor;
+
+    VkDynamicState dynamicStates[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+    VkPipelineDynamicStateCreateInfo dynamicState = {};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = 2;
+    dynamicState.pDynamicStates = dynamicStates;
 
     VkPipelineRasterizationStateCreateInfo rasterizer = {};
     rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
     rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
     rasterizer.lineWidth = 1.0f;
-    rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
+    rasterizer.cullMode = key.cullMode;
     rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
 
     VkPipelineMultisampleStateCreateInfo multisampling = {};
@@ -92,26 +187,254 @@ void vsdl_create_pipeline(VSDL_Context& ctx) {
 
     VkPipelineColorBlendAttachmentState colorBlendAttachment = {};
     colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-    colorBlendAttachment.blendEnable = VK_TRUE;
-    colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
-    colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    colorBlendAttachment.blendEnable = key.blend != VSDL_BlendMode::Opaque;
+    colorBlendAttachment.srcColorBlendFactor = key.blend == VSDL_BlendMode::Premultiplied ? VK_BLEND_FACTOR_ONE
+                                                                                          : VK_BLEND_FACTOR_SRC_ALPHA;
+    colorBlendAttachment.dstColorBlendFactor = key.blend == VSDL_BlendMode::Additive ? VK_BLEND_FACTOR_ONE
+                                                                                      : VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
     colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
     colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
-    colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+    // Premultiplied targets may be composited again later, so their alpha has to accumulate coverage too
+    colorBlendAttachment.dstAlphaBlendFactor = key.blend == VSDL_BlendMode::Premultiplied ? VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA
+                                                                                          : VK_BLEND_FACTOR_ZERO;
     colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+    if (key.depth == VSDL_DepthMode::Prepass) colorBlendAttachment.colorWriteMask = 0;
+
+    VkPipelineDepthStencilStateCreateInfo depthStencil = {};
+    depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depthStencil.depthTestEnable = key.depth != VSDL_DepthMode::Disabled;
+    depthStencil.depthWriteEnable = key.depth == VSDL_DepthMode::Opaque || key.depth == VSDL_DepthMode::Prepass;
+    // OR_EQUAL so coplanar geometry drawn later still lands, as it did before depth testing
+    depthStencil.depthCompareOp = key.depth == VSDL_DepthMode::Equal ? VK_COMPARE_OP_EQUAL : VK_COMPARE_OP_GREATER_OR_EQUAL;
 
     VkPipelineColorBlendStateCreateInfo colorBlending = {};
     colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
     colorBlending.attachmentCount = 1;
     colorBlending.pAttachments = &colorBlendAttachment;
 
+    VkGraphicsPipelineCreateInfo pipelineInfo = {};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineInfo.stageCount = fragShaderModule ? 2 : 1;
+    pipelineInfo.pStages = shaderStages;
+    pipelineInfo.pVertexInputState = &vertexInputInfo;
+    pipelineInfo.pInputAssemblyState = &inputAssembly;
+    pipelineInfo.pViewportState = &viewportState;
+    pipelineInfo.pRasterizationState = &rasterizer;
+    pipelineInfo.pMultisampleState = &multisampling;
+    pipelineInfo.pColorBlendState = &colorBlending;
+    pipelineInfo.pDepthStencilState = &depthStencil;
+    pipelineInfo.pDynamicState = &dynamicState;
+    pipelineInfo.layout = key.layout;
+    pipelineInfo.renderPass = key.renderPass;
+    pipelineInfo.subpass = 0;
+
+    // Without a render pass the attachment formats are declared on the pipeline itself
+    VkPipelineRenderingCreateInfo renderingInfo = {};
+    renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+    renderingInfo.colorAttachmentCount = 1;
+    renderingInfo.pColorAttachmentFormats = &key.colorFormat;
+    renderingInfo.depthAttachmentFormat = key.depthFormat;
+    if (!key.renderPass) pipelineInfo.pNext = &renderingInfo;
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    Uint64 start = SDL_GetPerformanceCounter();
+    VkResult result = vkCreateGraphicsPipelines(ctx.device, cache, 1, &pipelineInfo, nullptr, &pipeline);
+    if (outCreateMs) {
+        *outCreateMs = (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / (double)SDL_GetPerformanceFrequency();
+    }
+    if (fragShaderModule) vkDestroyShaderModule(ctx.device, fragShaderModule, nullptr);
+    vkDestroyShaderModule(ctx.device, vertShaderModule, nullptr);
+    if (result != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create graphics pipeline");
+        throw std::runtime_error("Graphics pipeline creation failed");
+    }
+    return pipeline;
+}
+
+// Module file name the reloader watches for a SPIR-V path: "shaders/tri.vert.spv" -> "tri.vert"
+static std::string reload_source(const std::string& path) {
+    std::string name = path.substr(path.find_last_of("/\\") + 1);
+    if (name.size() > 4 && name.compare(name.size() - 4, 4, ".spv") == 0) name.resize(name.size() - 4);
+    return name;
+}
+
+// The reloader rebuilds the entry in place, so every user of the id picks up the new pipeline
+static void register_reload(VSDL_Context& ctx, VSDL_PipelineId id) {
+    VSDL_PipelineEntry& entry = ctx.pipelineLibrary.entries[id];
+    std::string vert = reload_source(shader_path(ctx, entry.key.vertShader));
+    std::string frag = entry.key.fragShader == VSDL_NO_SHADER ? vert : reload_source(shader_path(ctx, entry.key.fragShader));
+    VSDL_PipelineKey key = entry.key;
+    vsdl_shader_reload_register(ctx, { vert.c_str(), frag.c_str() }, &entry.pipeline,
+                                [key](VSDL_Context& ctx) { return vsdl_build_pipeline(ctx, key, ctx.pipelineCache); });
+}
+
+std::vector<VSDL_PipelineId> vsdl_prewarm_pipelines(VSDL_Context& ctx, const std::vector<VSDL_PipelineKey>& keys) {
+    VSDL_PipelineLibrary& library = ctx.pipelineLibrary;
+    std::vector<VSDL_PipelineId> ids(keys.size());
+    std::vector<VSDL_PipelineId> misses;
+    {
+        std::lock_guard<std::mutex> lock(library.mutex);
+        for (size_t i = 0; i < keys.size(); i++) {
+            auto it = library.ids.find(keys[i]);
+            if (it != library.ids.end()) {
+                ids[i] = it->second;
+                library.hits++;
+                continue;
+            }
+            ids[i] = (VSDL_PipelineId)library.entries.size();
+            library.entries.push_back({ keys[i], VK_NULL_HANDLE });
+            library.ids.emplace(keys[i], ids[i]);
+            misses.push_back(ids[i]);
+        }
+    }
+    if (misses.empty()) return ids;
+
+    // Each job fills a distinct entry; the pipeline cache is internally synchronized
+    Uint64 start = SDL_GetPerformanceCounter();
+    std::vector<std::exception_ptr> errors(misses.size());
+    auto build = [&ctx, &library, &misses, &errors](uint32_t i) {
+        try {
+            library.entries[misses[i]].pipeline = vsdl_build_pipeline(ctx, library.entries[misses[i]].key, ctx.pipelineCache);
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    };
+    uint32_t workerCount = std::min((uint32_t)misses.size(), std::max(1u, std::thread::hardware_concurrency()));
+    if (workerCount > 1) {
+        VSDL_JobSystem* jobs = vsdl_create_job_system(workerCount);
+        vsdl_jobs_dispatch(jobs, (uint32_t)misses.size(), build);
+        vsdl_jobs_wait(jobs);
+        vsdl_destroy_job_system(jobs);
+    } else {
+        for (uint32_t i = 0; i < (uint32_t)misses.size(); i++) build(i);
+    }
+    // A failed key is unpublished so the next request retries it instead of hitting a null pipeline; its
+    // slot in entries stays, since ids index that vector
+    std::exception_ptr firstError;
+    for (size_t i = 0; i < misses.size(); i++) {
+        if (!errors[i]) {
+            register_reload(ctx, misses[i]);
+            continue;
+        }
+        if (!firstError) firstError = errors[i];
+        std::lock_guard<std::mutex> lock(library.mutex);
+        library.ids.erase(library.entries[misses[i]].key);
+    }
+    if (firstError) std::rethrow_exception(firstError);
+
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Built %u pipeline(s) on %u thread(s) in %.3f ms (%s pipeline cache)",
+                (uint32_t)misses.size(), workerCount,
+                (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / (double)SDL_GetPerformanceFrequency(),
+                ctx.pipelineCacheWarm ? "warm" : "cold");
+    return ids;
+}
+
+VSDL_PipelineId vsdl_get_pipeline(VSDL_Context& ctx, const VSDL_PipelineKey& key) {
+    return vsdl_prewarm_pipelines(ctx, { key })[0];
+}
+
+void vsdl_destroy_pipeline_library(VSDL_Context& ctx) {
+    VSDL_PipelineLibrary& library = ctx.pipelineLibrary;
+    for (const auto& entry : library.entries) {
+        if (entry.pipeline) vkDestroyPipeline(ctx.device, entry.pipeline, nullptr);
+    }
+    if (!library.entries.empty()) {
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Pipeline library: %u pipelines, %u requests deduplicated",
+                    (uint32_t)library.entries.size(), library.hits);
+    }
+    library.entries.clear();
+    library.ids.clear();
+    library.shaders.clear();
+    library.hits = 0;
+}
+
+VkPipeline vsdl_build_compute_pipeline(VSDL_Context& ctx, const std::string& path, VkPipelineLayout layout, VkPipelineCache cache) {
+    VkShaderModule shaderModule = vsdl_create_shader_module(ctx, path);
+
+    VkComputePipelineCreateInfo pipelineInfo = {};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = shaderModule;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.layout = layout;
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    VkResult result = vkCreateComputePipelines(ctx.device, cache, 1, &pipelineInfo, nullptr, &pipeline);
+    vkDestroyShaderModule(ctx.device, shaderModule, nullptr);
+    if (result != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create compute pipeline %s", path.c_str());
+        throw std::runtime_error("Compute pipeline creation failed");
+    }
+    return pipeline;
+}
+
+// Triangle pipeline and ImGui, shared by both rendering paths
+static void create_scene_pipeline(VSDL_Context& ctx) {
+    std::vector<VSDL_PipelineKey> keys = { vsdl_pipeline_key(ctx, "shaders/tri.vert.spv", "shaders/tri.frag.spv", ctx.pipelineLayout) };
+    if (ctx.depthPrepass) keys.push_back(vsdl_pipeline_key(ctx, "shaders/tri.vert.spv", std::string(), ctx.pipelineLayout));
+    std::vector<VSDL_PipelineId> ids = vsdl_prewarm_pipelines(ctx, keys);
+    ctx.graphicsPipeline = ids[0];
+    if (ctx.depthPrepass) ctx.depthPipeline = ids[1];
+
+    // Initialize ImGui
+    if (!vsdl::init_imgui(ctx)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to initialize ImGui");
+        throw std::runtime_error("ImGui initialization failed");
+    }
+    vsdl_create_ui_cache(ctx);
+}
+
+// Reverse-Z wants a float format; D32_SFLOAT is nearly universal, the stencil variant covers the rest.
+// Formats the depth pyramid can also sample come first; without one occlusion culling is left off.
+static VkFormat choose_depth_format(VSDL_Context& ctx) {
+    const VkFormat candidates[] = { VK_FORMAT_D32_SFLOAT, VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D24_UNORM_S8_UINT };
+    const VkFormatFeatureFlags sampled = VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT;
+    for (VkFormatFeatureFlags required : { sampled, (VkFormatFeatureFlags)VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT }) {
+        for (VkFormat format : candidates) {
+            VkFormatProperties properties;
+            vkGetPhysicalDeviceFormatProperties(ctx.physicalDevice, format, &properties);
+            if ((properties.optimalTilingFeatures & required) != required) continue;
+            if (format == VK_FORMAT_D24_UNORM_S8_UINT) {
+                SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "No float depth format, reverse-Z falls back to 24-bit fixed point");
+            }
+            ctx.depthSampled = required == sampled;
+            if (!ctx.depthSampled) {
+                SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "No sampleable depth format, occlusion culling is unavailable");
+            }
+            return format;
+        }
+    }
+    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "No supported depth attachment format");
+    throw std::runtime_error("Depth format selection failed");
+}
+
+void vsdl_create_pipeline(VSDL_Context& ctx) {
+    ctx.depthFormat = choose_depth_format(ctx);
+
+    // Set 0 is the bindless table when available, bound once per frame; the camera matrix is pushed
+    VkPushConstantRange pushRange = {};
+    pushRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    pushRange.size = sizeof(glm::mat4);
     VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
     pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushRange;
+    if (ctx.descriptors.bindless) {
+        pipelineLayoutInfo.setLayoutCount = 1;
+        pipelineLayoutInfo.pSetLayouts = &ctx.descriptors.bindlessLayout;
+    }
     if (vkCreatePipelineLayout(ctx.device, &pipelineLayoutInfo, nullptr, &ctx.pipelineLayout) != VK_SUCCESS) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create pipeline layout");
         throw std::runtime_error("Pipeline layout creation failed");
     }
 
+    if (ctx.dynamicRendering.enabled) {
+        // No render pass or framebuffers: attachments are bound per frame by vkCmdBeginRendering
+        create_scene_pipeline(ctx);
+        return;
+    }
+
     VkAttachmentDescription colorAttachment = {};
     colorAttachment.format = ctx.swapchainImageFormat;
     colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
@@ -120,72 +443,59 @@ void vsdl_create_pipeline(VSDL_Context& ctx) {
     colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    colorAttachment.finalLayout = ctx.headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+    // Cleared on load and stored, so the depth pyramid can reduce it after the pass; stencil is unused
+    VkAttachmentDescription depthAttachment = {};
+    depthAttachment.format = ctx.depthFormat;
+    depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE; // Reduced into the depth pyramid after the pass
+    depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
     VkAttachmentReference colorAttachmentRef = {};
     colorAttachmentRef.attachment = 0;
     colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    VkAttachmentReference depthAttachmentRef = {};
+    depthAttachmentRef.attachment = 1;
+    depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
     VkSubpassDescription subpass = {};
     subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
     subpass.colorAttachmentCount = 1;
     subpass.pColorAttachments = &colorAttachmentRef;
+    subpass.pDepthStencilAttachment = &depthAttachmentRef;
 
+    // The layout transition must wait for the acquire semaphore, which is waited at COLOR_ATTACHMENT_OUTPUT.
+    // The single depth image is shared by all frames in flight, so its clear also waits for the previous
+    // frame's depth writes and depth pyramid reads.
+    VkSubpassDependency dependency = {};
+    dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependency.dstSubpass = 0;
+    dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                              VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    dependency.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+    dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+    VkAttachmentDescription attachments[] = { colorAttachment, depthAttachment };
     VkRenderPassCreateInfo renderPassInfo = {};
     renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-    renderPassInfo.attachmentCount = 1;
-    renderPassInfo.pAttachments = &colorAttachment;
+    renderPassInfo.attachmentCount = 2;
+    renderPassInfo.pAttachments = attachments;
     renderPassInfo.subpassCount = 1;
     renderPassInfo.pSubpasses = &subpass;
+    renderPassInfo.dependencyCount = 1;
+    renderPassInfo.pDependencies = &dependency;
 
     if (vkCreateRenderPass(ctx.device, &renderPassInfo, nullptr, &ctx.renderPass) != VK_SUCCESS) {
         SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create render pass");
         throw std::runtime_error("Render pass creation failed");
     }
 
-    VkGraphicsPipelineCreateInfo pipelineInfo = {};
-    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-    pipelineInfo.stageCount = 2;
-    pipelineInfo.pStages = shaderStages;
-    pipelineInfo.pVertexInputState = &vertexInputInfo;
-    pipelineInfo.pInputAssemblyState = &inputAssembly;
-    pipelineInfo.pViewportState = &viewportState;
-    pipelineInfo.pRasterizationState = &rasterizer;
-    pipelineInfo.pMultisampleState = &multisampling;
-    pipelineInfo.pColorBlendState = &colorBlending;
-    pipelineInfo.layout = ctx.pipelineLayout;
-    pipelineInfo.renderPass = ctx.renderPass;
-    pipelineInfo.subpass = 0;
-
-    if (vkCreateGraphicsPipelines(ctx.device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &ctx.graphicsPipeline) != VK_SUCCESS) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create graphics pipeline");
-        throw std::runtime_error("Graphics pipeline creation failed");
-    }
-
-    vkDestroyShaderModule(ctx.device, fragShaderModule, nullptr);
-    vkDestroyShaderModule(ctx.device, vertShaderModule, nullptr);
-
-    ctx.framebuffers.resize(ctx.swapchainImageViews.size());
-    for (size_t i = 0; i < ctx.swapchainImageViews.size(); i++) {
-        VkImageView attachments[] = { ctx.swapchainImageViews[i] };
-        VkFramebufferCreateInfo framebufferInfo = {};
-        framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-        framebufferInfo.renderPass = ctx.renderPass;
-        framebufferInfo.attachmentCount = 1;
-        framebufferInfo.pAttachments = attachments;
-        framebufferInfo.width = ctx.swapchainExtent.width;
-        framebufferInfo.height = ctx.swapchainExtent.height;
-        framebufferInfo.layers = 1;
-
-        if (vkCreateFramebuffer(ctx.device, &framebufferInfo, nullptr, &ctx.framebuffers[i]) != VK_SUCCESS) {
-            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create framebuffer %zu", i);
-            throw std::runtime_error("Framebuffer creation failed");
-        }
-    }
-
-    // Initialize ImGui
-    if (!vsdl::init_imgui(ctx)) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to initialize ImGui");
-        throw std::runtime_error("ImGui initialization failed");
-    }
+    if (!ctx.swapchainImageViews.empty()) vsdl_create_framebuffers(ctx); // Else deferred with the swapchain
+    create_scene_pipeline(ctx);
 }
\ No newline at end of file
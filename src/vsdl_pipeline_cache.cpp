@@ -0,0 +1,147 @@
+#include "vsdl_pipeline_cache.h"
+#include "vsdl_pipeline.h"
+#include <SDL3/SDL_log.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+// Returns true when the blob was produced by this driver/device and can be fed back to it
+static bool validate_cache_header(VSDL_Context& ctx, const std::vector<char>& blob) {
+    VkPipelineCacheHeaderVersionOne header;
+    if (blob.size() < sizeof(header)) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Pipeline cache: blob too small (%zu bytes)", blob.size());
+        return false;
+    }
+    memcpy(&header, blob.data(), sizeof(header));
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(ctx.physicalDevice, &properties);
+
+    if (header.headerSize < sizeof(header) || header.headerSize > blob.size()) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Pipeline cache: invalid header size %u", header.headerSize);
+        return false;
+    }
+    if (header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Pipeline cache: unsupported header version %u", (uint32_t)header.headerVersion);
+        return false;
+    }
+    if (header.vendorID != properties.vendorID || header.deviceID != properties.deviceID) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Pipeline cache: written for device %04x:%04x, running on %04x:%04x",
+                    header.vendorID, header.deviceID, properties.vendorID, properties.deviceID);
+        return false;
+    }
+    if (memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Pipeline cache: UUID mismatch (driver changed)");
+        return false;
+    }
+    return true;
+}
+
+bool vsdl_create_pipeline_cache(VSDL_Context& ctx) {
+    std::vector<char> blob;
+    std::ifstream file(ctx.pipelineCachePath, std::ios::ate | std::ios::binary);
+    if (file.is_open()) {
+        size_t fileSize = (size_t)file.tellg();
+        blob.resize(fileSize);
+        file.seekg(0);
+        file.read(blob.data(), fileSize);
+        file.close();
+        if (!validate_cache_header(ctx, blob)) blob.clear();
+    } else {
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Pipeline cache: no cache at %s, starting cold", ctx.pipelineCachePath.c_str());
+    }
+
+    VkPipelineCacheCreateInfo cacheInfo = {};
+    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cacheInfo.initialDataSize = blob.size();
+    cacheInfo.pInitialData = blob.empty() ? nullptr : blob.data();
+
+    VkResult result = vkCreatePipelineCache(ctx.device, &cacheInfo, nullptr, &ctx.pipelineCache);
+    if (result != VK_SUCCESS && !blob.empty()) {
+        // The driver may still reject data that passed the header check
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Pipeline cache: driver rejected cached data, starting cold");
+        blob.clear();
+        cacheInfo.initialDataSize = 0;
+        cacheInfo.pInitialData = nullptr;
+        result = vkCreatePipelineCache(ctx.device, &cacheInfo, nullptr, &ctx.pipelineCache);
+    }
+    if (result != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create pipeline cache");
+        return false;
+    }
+
+    ctx.pipelineCacheWarm = !blob.empty();
+    if (ctx.pipelineCacheWarm) {
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Pipeline cache: loaded %zu bytes from %s", blob.size(), ctx.pipelineCachePath.c_str());
+    }
+    return true;
+}
+
+void vsdl_save_pipeline_cache(VSDL_Context& ctx) {
+    if (!ctx.pipelineCache) return;
+
+    size_t dataSize = 0;
+    if (vkGetPipelineCacheData(ctx.device, ctx.pipelineCache, &dataSize, nullptr) != VK_SUCCESS || dataSize == 0) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Pipeline cache: nothing to save");
+        return;
+    }
+    std::vector<char> blob(dataSize);
+    if (vkGetPipelineCacheData(ctx.device, ctx.pipelineCache, &dataSize, blob.data()) != VK_SUCCESS) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Pipeline cache: failed to read cache data");
+        return;
+    }
+
+    // Write to a temporary file and rename over the old one so a crash never leaves a torn cache
+    std::string tempPath = ctx.pipelineCachePath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Pipeline cache: failed to open %s for writing", tempPath.c_str());
+            return;
+        }
+        file.write(blob.data(), dataSize);
+        file.flush();
+        if (!file.good()) {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Pipeline cache: failed to write %s", tempPath.c_str());
+            return;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, ctx.pipelineCachePath, error);
+    if (error) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Pipeline cache: failed to replace %s: %s", ctx.pipelineCachePath.c_str(), error.message().c_str());
+        std::filesystem::remove(tempPath, error);
+        return;
+    }
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Pipeline cache: saved %zu bytes to %s", dataSize, ctx.pipelineCachePath.c_str());
+}
+
+void vsdl_destroy_pipeline_cache(VSDL_Context& ctx) {
+    if (ctx.pipelineCache) {
+        vkDestroyPipelineCache(ctx.device, ctx.pipelineCache, nullptr);
+        ctx.pipelineCache = VK_NULL_HANDLE;
+    }
+}
+
+void vsdl_benchmark_pipeline_cache(VSDL_Context& ctx) {
+    // A private empty cache gives a cold build; building again against the same cache is warm.
+    // Drivers with their own on-disk shader cache (e.g. Mesa) may make the cold number optimistic.
+    VkPipelineCacheCreateInfo cacheInfo = {};
+    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    VkPipelineCache cache;
+    if (vkCreatePipelineCache(ctx.device, &cacheInfo, nullptr, &cache) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create benchmark pipeline cache");
+        return;
+    }
+
+    double coldMs = 0.0, warmMs = 0.0;
+    VSDL_PipelineKey key = vsdl_pipeline_key(ctx, "shaders/tri.vert.spv", "shaders/tri.frag.spv", ctx.pipelineLayout);
+    VkPipeline pipeline = vsdl_build_pipeline(ctx, key, cache, &coldMs);
+    vkDestroyPipeline(ctx.device, pipeline, nullptr);
+    pipeline = vsdl_build_pipeline(ctx, key, cache, &warmMs);
+    vkDestroyPipeline(ctx.device, pipeline, nullptr);
+    vkDestroyPipelineCache(ctx.device, cache, nullptr);
+
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Pipeline cache benchmark: cold %.3f ms, warm %.3f ms", coldMs, warmMs);
+}
\ No newline at end of file
@@ -0,0 +1,230 @@
+#include "vsdl_profiler.h"
+#include "imgui.h"
+#include <SDL3/SDL_log.h>
+#include <SDL3/SDL_timer.h>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// Bounds trace memory to ~16 MB for long captures
+#define VSDL_PROFILER_MAX_TRACE_EVENTS 500000
+
+static double now_us(VSDL_Context& ctx) {
+    return (double)(SDL_GetPerformanceCounter() - ctx.profiler.epoch) * 1e6 / (double)SDL_GetPerformanceFrequency();
+}
+
+static uint32_t find_track(VSDL_Context& ctx, const char* name, bool gpu) {
+    std::lock_guard<std::recursive_mutex> lock(ctx.profiler.mutex);
+    auto& tracks = ctx.profiler.tracks;
+    for (uint32_t i = 0; i < tracks.size(); i++) {
+        if (tracks[i].gpu == gpu && (tracks[i].name == name || strcmp(tracks[i].name, name) == 0)) return i;
+    }
+    VSDL_ProfilerTrack track;
+    track.name = name;
+    track.gpu = gpu;
+    tracks.push_back(track);
+    return (uint32_t)tracks.size() - 1;
+}
+
+static void push_sample(VSDL_Context& ctx, uint32_t trackIndex, float ms, double startUs) {
+    VSDL_Profiler& profiler = ctx.profiler;
+    VSDL_ProfilerTrack& track = profiler.tracks[trackIndex];
+    track.history[track.head] = ms;
+    track.head = (track.head + 1) % VSDL_PROFILER_HISTORY;
+    track.lastMs = ms;
+
+    if (profiler.tracePath.empty()) return;
+    if (profiler.traceEvents.size() >= VSDL_PROFILER_MAX_TRACE_EVENTS) return;
+    profiler.traceEvents.push_back({ track.name, track.gpu, startUs, (double)ms * 1000.0 });
+    if (profiler.traceEvents.size() == VSDL_PROFILER_MAX_TRACE_EVENTS) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Profiler: trace buffer full, later events are dropped");
+    }
+}
+
+void vsdl_create_profiler(VSDL_Context& ctx) {
+    VSDL_Profiler& profiler = ctx.profiler;
+    profiler.epoch = SDL_GetPerformanceCounter();
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(ctx.physicalDevice, &properties);
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(ctx.physicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(ctx.physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+    uint32_t validBits = queueFamilies[ctx.graphicsQueueFamilyIndex].timestampValidBits;
+    if (validBits == 0 || properties.limits.timestampPeriod <= 0.0f) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Profiler: no timestamp support on the graphics queue, GPU scopes disabled");
+        return;
+    }
+
+    VkQueryPoolCreateInfo queryInfo = {};
+    queryInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    queryInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    queryInfo.queryCount = 2 * VSDL_PROFILER_MAX_SCOPES * VSDL_MAX_FRAMES_IN_FLIGHT;
+    if (vkCreateQueryPool(ctx.device, &queryInfo, nullptr, &profiler.queryPool) != VK_SUCCESS) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Profiler: failed to create timestamp query pool, GPU scopes disabled");
+        return;
+    }
+    profiler.timestampPeriod = properties.limits.timestampPeriod;
+    profiler.timestampMask = validBits >= 64 ? ~0ull : ((1ull << validBits) - 1);
+}
+
+void vsdl_destroy_profiler(VSDL_Context& ctx) {
+    if (ctx.profiler.queryPool) {
+        vkDestroyQueryPool(ctx.device, ctx.profiler.queryPool, nullptr);
+        ctx.profiler.queryPool = VK_NULL_HANDLE;
+    }
+}
+
+void vsdl_profiler_begin_frame(VSDL_Context& ctx, VkCommandBuffer commandBuffer, uint32_t frameSlot) {
+    VSDL_Profiler& profiler = ctx.profiler;
+    VSDL_ProfilerFrame& frame = profiler.frames[frameSlot];
+    profiler.recordingSlot = frameSlot;
+    frame.scopeCount = 0;
+    frame.queryCount = 0;
+    frame.openCount = 0;
+    frame.cpuStartUs = now_us(ctx);
+    frame.pending = profiler.queryPool != VK_NULL_HANDLE;
+    if (profiler.queryPool) {
+        vkCmdResetQueryPool(commandBuffer, profiler.queryPool, frameSlot * 2 * VSDL_PROFILER_MAX_SCOPES, 2 * VSDL_PROFILER_MAX_SCOPES);
+    }
+}
+
+void vsdl_gpu_scope_begin(VSDL_Context& ctx, VkCommandBuffer commandBuffer, const char* name) {
+    VSDL_Profiler& profiler = ctx.profiler;
+    if (!profiler.queryPool) return;
+    VSDL_ProfilerFrame& frame = profiler.frames[profiler.recordingSlot];
+    if (frame.openCount >= VSDL_PROFILER_MAX_SCOPES) return;
+
+    if (frame.scopeCount >= VSDL_PROFILER_MAX_SCOPES) {
+        frame.openScopes[frame.openCount++] = UINT32_MAX; // Out of queries: keep begin/end balanced
+        return;
+    }
+    uint32_t base = profiler.recordingSlot * 2 * VSDL_PROFILER_MAX_SCOPES;
+    VSDL_ProfilerGpuScope& scope = frame.scopes[frame.scopeCount];
+    scope.track = find_track(ctx, name, true);
+    scope.beginQuery = base + frame.queryCount++;
+    scope.endQuery = base + frame.queryCount++;
+    frame.openScopes[frame.openCount++] = frame.scopeCount++;
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, profiler.queryPool, scope.beginQuery);
+}
+
+void vsdl_gpu_scope_end(VSDL_Context& ctx, VkCommandBuffer commandBuffer) {
+    VSDL_Profiler& profiler = ctx.profiler;
+    if (!profiler.queryPool) return;
+    VSDL_ProfilerFrame& frame = profiler.frames[profiler.recordingSlot];
+    if (frame.openCount == 0) return;
+
+    uint32_t scopeIndex = frame.openScopes[--frame.openCount];
+    if (scopeIndex == UINT32_MAX) return;
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, profiler.queryPool, frame.scopes[scopeIndex].endQuery);
+}
+
+void vsdl_profiler_resolve(VSDL_Context& ctx, uint32_t frameSlot) {
+    std::lock_guard<std::recursive_mutex> lock(ctx.profiler.mutex);
+    VSDL_Profiler& profiler = ctx.profiler;
+    VSDL_ProfilerFrame& frame = profiler.frames[frameSlot];
+    if (!frame.pending || frame.queryCount == 0) return;
+    frame.pending = false;
+
+    // No WAIT flag: the fence guarantees availability, and a missing result must never stall the frame
+    uint64_t timestamps[2 * VSDL_PROFILER_MAX_SCOPES];
+    uint32_t base = frameSlot * 2 * VSDL_PROFILER_MAX_SCOPES;
+    if (vkGetQueryPoolResults(ctx.device, profiler.queryPool, base, frame.queryCount, sizeof(timestamps), timestamps,
+                              sizeof(uint64_t), VK_QUERY_RESULT_64_BIT) != VK_SUCCESS) {
+        return;
+    }
+
+    // GPU ticks have no fixed relation to the CPU clock: anchor the first scope at the record start
+    uint64_t origin = timestamps[frame.scopes[0].beginQuery - base];
+    for (uint32_t i = 0; i < frame.scopeCount; i++) {
+        const VSDL_ProfilerGpuScope& scope = frame.scopes[i];
+        uint64_t begin = timestamps[scope.beginQuery - base];
+        uint64_t end = timestamps[scope.endQuery - base];
+        double ms = (double)((end - begin) & profiler.timestampMask) * profiler.timestampPeriod / 1e6;
+        double startUs = frame.cpuStartUs + (double)((begin - origin) & profiler.timestampMask) * profiler.timestampPeriod / 1e3;
+        push_sample(ctx, scope.track, (float)ms, startUs);
+    }
+}
+
+void vsdl_profiler_cpu_scope(VSDL_Context& ctx, const char* name, Uint64 start) {
+    std::lock_guard<std::recursive_mutex> lock(ctx.profiler.mutex);
+    Uint64 end = SDL_GetPerformanceCounter();
+    double frequency = (double)SDL_GetPerformanceFrequency();
+    float ms = (float)((double)(end - start) * 1000.0 / frequency);
+    double startUs = (double)(start - ctx.profiler.epoch) * 1e6 / frequency;
+    push_sample(ctx, find_track(ctx, name, false), ms, startUs);
+}
+
+float vsdl_profiler_last_ms(VSDL_Context& ctx, const char* name) {
+    std::lock_guard<std::recursive_mutex> lock(ctx.profiler.mutex);
+    for (const auto& track : ctx.profiler.tracks) {
+        if (strcmp(track.name, name) == 0) return track.lastMs;
+    }
+    return 0.0f;
+}
+
+void vsdl_profiler_draw_ui(VSDL_Context& ctx, bool& open) {
+    VSDL_Profiler& profiler = ctx.profiler;
+    if (!open) return;
+
+    ImGui::Begin("Profiler", &open);
+    std::lock_guard<std::recursive_mutex> lock(ctx.profiler.mutex);
+    for (int gpu = 0; gpu < 2; gpu++) {
+        ImGui::SeparatorText(gpu ? "GPU" : "CPU");
+        if (gpu && !profiler.queryPool) {
+            ImGui::TextDisabled("Timestamps unsupported");
+            continue;
+        }
+        for (uint32_t i = 0; i < profiler.tracks.size(); i++) {
+            const VSDL_ProfilerTrack& track = profiler.tracks[i];
+            if (track.gpu != (gpu != 0)) continue;
+
+            float sum = 0.0f, peak = 0.0f;
+            for (float sample : track.history) {
+                sum += sample;
+                if (sample > peak) peak = sample;
+            }
+            ImGui::PushID((int)i);
+            ImGui::Text("%-12s %7.3f ms  avg %7.3f  max %7.3f", track.name, track.lastMs, sum / VSDL_PROFILER_HISTORY, peak);
+            ImGui::PlotHistogram("##history", track.history, VSDL_PROFILER_HISTORY, (int)track.head, nullptr,
+                                 0.0f, peak > 0.0f ? peak * 1.2f : 1.0f, ImVec2(-1.0f, 32.0f));
+            ImGui::PopID();
+        }
+    }
+    if (!profiler.tracePath.empty()) {
+        ImGui::Separator();
+        ImGui::Text("Trace: %zu events", profiler.traceEvents.size());
+        ImGui::SameLine();
+        if (ImGui::Button("Save")) vsdl_profiler_write_trace(ctx, profiler.tracePath);
+    }
+    ImGui::End();
+}
+
+bool vsdl_profiler_write_trace(VSDL_Context& ctx, const std::string& path) {
+    std::lock_guard<std::recursive_mutex> lock(ctx.profiler.mutex);
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Profiler: failed to open %s for writing", path.c_str());
+        return false;
+    }
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},\n");
+    fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}");
+    for (const auto& event : ctx.profiler.traceEvents) {
+        fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                event.name, event.gpu ? "gpu" : "cpu", event.gpu ? 2 : 1, event.startUs, event.durationUs);
+    }
+    fprintf(file, "\n]}\n");
+    bool ok = ferror(file) == 0;
+    fclose(file);
+
+    if (ok) {
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Profiler: wrote %zu events to %s", ctx.profiler.traceEvents.size(), path.c_str());
+    } else {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Profiler: failed to write %s", path.c_str());
+    }
+    return ok;
+}
\ No newline at end of file
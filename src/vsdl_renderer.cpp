@@ -1,132 +1,539 @@
 #include "vsdl_renderer.h"
+#include "vsdl_memory.h"
+#include "vsdl_mesh.h"
+#include "vsdl_instancing.h"
+#include "vsdl_depth_pyramid.h"
+#include "vsdl_particles.h"
+#include "vsdl_parallel.h"
+#include "vsdl_graph.h"
+#include "vsdl_pipeline.h"
+#include "vsdl_shader_reload.h"
+#include "vsdl_descriptors.h"
+#include "vsdl_frame_arena.h"
+#include "vsdl_texture_stream.h"
+#include "vsdl_sync.h"
+#include "vsdl_profiler.h"
+#include "vsdl_upload.h"
 #include "vsdl_imgui.h"
+#include "vsdl_swapchain.h"
+#include "vsdl_transforms.h"
+#include "vsdl_ui_cache.h"
 #include "imgui.h"
 #include "imgui_impl_sdl3.h"
 #include "imgui_impl_vulkan.h"
 #include <SDL3/SDL_log.h>
+#include <SDL3/SDL_timer.h>
+#include <glm/gtc/type_ptr.hpp>
 #include <stdexcept>
 
-void vsdl_render_loop(VSDL_Context& ctx) {
-    VkCommandPoolCreateInfo poolInfo = {};
-    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-    poolInfo.queueFamilyIndex = ctx.graphicsQueueFamilyIndex; // Use the stored index
-    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-    if (vkCreateCommandPool(ctx.device, &poolInfo, nullptr, &ctx.commandPool) != VK_SUCCESS) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create command pool");
-        throw std::runtime_error("Command pool creation failed");
-    }
+void vsdl_create_frames(VSDL_Context& ctx) {
+    if (ctx.framesInFlight < 1) ctx.framesInFlight = 1;
+    if (ctx.framesInFlight > VSDL_MAX_FRAMES_IN_FLIGHT) ctx.framesInFlight = VSDL_MAX_FRAMES_IN_FLIGHT;
 
-    VkCommandBufferAllocateInfo allocInfo = {};
-    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocInfo.commandPool = ctx.commandPool;
-    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandBufferCount = 1;
-    if (vkAllocateCommandBuffers(ctx.device, &allocInfo, &ctx.commandBuffer) != VK_SUCCESS) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate command buffer");
-        throw std::runtime_error("Command buffer allocation failed");
+    if (!ctx.commandPool) {
+        VkCommandPoolCreateInfo poolInfo = {};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.queueFamilyIndex = ctx.graphicsQueueFamilyIndex; // Use the stored index
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        if (vkCreateCommandPool(ctx.device, &poolInfo, nullptr, &ctx.commandPool) != VK_SUCCESS) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create command pool");
+            throw std::runtime_error("Command pool creation failed");
+        }
     }
 
     VkSemaphoreCreateInfo semaphoreInfo = {};
     semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
-    if (vkCreateSemaphore(ctx.device, &semaphoreInfo, nullptr, &ctx.imageAvailableSemaphore) != VK_SUCCESS ||
-        vkCreateSemaphore(ctx.device, &semaphoreInfo, nullptr, &ctx.renderFinishedSemaphore) != VK_SUCCESS) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create semaphores");
-        throw std::runtime_error("Semaphore creation failed");
+
+    for (uint32_t i = 0; i < ctx.framesInFlight; i++) {
+        VSDL_Frame& frame = ctx.frames[i];
+
+        VkCommandBufferAllocateInfo allocInfo = {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = ctx.commandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+        if (vkAllocateCommandBuffers(ctx.device, &allocInfo, &frame.commandBuffer) != VK_SUCCESS) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate command buffer for frame %u", i);
+            throw std::runtime_error("Command buffer allocation failed");
+        }
+
+        if (vkCreateSemaphore(ctx.device, &semaphoreInfo, nullptr, &frame.imageAvailableSemaphore) != VK_SUCCESS) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create acquire semaphore for frame %u", i);
+            throw std::runtime_error("Semaphore creation failed");
+        }
     }
 
-    VkFenceCreateInfo fenceInfo = {};
-    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-    if (vkCreateFence(ctx.device, &fenceInfo, nullptr, &ctx.inFlightFence) != VK_SUCCESS) {
-        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create fence");
-        throw std::runtime_error("Fence creation failed");
+    ctx.currentFrame = 0;
+
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Created %u frames in flight for %zu swapchain images",
+                ctx.framesInFlight, ctx.swapchainImages.size());
+}
+
+void vsdl_destroy_frames(VSDL_Context& ctx) {
+    for (uint32_t i = 0; i < VSDL_MAX_FRAMES_IN_FLIGHT; i++) {
+        VSDL_Frame& frame = ctx.frames[i];
+        if (frame.imageAvailableSemaphore) vkDestroySemaphore(ctx.device, frame.imageAvailableSemaphore, nullptr);
+        if (frame.commandBuffer) vkFreeCommandBuffers(ctx.device, ctx.commandPool, 1, &frame.commandBuffer);
+        frame = VSDL_Frame{};
+    }
+    ctx.imagesInFlight.assign(ctx.imagesInFlight.size(), 0);
+    ctx.currentFrame = 0;
+}
+
+void vsdl_build_ui(VSDL_Context& ctx, VSDL_UiSettings* settings) {
+    if (!settings) settings = &ctx.uiSettings;
+    // No ImGui_ImplVulkan_NewFrame: all it does is create the font texture behind a vkQueueWaitIdle,
+    // and ours is streamed in init_imgui
+    ImGui_ImplSDL3_NewFrame();
+    ImGui::NewFrame();
+
+    // Example ImGui UI
+    ImGui::Begin("Test Window");
+    ImGui::Text("Hello, ImGui with Vulkan!");
+    ImGui::Text("Frames in flight: %u", ctx.framesInFlight);
+    if (ctx.headless) {
+        ImGui::Text("Headless %ux%u", ctx.swapchainExtent.width, ctx.swapchainExtent.height);
+    } else {
+        ImGui::Text("Present mode: %s", vsdl_present_mode_name(ctx.presentMode));
+    }
+    if (ctx.instancing.instanceCount > 0) {
+        ImGui::Text("Instances: %u", ctx.instancing.instanceCount);
+        ImGui::Checkbox("Occlusion culling", &settings->occlusionCulling);
+    }
+    if (ctx.particles.count > 0) {
+        ImGui::Text("Particles: %u (%s)", ctx.particles.count, ctx.particles.async ? "async compute queue" : "graphics queue");
+    }
+    if (ctx.parallel.objects.count > 0) {
+        ImGui::Text("Draws: %u on %u worker(s)", ctx.parallel.objects.count, ctx.parallel.workerCount);
+    }
+    if (ctx.shaderReloader) ImGui::Text("Shader reload: %s", vsdl_shader_reload_status(ctx).c_str());
+    // Numbers that change every frame. Closed by default: while they are on screen the UI never holds still,
+    // so the cached UI modes have nothing to reuse.
+    if (ImGui::CollapsingHeader("Statistics")) {
+        // Only ctx.frameStats: the fields it mirrors belong to whichever thread records frames
+        const VSDL_FrameStats& stats = ctx.frameStats;
+        ImGui::Text("%.2f ms/frame (%.1f FPS), record %.3f ms", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate,
+                    stats.recordMs.load(std::memory_order_relaxed));
+        if (ctx.instancing.instanceCount > 0) {
+            ImGui::Text("Visible %u, frustum culled %u, occluded %u", stats.visibleInstances.load(std::memory_order_relaxed),
+                        stats.frustumCulled.load(std::memory_order_relaxed), stats.occlusionCulled.load(std::memory_order_relaxed));
+        }
+        ImGui::Text("Frame arena: %.1f KB CPU, %.1f KB GPU (peak %.1f / %.1f KB)",
+                    stats.arenaCpuBytes.load(std::memory_order_relaxed) / 1024.0,
+                    stats.arenaGpuBytes.load(std::memory_order_relaxed) / 1024.0,
+                    stats.arenaPeakCpuBytes.load(std::memory_order_relaxed) / 1024.0,
+                    stats.arenaPeakGpuBytes.load(std::memory_order_relaxed) / 1024.0);
+        ImGui::Text("Textures: %s", vsdl_stream_status(ctx).c_str());
+    }
+    if (ctx.allocator && ImGui::CollapsingHeader("GPU memory")) {
+        VmaBudget budgets[VK_MAX_MEMORY_HEAPS] = {};
+        uint32_t heapCount = vsdl_get_memory_budgets(ctx, budgets);
+        for (uint32_t i = 0; i < heapCount; i++) {
+            ImGui::Text("Heap %u: %.1f / %.1f MB%s", i, budgets[i].usage / (1024.0 * 1024.0),
+                        budgets[i].budget / (1024.0 * 1024.0), ctx.memoryBudgetSupported ? "" : " (est.)");
+        }
+        for (uint32_t i = 0; i < VSDL_MEMORY_POOL_COUNT; i++) {
+            VmaStatistics statistics = vsdl_get_pool_statistics(ctx, (VSDL_MemoryClass)i);
+            ImGui::Text("Pool %s: %u allocs, %.1f / %.1f MB", vsdl_memory_class_name((VSDL_MemoryClass)i),
+                        statistics.allocationCount, statistics.allocationBytes / (1024.0 * 1024.0),
+                        statistics.blockBytes / (1024.0 * 1024.0));
+        }
     }
+    vsdl_camera_ui(settings->camera);
+    vsdl_ui_cache_ui(ctx, *settings);
+    ImGui::Checkbox("Profiler", &settings->showProfiler);
+    ImGui::End();
+
+    vsdl_profiler_draw_ui(ctx, settings->showProfiler);
+}
+
+void vsdl_begin_scene_pass(VSDL_Context& ctx, VkCommandBuffer commandBuffer, uint32_t imageIndex, bool secondaryContents) {
+    VkClearValue clearValues[2] = {};
+    clearValues[0].color = {{0.0f, 0.0f, 0.0f, 1.0f}};
+    clearValues[1].depthStencil.depth = 0.0f; // Reverse-Z: 0 is the far plane
+    VkRenderPassBeginInfo renderPassInfo = {};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    renderPassInfo.renderPass = ctx.renderPass;
+    renderPassInfo.framebuffer = ctx.framebuffers[imageIndex];
+    renderPassInfo.renderArea.offset = {0, 0};
+    renderPassInfo.renderArea.extent = ctx.swapchainExtent;
+    renderPassInfo.clearValueCount = 2;
+    renderPassInfo.pClearValues = clearValues;
+    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo,
+                         secondaryContents ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE);
+}
+
+void vsdl_end_scene_pass(VSDL_Context& ctx, VkCommandBuffer commandBuffer, uint32_t imageIndex) {
+    vkCmdEndRenderPass(commandBuffer); // finalLayout does the transition
+}
+
+// Whichever scene is active, with its depth-only pipelines for the prepass
+static void draw_scene_geometry(VSDL_Context& ctx, VkCommandBuffer commandBuffer, bool depthOnly) {
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vsdl_pipeline(ctx, depthOnly ? ctx.depthPipeline : ctx.graphicsPipeline));
+    vsdl_bind_bindless(ctx, commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, ctx.pipelineLayout);
+    vkCmdPushConstants(commandBuffer, ctx.pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::mat4),
+                       glm::value_ptr(ctx.camera.viewProjection));
+    if (ctx.instancing.instanceCount > 0 && !ctx.meshes.empty()) {
+        vsdl_record_instancing_draw(ctx, commandBuffer, ctx.currentFrame, depthOnly);
+    } else if (ctx.parallel.objects.count > 0) {
+        vsdl_record_direct_draws(ctx, commandBuffer, 0, ctx.parallel.objects.count, depthOnly);
+    } else {
+        for (const auto& mesh : ctx.meshes) {
+            vsdl_draw_mesh(commandBuffer, mesh);
+        }
+    }
+}
+
+// Inline scene draws and ImGui; the caller has begun the color pass
+static void record_scene(VSDL_Context& ctx, VkCommandBuffer commandBuffer) {
+    // Viewport and scissor are dynamic so the pipeline survives swapchain recreation
+    VkViewport viewport = {};
+    viewport.width = (float)ctx.swapchainExtent.width;
+    viewport.height = (float)ctx.swapchainExtent.height;
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+    VkRect2D scissor = {};
+    scissor.extent = ctx.swapchainExtent;
+    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+    // Same pass, depth-only draws first: the shading draws then only pass the EQUAL test on the nearest surface
+    if (ctx.depthPrepass) {
+        vsdl_gpu_scope_begin(ctx, commandBuffer, "depth prepass");
+        draw_scene_geometry(ctx, commandBuffer, true);
+        vsdl_gpu_scope_end(ctx, commandBuffer);
+    }
+    vsdl_gpu_scope_begin(ctx, commandBuffer, "scene");
+    draw_scene_geometry(ctx, commandBuffer, false);
+    vsdl_record_particles_draw(ctx, commandBuffer);
+    vsdl_gpu_scope_end(ctx, commandBuffer);
+
+    vsdl_gpu_scope_begin(ctx, commandBuffer, "imgui");
+    vsdl::imgui_render(ctx, commandBuffer); // Render ImGui
+    vsdl_gpu_scope_end(ctx, commandBuffer);
+}
+
+// Only the instanced path is culled against the pyramid; when it is off the pyramid goes stale. Without a
+// sampleable depth format it is never built and the cull pass tests the frustum only.
+static bool depth_pyramid_active(VSDL_Context& ctx) {
+    bool active = ctx.depthPyramid.pipeline && ctx.depthSampled && ctx.instancing.instanceCount > 0 && ctx.instancing.occlusionCulling &&
+                  !ctx.meshes.empty();
+    if (!active) ctx.depthPyramid.valid = false;
+    return active;
+}
+
+// A barrier on a combined depth/stencil image has to name both aspects
+static VkImageAspectFlags depth_barrier_aspect(VkFormat format) {
+    if (format == VK_FORMAT_D16_UNORM_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT || format == VK_FORMAT_D32_SFLOAT_S8_UINT) {
+        return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+    }
+    return VK_IMAGE_ASPECT_DEPTH_BIT;
+}
+
+// Render pass path: reduce the depth the pass just wrote for the next frame's cull
+static void record_depth_pyramid(VSDL_Context& ctx, VkCommandBuffer commandBuffer) {
+    if (!depth_pyramid_active(ctx)) return;
+
+    // The next frame's pass starts the depth from UNDEFINED, so it is never transitioned back
+    VkImageMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = ctx.depthImage.image;
+    barrier.subresourceRange = { depth_barrier_aspect(ctx.depthFormat), 0, 1, 0, 1 };
+    vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+    vsdl_gpu_scope_begin(ctx, commandBuffer, "depth pyramid");
+    vsdl_record_depth_pyramid(ctx, commandBuffer, ctx.depthView);
+    vsdl_gpu_scope_end(ctx, commandBuffer);
+}
+
+// The dynamic rendering path draws through a render graph that owns the backbuffer transitions
+static void build_frame_graph(VSDL_Context& ctx) {
+    VSDL_RenderGraph& graph = ctx.frameGraph;
+    graph.extent = ctx.swapchainExtent;
+    uint32_t backbuffer = vsdl_graph_import_image(graph, "backbuffer", ctx.swapchainImageFormat, VK_IMAGE_LAYOUT_UNDEFINED,
+                                                  ctx.headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+    graph.resources[backbuffer].clearValue = {{{0.0f, 0.0f, 0.0f, 1.0f}}};
+    VkClearValue clearDepth = {};
+    clearDepth.depthStencil.depth = 0.0f; // Reverse-Z: 0 is the far plane
+    uint32_t depth = vsdl_graph_create_image(graph, "depth", ctx.depthFormat, clearDepth);
+
+    uint32_t pass = vsdl_graph_add_pass(graph, "forward", [](VSDL_Context& ctx, VkCommandBuffer commandBuffer) {
+        if (ctx.frameGraph.passes[0].secondaryContents) {
+            vsdl_execute_parallel_scene(ctx, commandBuffer, VK_NULL_HANDLE);
+        } else {
+            record_scene(ctx, commandBuffer);
+        }
+    });
+    vsdl_graph_use(graph, pass, backbuffer, VSDL_GraphAccess::ColorAttachment);
+    vsdl_graph_use(graph, pass, depth, VSDL_GraphAccess::DepthAttachment);
+    vsdl_graph_set_output(graph, backbuffer);
+
+    if (ctx.depthPyramid.pipeline && ctx.depthSampled) {
+        // The pyramid outlives the graph, so it is an output of its own; its levels are synchronized by the pass
+        uint32_t pyramid = vsdl_graph_import_image(graph, "depth pyramid", VK_FORMAT_R32_SFLOAT, VK_IMAGE_LAYOUT_GENERAL,
+                                                   VK_IMAGE_LAYOUT_GENERAL);
+        vsdl_graph_bind_image(graph, pyramid, ctx.depthPyramid.image.image, ctx.depthPyramid.view);
+        uint32_t reduce = vsdl_graph_add_pass(graph, "depth pyramid", [depth](VSDL_Context& ctx, VkCommandBuffer commandBuffer) {
+            if (depth_pyramid_active(ctx)) vsdl_record_depth_pyramid(ctx, commandBuffer, ctx.frameGraph.resources[depth].view);
+        });
+        vsdl_graph_use(graph, reduce, depth, VSDL_GraphAccess::Sampled);
+        vsdl_graph_use(graph, reduce, pyramid, VSDL_GraphAccess::StorageWrite);
+        vsdl_graph_set_output(graph, pyramid);
+    }
+    vsdl_graph_compile(ctx, graph);
+}
+
+// Take over what the UI edited since the last frame; the render thread is the only reader of ctx.camera
+static void apply_ui_settings(VSDL_Context& ctx) {
+    ctx.camera = ctx.uiSettings.camera;
+    ctx.instancing.occlusionCulling = ctx.uiSettings.occlusionCulling;
+    vsdl_set_ui_mode(ctx, ctx.uiSettings.uiMode);
+    ctx.profiler.showOverlay = ctx.uiSettings.showProfiler;
+}
+
+// The other direction: hand the UI this frame's numbers without it touching render-thread state
+static void publish_frame_stats(VSDL_Context& ctx) {
+    VSDL_FrameStats& stats = ctx.frameStats;
+    const VSDL_CullOutput& cull = ctx.instancing.lastStats;
+    const VSDL_FrameArena& arena = ctx.frameArena;
+    stats.recordMs.store(ctx.lastRecordMs, std::memory_order_relaxed);
+    stats.visibleInstances.store(cull.command.instanceCount, std::memory_order_relaxed);
+    stats.frustumCulled.store(cull.frustumCulled, std::memory_order_relaxed);
+    stats.occlusionCulled.store(cull.occlusionCulled, std::memory_order_relaxed);
+    stats.arenaCpuBytes.store(arena.lastCpuBytes, std::memory_order_relaxed);
+    stats.arenaGpuBytes.store(arena.lastGpuBytes, std::memory_order_relaxed);
+    stats.arenaPeakCpuBytes.store(arena.peakCpuBytes, std::memory_order_relaxed);
+    stats.arenaPeakGpuBytes.store(arena.peakGpuBytes, std::memory_order_relaxed);
+}
+
+void vsdl_record_frame(VSDL_Context& ctx, VkCommandBuffer commandBuffer, uint32_t imageIndex) {
+    Uint64 recordStart = SDL_GetPerformanceCounter();
+    vsdl_profiler_begin_frame(ctx, commandBuffer, ctx.currentFrame);
+    vsdl_gpu_scope_begin(ctx, commandBuffer, "frame");
+    apply_ui_settings(ctx);
+    vsdl_update_camera(ctx);
+    vsdl::imgui_prepare(ctx);
+    if (ctx.parallel.objects.count > 0) vsdl_prepare_direct_draws(ctx);
+
+    // The culling dispatch has to be recorded before the render pass begins
+    if (ctx.instancing.instanceCount > 0 && !ctx.meshes.empty()) {
+        vsdl_gpu_scope_begin(ctx, commandBuffer, "cull");
+        vsdl_record_instancing_cull(ctx, commandBuffer, ctx.currentFrame);
+        vsdl_gpu_scope_end(ctx, commandBuffer);
+    }
+    vsdl_record_particles_pre_pass(ctx, commandBuffer);
+    vsdl_record_ui_layer(ctx, commandBuffer);
+
+    // The workers split the direct draws only. The instanced scene, which draw_scene_geometry prefers, is a
+    // single indirect draw and stays inline.
+    bool instanced = ctx.instancing.instanceCount > 0 && !ctx.meshes.empty();
+    bool secondary = ctx.parallel.objects.count > 0 && ctx.parallel.workerCount > 0 && !instanced;
+    if (ctx.dynamicRendering.enabled) {
+        if (!ctx.frameGraph.compiled) build_frame_graph(ctx);
+        vsdl_graph_bind_image(ctx.frameGraph, 0, ctx.swapchainImages[imageIndex], ctx.swapchainImageViews[imageIndex]);
+        ctx.frameGraph.passes[0].secondaryContents = secondary;
+        vsdl_graph_execute(ctx, ctx.frameGraph, commandBuffer);
+    } else if (secondary) {
+        // With workers the pass only holds vkCmdExecuteCommands, so the GPU scope wraps the whole pass
+        vsdl_gpu_scope_begin(ctx, commandBuffer, "scene");
+        vsdl_begin_scene_pass(ctx, commandBuffer, imageIndex, true);
+        vsdl_execute_parallel_scene(ctx, commandBuffer, ctx.framebuffers[imageIndex]);
+        vsdl_end_scene_pass(ctx, commandBuffer, imageIndex);
+        vsdl_gpu_scope_end(ctx, commandBuffer);
+        record_depth_pyramid(ctx, commandBuffer);
+    } else {
+        vsdl_begin_scene_pass(ctx, commandBuffer, imageIndex, false);
+        record_scene(ctx, commandBuffer);
+        vsdl_end_scene_pass(ctx, commandBuffer, imageIndex);
+        record_depth_pyramid(ctx, commandBuffer);
+    }
+    vsdl_record_particles_post_pass(ctx, commandBuffer);
+    vsdl_gpu_scope_end(ctx, commandBuffer);
+    vsdl_frame_arena_end(ctx);
+
+    ctx.lastRecordMs = (double)(SDL_GetPerformanceCounter() - recordStart) * 1000.0 / (double)SDL_GetPerformanceFrequency();
+    publish_frame_stats(ctx);
+}
+
+// Recreate the swapchain and let ImGui know if the image count changed
+static bool recreate_swapchain(VSDL_Context& ctx) {
+    if (!vsdl_recreate_swapchain(ctx)) return false;
+    vsdl_graph_destroy(ctx, ctx.frameGraph); // Extent may have changed, rebuilt on the next record
+    vsdl_resize_depth_pyramid(ctx); // The device is idle after the swapchain rebuild
+    vsdl_resize_ui_cache(ctx);
+    ImGui_ImplVulkan_SetMinImageCount(ctx.swapchainMinImageCount);
+    return true;
+}
+
+void vsdl_draw_frame(VSDL_Context& ctx) {
+    // Resize events only mark the swapchain; a storm of them costs one rebuild per frame
+    if (ctx.swapchainOutOfDate && !recreate_swapchain(ctx)) {
+        if (!ctx.uiDrawData) ImGui::EndFrame(); // Nothing to draw into (minimized), drop the UI frame
+        return;
+    }
+
+    VSDL_Frame& frame = ctx.frames[ctx.currentFrame];
+
+    // Only block until the frame that used this slot framesInFlight frames ago has completed
+    Uint64 scopeStart = SDL_GetPerformanceCounter();
+    vsdl_timeline_wait(ctx, VSDL_QueueKind::Graphics, frame.timelineValue);
+    vsdl_profiler_cpu_scope(ctx, "frame wait", scopeStart);
+    vsdl_profiler_resolve(ctx, ctx.currentFrame);
+    vsdl_shader_reload_apply(ctx);
+
+    uint32_t imageIndex;
+    scopeStart = SDL_GetPerformanceCounter();
+    VkResult result = vkAcquireNextImageKHR(ctx.device, ctx.swapchain, UINT64_MAX, frame.imageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex);
+    vsdl_profiler_cpu_scope(ctx, "acquire", scopeStart);
+    if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+        // Nothing was submitted and the semaphore is unsignaled, so the slot can be reused as is
+        recreate_swapchain(ctx);
+        if (!ctx.uiDrawData) ImGui::EndFrame();
+        return;
+    }
+    if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to acquire swapchain image");
+        throw std::runtime_error("Swapchain image acquisition failed");
+    }
+
+    // The image may still be in use by an older frame when the ring is deeper than the swapchain
+    vsdl_timeline_wait(ctx, VSDL_QueueKind::Graphics, ctx.imagesInFlight[imageIndex]);
+
+    vsdl_descriptors_begin_frame(ctx); // Submission is certain from here on
+    vsdl_frame_arena_begin(ctx);
+    vsdl_stream_update(ctx);
+    vsdl_particles_simulate(ctx); // Async compute step, runs while this frame draws the previous one
+
+    scopeStart = SDL_GetPerformanceCounter();
+    VkCommandBuffer commandBuffer = frame.commandBuffer;
+    vkResetCommandBuffer(commandBuffer, 0);
+    VkCommandBufferBeginInfo beginInfo = {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to begin command buffer");
+        throw std::runtime_error("Command buffer begin failed");
+    }
+
+    vsdl_record_frame(ctx, commandBuffer, imageIndex);
+
+    if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to end command buffer");
+        throw std::runtime_error("Command buffer end failed");
+    }
+    vsdl_profiler_cpu_scope(ctx, "record", scopeStart);
+
+    // Uploads queued this frame (meshes, instance data) only need to land before the stages that read them
+    scopeStart = SDL_GetPerformanceCounter();
+    std::vector<VSDL_QueueWait> waits = vsdl_flush_uploads(ctx);
+    vsdl_particles_graphics_waits(ctx, waits);
+    VkSemaphore signalSemaphores[] = { ctx.renderFinishedSemaphores[imageIndex] };
+    frame.timelineValue = vsdl_queue_submit(ctx, VSDL_QueueKind::Graphics, commandBuffer, waits, frame.imageAvailableSemaphore,
+                                            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, signalSemaphores[0]);
+    ctx.imagesInFlight[imageIndex] = frame.timelineValue;
+    vsdl_profiler_cpu_scope(ctx, "submit", scopeStart);
+
+    VkPresentInfoKHR presentInfo = {};
+    presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+    presentInfo.waitSemaphoreCount = 1;
+    presentInfo.pWaitSemaphores = signalSemaphores;
+    presentInfo.swapchainCount = 1;
+    presentInfo.pSwapchains = &ctx.swapchain;
+    presentInfo.pImageIndices = &imageIndex;
+
+    scopeStart = SDL_GetPerformanceCounter();
+    result = vkQueuePresentKHR(ctx.presentQueue, &presentInfo);
+    vsdl_profiler_cpu_scope(ctx, "present", scopeStart);
+    if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
+        ctx.swapchainOutOfDate = true;
+    } else if (result != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to present swapchain image");
+        throw std::runtime_error("Queue present failed");
+    }
+
+    ctx.currentFrame = (ctx.currentFrame + 1) % ctx.framesInFlight;
+}
+
+void vsdl_render_loop(VSDL_Context& ctx) {
+    if (!ctx.frames[0].commandBuffer) vsdl_create_frames(ctx);
 
     bool running = true;
     SDL_Event event;
     while (running) {
         // Process events
+        Uint64 scopeStart = SDL_GetPerformanceCounter();
         while (SDL_PollEvent(&event)) {
             vsdl::imgui_new_frame(ctx, event); // Process SDL events for ImGui
             if (event.type == SDL_EVENT_QUIT) running = false;
+            if (event.type == SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED) ctx.swapchainOutOfDate = true;
         }
+        vsdl_profiler_cpu_scope(ctx, "events", scopeStart);
 
-        // Start ImGui frame
-        ImGui_ImplVulkan_NewFrame();
-        ImGui_ImplSDL3_NewFrame();
-        ImGui::NewFrame();
-
-        // Example ImGui UI
-        ImGui::Begin("Test Window");
-        ImGui::Text("Hello, ImGui with Vulkan!");
-        ImGui::End();
-
-        // Vulkan rendering
-        vkWaitForFences(ctx.device, 1, &ctx.inFlightFence, VK_TRUE, UINT64_MAX);
-        vkResetFences(ctx.device, 1, &ctx.inFlightFence);
-
-        uint32_t imageIndex;
-        VkResult result = vkAcquireNextImageKHR(ctx.device, ctx.swapchain, UINT64_MAX, ctx.imageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex);
-        if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
-            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to acquire swapchain image");
-            throw std::runtime_error("Swapchain image acquisition failed");
+        // Don't spin while minimized, there is no swapchain to render to
+        if (SDL_GetWindowFlags(ctx.window) & SDL_WINDOW_MINIMIZED) {
+            SDL_Delay(10);
+            continue;
         }
 
-        vkResetCommandBuffer(ctx.commandBuffer, 0);
-        VkCommandBufferBeginInfo beginInfo = {};
-        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        if (vkBeginCommandBuffer(ctx.commandBuffer, &beginInfo) != VK_SUCCESS) {
-            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to begin command buffer");
-            throw std::runtime_error("Command buffer begin failed");
-        }
+        scopeStart = SDL_GetPerformanceCounter();
+        vsdl_build_ui(ctx);
+        vsdl_profiler_cpu_scope(ctx, "ui", scopeStart);
+        vsdl_draw_frame(ctx);
+    }
+}
 
-        VkRenderPassBeginInfo renderPassInfo = {};
-        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-        renderPassInfo.renderPass = ctx.renderPass;
-        renderPassInfo.framebuffer = ctx.framebuffers[imageIndex];
-        renderPassInfo.renderArea.offset = {0, 0};
-        renderPassInfo.renderArea.extent = ctx.swapchainExtent;
-        VkClearValue clearColor = {{{0.0f, 0.0f, 0.0f, 1.0f}}};
-        renderPassInfo.clearValueCount = 1;
-        renderPassInfo.pClearValues = &clearColor;
-
-        vkCmdBeginRenderPass(ctx.commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-        vkCmdBindPipeline(ctx.commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, ctx.graphicsPipeline);
-        vkCmdDraw(ctx.commandBuffer, 3, 1, 0, 0); // Draw triangle
-        vsdl::imgui_render(ctx, ctx.commandBuffer); // Render ImGui
-        vkCmdEndRenderPass(ctx.commandBuffer);
-
-        if (vkEndCommandBuffer(ctx.commandBuffer) != VK_SUCCESS) {
-            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to end command buffer");
-            throw std::runtime_error("Command buffer end failed");
-        }
+void vsdl_benchmark_frames(VSDL_Context& ctx, uint32_t frameCount) {
+    const uint32_t warmupFrames = 30;
+    const uint32_t originalFramesInFlight = ctx.framesInFlight;
+    if (ctx.presentMode == VK_PRESENT_MODE_FIFO_KHR) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Benchmark running with FIFO present mode, frame times are capped at vsync");
+    }
+    double averages[VSDL_MAX_FRAMES_IN_FLIGHT] = {};
 
-        VkSubmitInfo submitInfo = {};
-        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        VkSemaphore waitSemaphores[] = { ctx.imageAvailableSemaphore };
-        VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-        submitInfo.waitSemaphoreCount = 1;
-        submitInfo.pWaitSemaphores = waitSemaphores;
-        submitInfo.pWaitDstStageMask = waitStages;
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = &ctx.commandBuffer;
-        VkSemaphore signalSemaphores[] = { ctx.renderFinishedSemaphore };
-        submitInfo.signalSemaphoreCount = 1;
-        submitInfo.pSignalSemaphores = signalSemaphores;
-
-        if (vkQueueSubmit(ctx.graphicsQueue, 1, &submitInfo, ctx.inFlightFence) != VK_SUCCESS) {
-            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to submit draw command buffer");
-            throw std::runtime_error("Queue submit failed");
+    for (uint32_t n = 1; n <= VSDL_MAX_FRAMES_IN_FLIGHT; n++) {
+        vkDeviceWaitIdle(ctx.device);
+        vsdl_destroy_frames(ctx);
+        ctx.framesInFlight = n;
+        vsdl_create_frames(ctx);
+
+        Uint64 start = 0;
+        for (uint32_t i = 0; i < warmupFrames + frameCount; i++) {
+            if (i == warmupFrames) start = SDL_GetPerformanceCounter();
+
+            SDL_Event event;
+            while (SDL_PollEvent(&event)) {
+                vsdl::imgui_new_frame(ctx, event);
+                if (event.type == SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED) ctx.swapchainOutOfDate = true;
+                if (event.type == SDL_EVENT_QUIT) {
+                    SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Benchmark aborted");
+                    return;
+                }
+            }
+
+            vsdl_build_ui(ctx);
+            vsdl_draw_frame(ctx);
         }
+        vkDeviceWaitIdle(ctx.device);
+        Uint64 elapsed = SDL_GetPerformanceCounter() - start;
 
-        VkPresentInfoKHR presentInfo = {};
-        presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-        presentInfo.waitSemaphoreCount = 1;
-        presentInfo.pWaitSemaphores = signalSemaphores;
-        presentInfo.swapchainCount = 1;
-        presentInfo.pSwapchains = &ctx.swapchain;
-        presentInfo.pImageIndices = &imageIndex;
+        averages[n - 1] = (double)elapsed * 1000.0 / (double)SDL_GetPerformanceFrequency() / frameCount;
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Benchmark: %u frame(s) in flight: %.3f ms/frame (%.1f FPS) over %u frames",
+                    n, averages[n - 1], 1000.0 / averages[n - 1], frameCount);
+    }
 
-        vkQueuePresentKHR(ctx.presentQueue, &presentInfo);
+    for (uint32_t n = 2; n <= VSDL_MAX_FRAMES_IN_FLIGHT; n++) {
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Benchmark: N=%u speedup over N=1: %.2fx", n, averages[0] / averages[n - 1]);
     }
-}
\ No newline at end of file
+
+    vkDeviceWaitIdle(ctx.device);
+    vsdl_destroy_frames(ctx);
+    ctx.framesInFlight = originalFramesInFlight;
+    vsdl_create_frames(ctx);
+}
@@ -0,0 +1,248 @@
+#include "vsdl_shader_reload.h"
+#include "vsdl_sync.h"
+#include <SDL3/SDL_log.h>
+#include <SDL3/SDL_timer.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+#define VSDL_SHADER_POLL_MS 250
+
+struct VSDL_ReloadTarget {
+    std::vector<std::string> sources;
+    VkPipeline* pipeline = nullptr;
+    std::function<VkPipeline(VSDL_Context&)> build;
+};
+
+// Built on the watcher thread, swapped in by vsdl_shader_reload_apply
+struct VSDL_ReadyPipeline {
+    VkPipeline* slot;
+    VkPipeline pipeline;
+};
+
+// Replaced pipeline waiting for the frame slots that may still reference it
+struct VSDL_RetiredPipeline {
+    VkPipeline pipeline;
+    uint64_t releaseValue; // Graphics timeline value after which no recorded frame uses it
+};
+
+struct VSDL_ShaderReloader {
+    std::string sourceDir;
+    std::string glslc;
+    std::thread thread;
+    std::mutex mutex; // Guards quit, targets, ready, lastError and reloadCount
+    std::condition_variable wake;
+    bool quit = false;
+    std::vector<VSDL_ReloadTarget> targets;
+    std::vector<VSDL_ReadyPipeline> ready;
+    std::string lastError;
+    uint32_t reloadCount = 0;
+    std::vector<VSDL_RetiredPipeline> retired; // Frame thread only
+    std::unordered_map<std::string, std::filesystem::file_time_type> stamps; // Watcher thread only
+};
+
+static bool is_shader_source(const std::filesystem::path& path) {
+    std::string extension = path.extension().string();
+    return extension == ".vert" || extension == ".frag" || extension == ".comp" ||
+           extension == ".geom" || extension == ".tesc" || extension == ".tese";
+}
+
+// File names whose timestamp moved since the last scan; files seen for the first time are only recorded
+static std::vector<std::string> scan_sources(VSDL_ShaderReloader* reloader) {
+    std::vector<std::string> changed;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(reloader->sourceDir, error)) {
+        if (!entry.is_regular_file(error) || !is_shader_source(entry.path())) continue;
+        auto stamp = entry.last_write_time(error);
+        if (error) continue;
+
+        std::string name = entry.path().filename().string();
+        auto it = reloader->stamps.find(name);
+        if (it == reloader->stamps.end()) {
+            reloader->stamps[name] = stamp;
+        } else if (it->second != stamp) {
+            it->second = stamp;
+            changed.push_back(name);
+        }
+    }
+    return changed;
+}
+
+// glslc writes a temporary file that is renamed over the .spv, so a pipeline build never reads half a module
+static bool compile_shader(VSDL_ShaderReloader* reloader, const std::string& name, std::string& log) {
+    std::string source = (std::filesystem::path(reloader->sourceDir) / name).string();
+    std::string output = (std::filesystem::path("shaders") / (name + ".spv")).string();
+    std::string temp = output + ".tmp";
+    std::string logPath = output + ".log";
+
+    std::string command = "\"" + reloader->glslc + "\" \"" + source + "\" -o \"" + temp + "\" > \"" + logPath + "\" 2>&1";
+#ifdef _WIN32
+    command = "\"" + command + "\""; // cmd /c strips the outermost quotes
+#endif
+    int status = std::system(command.c_str());
+
+    std::ifstream logFile(logPath);
+    std::stringstream text;
+    text << logFile.rdbuf();
+    logFile.close();
+    log = text.str();
+    std::error_code error;
+    std::filesystem::remove(logPath, error);
+
+    if (status != 0) {
+        std::filesystem::remove(temp, error);
+        if (log.empty()) log = "glslc exited with status " + std::to_string(status);
+        return false;
+    }
+    std::filesystem::rename(temp, output, error);
+    if (error) {
+        log = "Failed to replace " + output + ": " + error.message();
+        return false;
+    }
+    return true;
+}
+
+static void rebuild_changed(VSDL_Context& ctx, VSDL_ShaderReloader* reloader) {
+    std::vector<std::string> compiled;
+    for (const auto& name : scan_sources(reloader)) {
+        Uint64 start = SDL_GetPerformanceCounter();
+        std::string log;
+        if (!compile_shader(reloader, name, log)) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Shader reload: %s failed to compile:\n%s", name.c_str(), log.c_str());
+            std::lock_guard<std::mutex> lock(reloader->mutex);
+            reloader->lastError = name + ": " + log.substr(0, log.find('\n'));
+            continue;
+        }
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Shader reload: compiled %s in %.1f ms", name.c_str(),
+                    (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / (double)SDL_GetPerformanceFrequency());
+        compiled.push_back(name);
+    }
+    if (compiled.empty()) return;
+
+    // Copy the affected targets so the lock isn't held while the driver compiles
+    std::vector<VSDL_ReloadTarget> affected;
+    {
+        std::lock_guard<std::mutex> lock(reloader->mutex);
+        for (const auto& target : reloader->targets) {
+            for (const auto& source : target.sources) {
+                if (std::find(compiled.begin(), compiled.end(), source) == compiled.end()) continue;
+                affected.push_back(target);
+                break;
+            }
+        }
+    }
+
+    // The builders only read state that is fixed after startup (layouts, render pass, formats); the
+    // pipeline cache is internally synchronized, so this runs alongside frame recording
+    for (const auto& target : affected) {
+        try {
+            Uint64 start = SDL_GetPerformanceCounter();
+            VkPipeline pipeline = target.build(ctx);
+            std::lock_guard<std::mutex> lock(reloader->mutex);
+            reloader->ready.push_back({ target.pipeline, pipeline });
+            reloader->reloadCount++;
+            reloader->lastError.clear();
+            SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Shader reload: rebuilt pipeline for %s in %.1f ms", target.sources[0].c_str(),
+                        (double)(SDL_GetPerformanceCounter() - start) * 1000.0 / (double)SDL_GetPerformanceFrequency());
+        } catch (const std::exception& e) {
+            // Already logged by the builder; the old pipeline stays in use
+            std::lock_guard<std::mutex> lock(reloader->mutex);
+            reloader->lastError = e.what();
+        }
+    }
+}
+
+static void watcher_main(VSDL_Context* ctx, VSDL_ShaderReloader* reloader) {
+    scan_sources(reloader); // Baseline: only edits made from now on trigger a rebuild
+    std::unique_lock<std::mutex> lock(reloader->mutex);
+    while (!reloader->wake.wait_for(lock, std::chrono::milliseconds(VSDL_SHADER_POLL_MS), [reloader] { return reloader->quit; })) {
+        lock.unlock();
+        rebuild_changed(*ctx, reloader);
+        lock.lock();
+    }
+}
+
+void vsdl_create_shader_reloader(VSDL_Context& ctx, const std::string& sourceDir, const std::string& glslc) {
+    std::error_code error;
+    if (!std::filesystem::is_directory(sourceDir, error)) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Shader reload: source directory %s not found, nothing to watch", sourceDir.c_str());
+    }
+    VSDL_ShaderReloader* reloader = new VSDL_ShaderReloader();
+    reloader->sourceDir = sourceDir;
+    reloader->glslc = glslc;
+    ctx.shaderReloader = reloader;
+    reloader->thread = std::thread(watcher_main, &ctx, reloader);
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Shader reload: watching %s with %s", sourceDir.c_str(), glslc.c_str());
+}
+
+void vsdl_destroy_shader_reloader(VSDL_Context& ctx) {
+    VSDL_ShaderReloader* reloader = ctx.shaderReloader;
+    if (!reloader) return;
+    {
+        std::lock_guard<std::mutex> lock(reloader->mutex);
+        reloader->quit = true;
+    }
+    reloader->wake.notify_all();
+    if (reloader->thread.joinable()) reloader->thread.join();
+
+    for (const auto& entry : reloader->ready) vkDestroyPipeline(ctx.device, entry.pipeline, nullptr);
+    for (const auto& retired : reloader->retired) vkDestroyPipeline(ctx.device, retired.pipeline, nullptr);
+    delete reloader;
+    ctx.shaderReloader = nullptr;
+}
+
+void vsdl_shader_reload_register(VSDL_Context& ctx, std::initializer_list<const char*> sources, VkPipeline* pipeline,
+                                 std::function<VkPipeline(VSDL_Context&)> build) {
+    VSDL_ShaderReloader* reloader = ctx.shaderReloader;
+    if (!reloader) return;
+
+    VSDL_ReloadTarget target;
+    for (const char* source : sources) target.sources.push_back(source);
+    target.pipeline = pipeline;
+    target.build = std::move(build);
+    std::lock_guard<std::mutex> lock(reloader->mutex);
+    reloader->targets.push_back(std::move(target));
+}
+
+void vsdl_shader_reload_apply(VSDL_Context& ctx) {
+    VSDL_ShaderReloader* reloader = ctx.shaderReloader;
+    if (!reloader) return;
+
+    // Commands recorded before the swap are done once the graphics timeline has passed the swap
+    uint64_t completed = vsdl_timeline_completed(ctx, VSDL_QueueKind::Graphics);
+    for (auto& retired : reloader->retired) {
+        if (retired.releaseValue > completed) continue;
+        vkDestroyPipeline(ctx.device, retired.pipeline, nullptr);
+        retired.pipeline = VK_NULL_HANDLE;
+    }
+    reloader->retired.erase(std::remove_if(reloader->retired.begin(), reloader->retired.end(),
+                                           [](const VSDL_RetiredPipeline& retired) { return retired.pipeline == VK_NULL_HANDLE; }),
+                            reloader->retired.end());
+
+    std::vector<VSDL_ReadyPipeline> ready;
+    {
+        std::lock_guard<std::mutex> lock(reloader->mutex);
+        ready.swap(reloader->ready);
+    }
+    for (const auto& entry : ready) {
+        if (*entry.slot) {
+            reloader->retired.push_back({ *entry.slot, vsdl_timeline_pending(ctx, VSDL_QueueKind::Graphics) });
+        }
+        *entry.slot = entry.pipeline;
+    }
+}
+
+std::string vsdl_shader_reload_status(VSDL_Context& ctx) {
+    VSDL_ShaderReloader* reloader = ctx.shaderReloader;
+    if (!reloader) return "off";
+    std::lock_guard<std::mutex> lock(reloader->mutex);
+    if (!reloader->lastError.empty()) return "error: " + reloader->lastError;
+    return std::to_string(reloader->reloadCount) + " reload(s)";
+}
\ No newline at end of file
@@ -0,0 +1,262 @@
+#include "vsdl_swapchain.h"
+#include "vsdl_memory.h"
+#include <SDL3/SDL_log.h>
+#include <algorithm>
+#include <stdexcept>
+
+const char* vsdl_present_mode_name(VkPresentModeKHR mode) {
+    switch (mode) {
+        case VK_PRESENT_MODE_IMMEDIATE_KHR: return "IMMEDIATE";
+        case VK_PRESENT_MODE_MAILBOX_KHR: return "MAILBOX";
+        case VK_PRESENT_MODE_FIFO_KHR: return "FIFO";
+        case VK_PRESENT_MODE_FIFO_RELAXED_KHR: return "FIFO_RELAXED";
+        default: return "UNKNOWN";
+    }
+}
+
+static VkSurfaceFormatKHR choose_surface_format(const std::vector<VkSurfaceFormatKHR>& formats) {
+    for (const auto& format : formats) {
+        if ((format.format == VK_FORMAT_B8G8R8A8_UNORM || format.format == VK_FORMAT_R8G8B8A8_UNORM) &&
+            format.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR) {
+            return format;
+        }
+    }
+    return formats[0];
+}
+
+static VkPresentModeKHR choose_present_mode(VSDL_Context& ctx) {
+    uint32_t modeCount = 0;
+    vkGetPhysicalDeviceSurfacePresentModesKHR(ctx.physicalDevice, ctx.surface, &modeCount, nullptr);
+    std::vector<VkPresentModeKHR> modes(modeCount);
+    vkGetPhysicalDeviceSurfacePresentModesKHR(ctx.physicalDevice, ctx.surface, &modeCount, modes.data());
+
+    for (auto mode : modes) {
+        if (mode == ctx.requestedPresentMode) return mode;
+    }
+    // FIFO is the only mode the spec guarantees
+    SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Present mode %s not supported, falling back to FIFO",
+                vsdl_present_mode_name(ctx.requestedPresentMode));
+    return VK_PRESENT_MODE_FIFO_KHR;
+}
+
+static VkExtent2D choose_extent(VSDL_Context& ctx, const VkSurfaceCapabilitiesKHR& capabilities) {
+    if (capabilities.currentExtent.width != UINT32_MAX) {
+        return capabilities.currentExtent;
+    }
+    int width = 0, height = 0;
+    SDL_GetWindowSizeInPixels(ctx.window, &width, &height);
+    VkExtent2D extent = { (uint32_t)width, (uint32_t)height };
+    extent.width = std::clamp(extent.width, capabilities.minImageExtent.width, capabilities.maxImageExtent.width);
+    extent.height = std::clamp(extent.height, capabilities.minImageExtent.height, capabilities.maxImageExtent.height);
+    return extent;
+}
+
+bool vsdl_create_swapchain(VSDL_Context& ctx) {
+    VkSurfaceCapabilitiesKHR capabilities;
+    vkGetPhysicalDeviceSurfaceCapabilitiesKHR(ctx.physicalDevice, ctx.surface, &capabilities);
+
+    uint32_t formatCount;
+    vkGetPhysicalDeviceSurfaceFormatsKHR(ctx.physicalDevice, ctx.surface, &formatCount, nullptr);
+    std::vector<VkSurfaceFormatKHR> formats(formatCount);
+    vkGetPhysicalDeviceSurfaceFormatsKHR(ctx.physicalDevice, ctx.surface, &formatCount, formats.data());
+    VkSurfaceFormatKHR surfaceFormat = choose_surface_format(formats);
+    if (ctx.swapchainImageFormat != VK_FORMAT_UNDEFINED && ctx.swapchainImageFormat != surfaceFormat.format) {
+        // The render pass and pipelines were built for the old format and are not rebuilt; retrying can't
+        // help, so this ends the render loop
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Surface format changed during swapchain recreation");
+        throw std::runtime_error("Surface format changed");
+    }
+    ctx.swapchainImageFormat = surfaceFormat.format;
+    ctx.presentMode = choose_present_mode(ctx);
+
+    VkExtent2D extent = choose_extent(ctx, capabilities);
+    if (extent.width == 0 || extent.height == 0) {
+        // Minimized window: nothing to present to until it is restored. At startup the format is all the
+        // render pass needs, so creation is deferred to the first rebuild; during a rebuild it stays pending.
+        ctx.swapchainOutOfDate = true;
+        return ctx.swapchain == VK_NULL_HANDLE;
+    }
+
+    // One image more than the minimum so acquire doesn't block on the presentation engine
+    uint32_t minImageCount = capabilities.minImageCount + 1;
+    if (capabilities.maxImageCount > 0 && minImageCount > capabilities.maxImageCount) {
+        minImageCount = capabilities.maxImageCount;
+    }
+    ctx.swapchainMinImageCount = minImageCount;
+
+    VkSwapchainKHR oldSwapchain = ctx.swapchain;
+
+    VkSwapchainCreateInfoKHR swapchainInfo = {};
+    swapchainInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
+    swapchainInfo.surface = ctx.surface;
+    swapchainInfo.minImageCount = minImageCount;
+    swapchainInfo.imageFormat = ctx.swapchainImageFormat;
+    swapchainInfo.imageColorSpace = surfaceFormat.colorSpace;
+    swapchainInfo.imageExtent = extent;
+    swapchainInfo.imageArrayLayers = 1;
+    swapchainInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    swapchainInfo.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    swapchainInfo.preTransform = capabilities.currentTransform;
+    swapchainInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+    swapchainInfo.presentMode = ctx.presentMode;
+    swapchainInfo.clipped = VK_TRUE;
+    swapchainInfo.oldSwapchain = oldSwapchain;
+
+    if (vkCreateSwapchainKHR(ctx.device, &swapchainInfo, nullptr, &ctx.swapchain) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create swapchain");
+        ctx.swapchain = oldSwapchain;
+        return false;
+    }
+    if (oldSwapchain) vkDestroySwapchainKHR(ctx.device, oldSwapchain, nullptr);
+
+    ctx.swapchainExtent = extent;
+    uint32_t imageCount;
+    vkGetSwapchainImagesKHR(ctx.device, ctx.swapchain, &imageCount, nullptr);
+    ctx.swapchainImages.resize(imageCount);
+    vkGetSwapchainImagesKHR(ctx.device, ctx.swapchain, &imageCount, ctx.swapchainImages.data());
+
+    ctx.swapchainImageViews.resize(imageCount);
+    for (size_t i = 0; i < imageCount; i++) {
+        VkImageViewCreateInfo viewInfo = {};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = ctx.swapchainImages[i];
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = ctx.swapchainImageFormat;
+        viewInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
+        viewInfo.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
+        viewInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
+        viewInfo.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+        viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        viewInfo.subresourceRange.baseMipLevel = 0;
+        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.baseArrayLayer = 0;
+        viewInfo.subresourceRange.layerCount = 1;
+
+        if (vkCreateImageView(ctx.device, &viewInfo, nullptr, &ctx.swapchainImageViews[i]) != VK_SUCCESS) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create image view %zu", i);
+            return false;
+        }
+    }
+
+    // Present semaphores are indexed by swapchain image: an image is only re-acquired once its
+    // previous presentation consumed the semaphore, so reuse is always safe.
+    VkSemaphoreCreateInfo semaphoreInfo = {};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    ctx.renderFinishedSemaphores.resize(imageCount, VK_NULL_HANDLE);
+    for (size_t i = 0; i < imageCount; i++) {
+        if (vkCreateSemaphore(ctx.device, &semaphoreInfo, nullptr, &ctx.renderFinishedSemaphores[i]) != VK_SUCCESS) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create present semaphore for image %zu", i);
+            return false;
+        }
+    }
+    ctx.imagesInFlight.assign(imageCount, 0);
+
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Swapchain created: %ux%u, %u images, %s",
+                extent.width, extent.height, imageCount, vsdl_present_mode_name(ctx.presentMode));
+    return true;
+}
+
+// One depth image serves every framebuffer: frames serialize on the graphics queue and the render
+// pass dependency orders each clear after the previous frame's depth writes
+static void create_depth_buffer(VSDL_Context& ctx) {
+    VkImageCreateInfo imageInfo = {};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = ctx.depthFormat;
+    imageInfo.extent = { ctx.swapchainExtent.width, ctx.swapchainExtent.height, 1 };
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+    if (ctx.depthSampled) imageInfo.usage |= VK_IMAGE_USAGE_SAMPLED_BIT; // Sampled by the depth pyramid
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    ctx.depthImage = vsdl_create_image(ctx, imageInfo, true); // Resized with the swapchain, worth its own block
+
+    VkImageViewCreateInfo viewInfo = {};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = ctx.depthImage.image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = ctx.depthFormat;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.layerCount = 1;
+    if (vkCreateImageView(ctx.device, &viewInfo, nullptr, &ctx.depthView) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create depth image view");
+        throw std::runtime_error("Image view creation failed");
+    }
+}
+
+void vsdl_create_framebuffers(VSDL_Context& ctx) {
+    create_depth_buffer(ctx);
+    ctx.framebuffers.resize(ctx.swapchainImageViews.size());
+    for (size_t i = 0; i < ctx.swapchainImageViews.size(); i++) {
+        VkImageView attachments[] = { ctx.swapchainImageViews[i], ctx.depthView };
+        VkFramebufferCreateInfo framebufferInfo = {};
+        framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        framebufferInfo.renderPass = ctx.renderPass;
+        framebufferInfo.attachmentCount = 2;
+        framebufferInfo.pAttachments = attachments;
+        framebufferInfo.width = ctx.swapchainExtent.width;
+        framebufferInfo.height = ctx.swapchainExtent.height;
+        framebufferInfo.layers = 1;
+
+        if (vkCreateFramebuffer(ctx.device, &framebufferInfo, nullptr, &ctx.framebuffers[i]) != VK_SUCCESS) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create framebuffer %zu", i);
+            throw std::runtime_error("Framebuffer creation failed");
+        }
+    }
+}
+
+// Destroys everything that depends on the swapchain images but keeps the VkSwapchainKHR itself,
+// so it can be handed to vkCreateSwapchainKHR as oldSwapchain
+static void destroy_swapchain_resources(VSDL_Context& ctx) {
+    for (auto framebuffer : ctx.framebuffers) {
+        vkDestroyFramebuffer(ctx.device, framebuffer, nullptr);
+    }
+    ctx.framebuffers.clear();
+    if (ctx.depthView) vkDestroyImageView(ctx.device, ctx.depthView, nullptr);
+    ctx.depthView = VK_NULL_HANDLE;
+    vsdl_destroy_image(ctx, ctx.depthImage);
+    for (auto imageView : ctx.swapchainImageViews) {
+        vkDestroyImageView(ctx.device, imageView, nullptr);
+    }
+    ctx.swapchainImageViews.clear();
+    for (auto semaphore : ctx.renderFinishedSemaphores) {
+        if (semaphore) vkDestroySemaphore(ctx.device, semaphore, nullptr);
+    }
+    ctx.renderFinishedSemaphores.clear();
+    ctx.imagesInFlight.clear();
+    ctx.swapchainImages.clear();
+}
+
+void vsdl_destroy_swapchain(VSDL_Context& ctx) {
+    destroy_swapchain_resources(ctx);
+    if (ctx.swapchain) {
+        vkDestroySwapchainKHR(ctx.device, ctx.swapchain, nullptr);
+        ctx.swapchain = VK_NULL_HANDLE;
+    }
+}
+
+bool vsdl_recreate_swapchain(VSDL_Context& ctx) {
+    int width = 0, height = 0;
+    SDL_GetWindowSizeInPixels(ctx.window, &width, &height);
+    if (width == 0 || height == 0) {
+        // Keep the request pending until the window has a drawable area again
+        ctx.swapchainOutOfDate = true;
+        return false;
+    }
+
+    vkDeviceWaitIdle(ctx.device);
+    destroy_swapchain_resources(ctx);
+
+    if (!vsdl_create_swapchain(ctx)) {
+        ctx.swapchainOutOfDate = true;
+        return false;
+    }
+    if (ctx.renderPass) vsdl_create_framebuffers(ctx);
+
+    ctx.swapchainOutOfDate = false;
+    return true;
+}
\ No newline at end of file
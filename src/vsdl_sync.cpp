@@ -0,0 +1,233 @@
+#include "vsdl_sync.h"
+#include <SDL3/SDL_log.h>
+#include <algorithm>
+#include <stdexcept>
+
+static VkSemaphore create_binary_semaphore(VSDL_Context& ctx) {
+    VkSemaphoreCreateInfo semaphoreInfo = {};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    VkSemaphore semaphore = VK_NULL_HANDLE;
+    if (vkCreateSemaphore(ctx.device, &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create semaphore");
+        throw std::runtime_error("Semaphore creation failed");
+    }
+    return semaphore;
+}
+
+bool vsdl_create_sync(VSDL_Context& ctx) {
+    VSDL_Sync& sync = ctx.sync;
+    sync.timelines[(uint32_t)VSDL_QueueKind::Graphics].queue = ctx.graphicsQueue;
+    sync.timelines[(uint32_t)VSDL_QueueKind::Transfer].queue = ctx.transferQueue;
+    sync.timelines[(uint32_t)VSDL_QueueKind::Compute].queue = ctx.computeQueue;
+    if (!sync.timeline) {
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Sync: fences per submit (no timeline semaphores)");
+        return true;
+    }
+
+    VkSemaphoreTypeCreateInfo typeInfo = {};
+    typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    typeInfo.initialValue = 0;
+    VkSemaphoreCreateInfo semaphoreInfo = {};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreInfo.pNext = &typeInfo;
+    for (auto& timeline : sync.timelines) {
+        if (vkCreateSemaphore(ctx.device, &semaphoreInfo, nullptr, &timeline.semaphore) != VK_SUCCESS) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create timeline semaphore");
+            return false;
+        }
+    }
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Sync: one timeline semaphore per queue");
+    return true;
+}
+
+void vsdl_destroy_sync(VSDL_Context& ctx) {
+    for (auto& timeline : ctx.sync.timelines) {
+        if (timeline.semaphore) vkDestroySemaphore(ctx.device, timeline.semaphore, nullptr);
+        for (auto& entry : timeline.fences) vkDestroyFence(ctx.device, entry.second, nullptr);
+        for (VkFence fence : timeline.freeFences) vkDestroyFence(ctx.device, fence, nullptr);
+        for (auto& entry : timeline.signals) vkDestroySemaphore(ctx.device, entry.second, nullptr);
+        for (auto& entry : timeline.waited) vkDestroySemaphore(ctx.device, entry.second, nullptr);
+        timeline = VSDL_Timeline{};
+    }
+    for (VkSemaphore semaphore : ctx.sync.freeSemaphores) vkDestroySemaphore(ctx.device, semaphore, nullptr);
+    ctx.sync.freeSemaphores.clear();
+}
+
+uint64_t vsdl_timeline_pending(VSDL_Context& ctx, VSDL_QueueKind kind) {
+    return ctx.sync.timelines[(uint32_t)kind].submitted + 1;
+}
+
+uint64_t vsdl_timeline_completed(VSDL_Context& ctx, VSDL_QueueKind kind) {
+    VSDL_Timeline& timeline = ctx.sync.timelines[(uint32_t)kind];
+    if (timeline.completed == timeline.submitted) return timeline.completed;
+
+    if (ctx.sync.timeline) {
+        uint64_t value = 0;
+        if (ctx.sync.getSemaphoreCounterValue(ctx.device, timeline.semaphore, &value) == VK_SUCCESS) {
+            timeline.completed = std::max(timeline.completed, value);
+        }
+        return timeline.completed;
+    }
+
+    // Fences signal in submission order on one queue; recycle every signaled one from the front
+    size_t done = 0;
+    while (done < timeline.fences.size() && vkGetFenceStatus(ctx.device, timeline.fences[done].second) == VK_SUCCESS) {
+        timeline.completed = timeline.fences[done].first;
+        vkResetFences(ctx.device, 1, &timeline.fences[done].second);
+        timeline.freeFences.push_back(timeline.fences[done].second);
+        done++;
+    }
+    timeline.fences.erase(timeline.fences.begin(), timeline.fences.begin() + done);
+
+    // Signals nobody waited for are no longer needed once the host has seen them complete
+    auto stale = std::remove_if(timeline.signals.begin(), timeline.signals.end(), [&](const std::pair<uint64_t, VkSemaphore>& entry) {
+        if (entry.first > timeline.completed) return false;
+        vkDestroySemaphore(ctx.device, entry.second, nullptr);
+        return true;
+    });
+    timeline.signals.erase(stale, timeline.signals.end());
+    auto reusable = std::remove_if(timeline.waited.begin(), timeline.waited.end(), [&](const std::pair<uint64_t, VkSemaphore>& entry) {
+        if (entry.first > timeline.completed) return false;
+        ctx.sync.freeSemaphores.push_back(entry.second);
+        return true;
+    });
+    timeline.waited.erase(reusable, timeline.waited.end());
+    return timeline.completed;
+}
+
+void vsdl_timeline_wait(VSDL_Context& ctx, VSDL_QueueKind kind, uint64_t value) {
+    VSDL_Timeline& timeline = ctx.sync.timelines[(uint32_t)kind];
+    if (value <= timeline.completed) return;
+    if (value > timeline.submitted) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Waiting for timeline value %llu, only %llu submitted",
+                     (unsigned long long)value, (unsigned long long)timeline.submitted);
+        throw std::runtime_error("Timeline wait on an unsubmitted value");
+    }
+
+    if (ctx.sync.timeline) {
+        VkSemaphoreWaitInfo waitInfo = {};
+        waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &timeline.semaphore;
+        waitInfo.pValues = &value;
+        if (ctx.sync.waitSemaphores(ctx.device, &waitInfo, UINT64_MAX) != VK_SUCCESS) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to wait for timeline value %llu", (unsigned long long)value);
+            throw std::runtime_error("Timeline wait failed");
+        }
+        timeline.completed = std::max(timeline.completed, value);
+        return;
+    }
+
+    auto entry = std::find_if(timeline.fences.begin(), timeline.fences.end(),
+                              [value](const std::pair<uint64_t, VkFence>& candidate) { return candidate.first >= value; });
+    if (entry != timeline.fences.end()) vkWaitForFences(ctx.device, 1, &entry->second, VK_TRUE, UINT64_MAX);
+    vsdl_timeline_completed(ctx, kind);
+}
+
+uint64_t vsdl_queue_submit(VSDL_Context& ctx, VSDL_QueueKind kind, VkCommandBuffer commandBuffer,
+                           const std::vector<VSDL_QueueWait>& waits, VkSemaphore waitSemaphore,
+                           VkPipelineStageFlags waitStage, VkSemaphore signalSemaphore) {
+    VSDL_Sync& sync = ctx.sync;
+    VSDL_Timeline& timeline = sync.timelines[(uint32_t)kind];
+    uint64_t value = timeline.submitted + 1;
+
+    std::vector<VkSemaphore> waitSemaphores;
+    std::vector<uint64_t> waitValues; // Ignored for binary semaphores
+    std::vector<VkPipelineStageFlags> waitStages;
+    for (const auto& wait : waits) {
+        VSDL_Timeline& other = sync.timelines[(uint32_t)wait.kind];
+        if (sync.timeline) {
+            if (wait.value <= other.completed) continue;
+            waitSemaphores.push_back(other.semaphore);
+            waitValues.push_back(wait.value);
+            waitStages.push_back(wait.stages);
+            continue;
+        }
+        // Each binary semaphore is waited once. One whose submit the host already saw complete needs no
+        // GPU wait, but it stays signaled and can't be reused, so it is destroyed.
+        vsdl_timeline_completed(ctx, wait.kind);
+        auto consumed = std::remove_if(other.signals.begin(), other.signals.end(), [&](const std::pair<uint64_t, VkSemaphore>& signal) {
+            if (signal.first > wait.value) return false;
+            if (signal.first <= other.completed) {
+                vkDestroySemaphore(ctx.device, signal.second, nullptr);
+            } else {
+                waitSemaphores.push_back(signal.second);
+                waitValues.push_back(0);
+                waitStages.push_back(wait.stages);
+                timeline.waited.push_back({ value, signal.second }); // Unsignaled again once this submit completes
+            }
+            return true;
+        });
+        other.signals.erase(consumed, other.signals.end());
+    }
+    if (waitSemaphore) {
+        waitSemaphores.push_back(waitSemaphore);
+        waitValues.push_back(0);
+        waitStages.push_back(waitStage);
+    }
+
+    std::vector<VkSemaphore> signalSemaphores;
+    std::vector<uint64_t> signalValues;
+    if (sync.timeline) {
+        signalSemaphores.push_back(timeline.semaphore);
+        signalValues.push_back(value);
+    } else if (kind != VSDL_QueueKind::Graphics) {
+        // Only graphics waits on other queues; give it something to wait on
+        VkSemaphore semaphore = VK_NULL_HANDLE;
+        if (sync.freeSemaphores.empty()) {
+            semaphore = create_binary_semaphore(ctx);
+        } else {
+            semaphore = sync.freeSemaphores.back();
+            sync.freeSemaphores.pop_back();
+        }
+        timeline.signals.push_back({ value, semaphore });
+        signalSemaphores.push_back(timeline.signals.back().second);
+        signalValues.push_back(0);
+    }
+    if (signalSemaphore) {
+        signalSemaphores.push_back(signalSemaphore);
+        signalValues.push_back(0);
+    }
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo = {};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timelineInfo.waitSemaphoreValueCount = (uint32_t)waitValues.size();
+    timelineInfo.pWaitSemaphoreValues = waitValues.data();
+    timelineInfo.signalSemaphoreValueCount = (uint32_t)signalValues.size();
+    timelineInfo.pSignalSemaphoreValues = signalValues.data();
+
+    VkSubmitInfo submitInfo = {};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = sync.timeline ? &timelineInfo : nullptr;
+    submitInfo.waitSemaphoreCount = (uint32_t)waitSemaphores.size();
+    submitInfo.pWaitSemaphores = waitSemaphores.data();
+    submitInfo.pWaitDstStageMask = waitStages.data();
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commandBuffer;
+    submitInfo.signalSemaphoreCount = (uint32_t)signalSemaphores.size();
+    submitInfo.pSignalSemaphores = signalSemaphores.data();
+
+    VkFence fence = VK_NULL_HANDLE;
+    if (!sync.timeline) {
+        if (timeline.freeFences.empty()) {
+            VkFenceCreateInfo fenceInfo = {};
+            fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+            if (vkCreateFence(ctx.device, &fenceInfo, nullptr, &fence) != VK_SUCCESS) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create submit fence");
+                throw std::runtime_error("Fence creation failed");
+            }
+        } else {
+            fence = timeline.freeFences.back();
+            timeline.freeFences.pop_back();
+        }
+    }
+
+    if (vkQueueSubmit(timeline.queue, 1, &submitInfo, fence) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to submit to queue %u", (uint32_t)kind);
+        throw std::runtime_error("Queue submit failed");
+    }
+    timeline.submitted = value;
+    if (fence) timeline.fences.push_back({ value, fence });
+    return value;
+}
\ No newline at end of file
@@ -0,0 +1,485 @@
+#include "vsdl_texture_stream.h"
+#include "vsdl_archive.h"
+#include "vsdl_descriptors.h"
+#include "vsdl_jobs.h"
+#include "vsdl_memory.h"
+#include "vsdl_sync.h"
+#include "vsdl_upload.h"
+#include <SDL3/SDL_log.h>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+// A quarter of the staging ring per frame keeps several frames of uploads in flight without ever
+// blocking on the ring; image creation is capped too so a burst of finished decodes spreads out
+#define VSDL_STREAM_BYTES_PER_FRAME (4ull * 1024 * 1024)
+#define VSDL_STREAM_IMAGES_PER_FRAME 8
+#define VSDL_STREAM_MAX_WORKERS 4
+
+// Input of one decode job
+struct VSDL_StreamSource {
+    std::string path; // Empty when pixels holds the image
+    std::vector<uint8_t> pixels;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    bool generateMips = true;
+    bool srgb = true; // Color images from disk; raw pixels are taken as linear data
+};
+
+// Output of one decode job; mips[0] is the full resolution level
+struct VSDL_DecodedTexture {
+    uint32_t id = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<std::vector<uint8_t>> mips;
+    bool srgb = true;
+    bool failed = false;
+};
+
+// A texture whose image exists and whose levels are still being uploaded
+struct VSDL_StreamingTexture {
+    uint32_t id = 0;
+    std::vector<std::vector<uint8_t>> mips; // Released level by level once copied into the ring
+    uint32_t nextMip = 0; // Levels nextMip .. mipLevels - 1 are uploaded
+};
+
+struct VSDL_TextureStreamer {
+    VSDL_JobSystem* jobs = nullptr;
+    VkSampler sampler = VK_NULL_HANDLE;
+    std::atomic<bool> cancel{false};
+    std::mutex mutex; // Guards decoded
+    std::condition_variable decodedReady;
+    std::deque<VSDL_DecodedTexture> decoded; // Pushed by the workers, popped at the frame boundary
+    std::deque<VSDL_Texture> textures; // Indexed by id; a deque so references survive new requests
+    std::vector<VSDL_StreamingTexture> streaming;
+    std::vector<std::pair<VkImageView, uint64_t>> retiredViews; // View and the graphics value that releases it
+    // Mirrors of the counts above for vsdl_stream_status, which the simulation thread calls while the
+    // render thread streams; only the owning thread writes them
+    std::atomic<uint32_t> requestedCount{0};
+    std::atomic<uint32_t> streamingCount{0};
+    std::atomic<uint32_t> residentCount{0};
+    std::atomic<uint64_t> bytesStreamed{0};
+};
+
+static uint32_t mip_count(uint32_t width, uint32_t height) {
+    uint32_t levels = 1;
+    while ((width | height) >> levels) levels++;
+    return levels;
+}
+
+static bool decode_ppm(const uint8_t* data, size_t size, VSDL_DecodedTexture& out) {
+    if (size < 2 || data[0] != 'P' || data[1] != '6') return false;
+    size_t pos = 2;
+    uint32_t fields[3] = {}; // width, height, maxval
+    for (uint32_t& field : fields) {
+        for (;;) {
+            while (pos < size && isspace(data[pos])) pos++;
+            if (pos >= size || data[pos] != '#') break;
+            while (pos < size && data[pos] != '\n') pos++;
+        }
+        if (pos >= size || !isdigit(data[pos])) return false;
+        while (pos < size && isdigit(data[pos]) && field < 100000) field = field * 10 + (data[pos++] - '0');
+    }
+    pos++; // Single whitespace before the raster
+    uint32_t width = fields[0], height = fields[1];
+    if (!width || !height || fields[2] != 255 || pos + (size_t)width * height * 3 > size) return false;
+
+    std::vector<uint8_t> pixels((size_t)width * height * 4);
+    for (size_t i = 0; i < (size_t)width * height; i++) {
+        pixels[i * 4 + 0] = data[pos + i * 3 + 0];
+        pixels[i * 4 + 1] = data[pos + i * 3 + 1];
+        pixels[i * 4 + 2] = data[pos + i * 3 + 2];
+        pixels[i * 4 + 3] = 255;
+    }
+    out.width = width;
+    out.height = height;
+    out.mips.push_back(std::move(pixels));
+    return true;
+}
+
+// True-color TGA, uncompressed (type 2) or run-length encoded (type 10), 24 or 32 bits per pixel
+static bool decode_tga(const uint8_t* data, size_t size, VSDL_DecodedTexture& out) {
+    if (size < 18) return false;
+    uint8_t imageType = data[2];
+    uint32_t width = data[12] | (data[13] << 8);
+    uint32_t height = data[14] | (data[15] << 8);
+    uint32_t bytesPerPixel = data[16] / 8;
+    bool topDown = (data[17] & 0x20) != 0;
+    if (data[1] != 0 || (imageType != 2 && imageType != 10) || (bytesPerPixel != 3 && bytesPerPixel != 4) ||
+        !width || !height) {
+        return false;
+    }
+
+    size_t pos = 18 + data[0]; // Skip the image id
+    size_t pixelCount = (size_t)width * height;
+    std::vector<uint8_t> pixels(pixelCount * 4);
+    auto readPixel = [&](size_t index) {
+        uint8_t* dst = &pixels[index * 4];
+        dst[0] = data[pos + 2];
+        dst[1] = data[pos + 1];
+        dst[2] = data[pos + 0];
+        dst[3] = bytesPerPixel == 4 ? data[pos + 3] : 255;
+    };
+    for (size_t i = 0; i < pixelCount;) {
+        size_t run = 1;
+        bool repeat = false;
+        if (imageType == 10) {
+            if (pos >= size) return false;
+            run = (data[pos] & 0x7f) + 1;
+            repeat = (data[pos] & 0x80) != 0;
+            pos++;
+        }
+        run = std::min(run, pixelCount - i);
+        for (size_t j = 0; j < run; j++, i++) {
+            if (pos + bytesPerPixel > size) return false;
+            readPixel(i);
+            if (!repeat || j + 1 == run) pos += bytesPerPixel;
+        }
+    }
+
+    if (!topDown) {
+        size_t rowBytes = (size_t)width * 4;
+        for (uint32_t y = 0; y < height / 2; y++) {
+            std::swap_ranges(pixels.begin() + y * rowBytes, pixels.begin() + (y + 1) * rowBytes,
+                             pixels.begin() + (height - 1 - y) * rowBytes);
+        }
+    }
+    out.width = width;
+    out.height = height;
+    out.mips.push_back(std::move(pixels));
+    return true;
+}
+
+// 2x2 box filter down to 1x1; odd edges repeat their last texel
+static void generate_mips(VSDL_DecodedTexture& texture) {
+    uint32_t levels = mip_count(texture.width, texture.height);
+    for (uint32_t level = 1; level < levels; level++) {
+        uint32_t srcWidth = std::max(1u, texture.width >> (level - 1));
+        uint32_t srcHeight = std::max(1u, texture.height >> (level - 1));
+        uint32_t width = std::max(1u, srcWidth / 2);
+        uint32_t height = std::max(1u, srcHeight / 2);
+        const std::vector<uint8_t>& src = texture.mips[level - 1];
+        std::vector<uint8_t> dst((size_t)width * height * 4);
+        for (uint32_t y = 0; y < height; y++) {
+            uint32_t y0 = std::min(y * 2, srcHeight - 1), y1 = std::min(y * 2 + 1, srcHeight - 1);
+            for (uint32_t x = 0; x < width; x++) {
+                uint32_t x0 = std::min(x * 2, srcWidth - 1), x1 = std::min(x * 2 + 1, srcWidth - 1);
+                for (uint32_t c = 0; c < 4; c++) {
+                    uint32_t sum = src[((size_t)y0 * srcWidth + x0) * 4 + c] + src[((size_t)y0 * srcWidth + x1) * 4 + c] +
+                                   src[((size_t)y1 * srcWidth + x0) * 4 + c] + src[((size_t)y1 * srcWidth + x1) * 4 + c];
+                    dst[((size_t)y * width + x) * 4 + c] = (uint8_t)((sum + 2) / 4);
+                }
+            }
+        }
+        texture.mips.push_back(std::move(dst));
+    }
+}
+
+// Runs on a worker: read, decode and build the mip chain
+static void decode_source(const VSDL_Archive& archive, VSDL_StreamSource& source, VSDL_DecodedTexture& out) {
+    if (source.path.empty()) {
+        out.width = source.width;
+        out.height = source.height;
+        out.mips.push_back(std::move(source.pixels));
+    } else {
+        size_t size = 0;
+        const uint8_t* data = vsdl_archive_find(archive, source.path, &size);
+        std::vector<char> file;
+        if (!data) {
+            std::ifstream stream(source.path, std::ios::ate | std::ios::binary);
+            if (!stream.is_open()) {
+                SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Failed to open texture %s", source.path.c_str());
+                out.failed = true;
+                return;
+            }
+            file.resize((size_t)stream.tellg());
+            stream.seekg(0);
+            stream.read(file.data(), file.size());
+            data = reinterpret_cast<const uint8_t*>(file.data());
+            size = file.size();
+        }
+        if (!decode_ppm(data, size, out) && !decode_tga(data, size, out)) {
+            SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Unsupported texture format: %s", source.path.c_str());
+            out.failed = true;
+            return;
+        }
+    }
+    if (source.generateMips) generate_mips(out);
+}
+
+static uint32_t queue_texture(VSDL_Context& ctx, std::shared_ptr<VSDL_StreamSource> source, const std::string& name) {
+    VSDL_TextureStreamer* streamer = ctx.textureStreamer;
+    if (!streamer) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Texture streamer not created");
+        throw std::runtime_error("Texture streamer not created");
+    }
+    uint32_t id = (uint32_t)streamer->textures.size();
+    streamer->textures.emplace_back();
+    streamer->textures.back().name = name;
+    streamer->textures.back().sampler = streamer->sampler;
+    streamer->requestedCount.store((uint32_t)streamer->textures.size(), std::memory_order_relaxed);
+
+    const VSDL_Archive* archive = &ctx.archive;
+    vsdl_jobs_dispatch(streamer->jobs, 1, [streamer, archive, source, id](uint32_t) {
+        if (streamer->cancel.load(std::memory_order_relaxed)) return;
+        VSDL_DecodedTexture decoded;
+        decoded.id = id;
+        decoded.srgb = source->srgb;
+        decode_source(*archive, *source, decoded);
+        std::lock_guard<std::mutex> lock(streamer->mutex);
+        streamer->decoded.push_back(std::move(decoded));
+        streamer->decodedReady.notify_all();
+    });
+    return id;
+}
+
+uint32_t vsdl_stream_texture(VSDL_Context& ctx, const std::string& path) {
+    auto source = std::make_shared<VSDL_StreamSource>();
+    source->path = path;
+    return queue_texture(ctx, source, path);
+}
+
+uint32_t vsdl_stream_texture_pixels(VSDL_Context& ctx, const std::string& name, std::vector<uint8_t> pixels,
+                                    uint32_t width, uint32_t height, bool generateMips) {
+    if (pixels.size() != (size_t)width * height * 4 || !width || !height) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Texture %s: %zu bytes is not %ux%u RGBA8", name.c_str(),
+                     pixels.size(), width, height);
+        throw std::runtime_error("Invalid texture pixels");
+    }
+    auto source = std::make_shared<VSDL_StreamSource>();
+    source->pixels = std::move(pixels);
+    source->width = width;
+    source->height = height;
+    source->generateMips = generateMips;
+    source->srgb = false;
+    return queue_texture(ctx, source, name);
+}
+
+// Create the device image for a decoded texture and queue its levels for upload
+static void begin_streaming(VSDL_Context& ctx, VSDL_TextureStreamer& streamer, VSDL_DecodedTexture& decoded) {
+    VSDL_Texture& texture = streamer.textures[decoded.id];
+    if (decoded.failed) {
+        texture.failed = true;
+        return;
+    }
+
+    VkImageCreateInfo imageInfo = {};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = decoded.srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+    imageInfo.extent = { decoded.width, decoded.height, 1 };
+    imageInfo.mipLevels = (uint32_t)decoded.mips.size();
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    uint32_t queueFamilies[] = { ctx.graphicsQueueFamilyIndex, ctx.transferQueueFamilyIndex };
+    if (ctx.transferQueueFamilyIndex != ctx.graphicsQueueFamilyIndex) {
+        // Written by the transfer queue, sampled by graphics; same reasoning as static buffers
+        imageInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        imageInfo.queueFamilyIndexCount = 2;
+        imageInfo.pQueueFamilyIndices = queueFamilies;
+    }
+    texture.image = vsdl_create_image(ctx, imageInfo, false);
+    texture.mipLevels = imageInfo.mipLevels;
+
+    VSDL_StreamingTexture entry;
+    entry.id = decoded.id;
+    entry.mips = std::move(decoded.mips);
+    entry.nextMip = texture.mipLevels;
+    streamer.streaming.push_back(std::move(entry));
+    streamer.streamingCount.store((uint32_t)streamer.streaming.size(), std::memory_order_relaxed);
+}
+
+static void upload_next_mip(VSDL_Context& ctx, VSDL_TextureStreamer& streamer, VSDL_StreamingTexture& entry) {
+    uint32_t level = entry.nextMip - 1;
+    std::vector<uint8_t>& pixels = entry.mips[level];
+    vsdl_upload_image(ctx, pixels.data(), pixels.size(), streamer.textures[entry.id].image, level);
+    streamer.bytesStreamed.fetch_add(pixels.size(), std::memory_order_relaxed);
+    std::vector<uint8_t>().swap(pixels);
+    entry.nextMip = level;
+}
+
+// Point the texture at a view down to level. The old view and slot may still be read by frames in flight,
+// so the slot is freed through the bindless table's deferral and the view is retired the same way.
+static void publish_level(VSDL_Context& ctx, VSDL_TextureStreamer& streamer, VSDL_Texture& texture, uint32_t level) {
+    VkImageViewCreateInfo viewInfo = {};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = texture.image.image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = texture.image.format;
+    viewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, level, texture.mipLevels - level, 0, 1 };
+    VkImageView view = VK_NULL_HANDLE;
+    if (vkCreateImageView(ctx.device, &viewInfo, nullptr, &view) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create view for texture %s", texture.name.c_str());
+        throw std::runtime_error("Texture view creation failed");
+    }
+
+    if (texture.view) streamer.retiredViews.push_back({ texture.view, vsdl_timeline_pending(ctx, VSDL_QueueKind::Graphics) });
+    if (ctx.descriptors.bindless) {
+        VSDL_BindlessHandle handle = vsdl_bindless_add_texture(ctx, view, streamer.sampler);
+        vsdl_bindless_free(ctx, texture.handle);
+        texture.handle = handle;
+    }
+    texture.view = view;
+    texture.residentMip = level;
+    if (level == 0) streamer.residentCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Move finished decodes into the upload list, at most maxCount of them
+static void take_decoded(VSDL_Context& ctx, VSDL_TextureStreamer& streamer, uint32_t maxCount) {
+    std::deque<VSDL_DecodedTexture> ready;
+    {
+        std::lock_guard<std::mutex> lock(streamer.mutex);
+        while (!streamer.decoded.empty() && ready.size() < maxCount) {
+            ready.push_back(std::move(streamer.decoded.front()));
+            streamer.decoded.pop_front();
+        }
+    }
+    for (auto& decoded : ready) {
+        begin_streaming(ctx, streamer, decoded);
+    }
+}
+
+void vsdl_stream_update(VSDL_Context& ctx) {
+    VSDL_TextureStreamer* streamer = ctx.textureStreamer;
+    if (!streamer) return;
+
+    // Same rule as the bindless table: destroy once every frame that could use the view has completed
+    uint64_t completed = vsdl_timeline_completed(ctx, VSDL_QueueKind::Graphics);
+    auto& retired = streamer->retiredViews;
+    retired.erase(std::remove_if(retired.begin(), retired.end(), [&](const std::pair<VkImageView, uint64_t>& entry) {
+        if (entry.second > completed) return false;
+        vkDestroyImageView(ctx.device, entry.first, nullptr);
+        return true;
+    }), retired.end());
+
+    take_decoded(ctx, *streamer, VSDL_STREAM_IMAGES_PER_FRAME);
+    if (streamer->streaming.empty()) return;
+
+    // One level per texture per pass, so every texture gets its coarse mips before any gets its finest.
+    // A level larger than the whole budget still goes out alone rather than stalling its texture forever.
+    VkDeviceSize budget = VSDL_STREAM_BYTES_PER_FRAME;
+    bool uploaded = true;
+    while (uploaded && budget > 0) {
+        uploaded = false;
+        for (auto& entry : streamer->streaming) {
+            if (entry.nextMip == 0) continue;
+            VkDeviceSize size = entry.mips[entry.nextMip - 1].size();
+            if (size > budget && budget < VSDL_STREAM_BYTES_PER_FRAME) continue;
+            upload_next_mip(ctx, *streamer, entry);
+            budget -= std::min(budget, size);
+            uploaded = true;
+            if (budget == 0) break;
+        }
+    }
+
+    // The graphics submit of this frame waits on the batch holding these copies, so they are visible now
+    for (auto& entry : streamer->streaming) {
+        VSDL_Texture& texture = streamer->textures[entry.id];
+        if (entry.nextMip < texture.residentMip) publish_level(ctx, *streamer, texture, entry.nextMip);
+    }
+    auto& streaming = streamer->streaming;
+    streaming.erase(std::remove_if(streaming.begin(), streaming.end(),
+                                   [](const VSDL_StreamingTexture& entry) { return entry.nextMip == 0; }),
+                    streaming.end());
+    streamer->streamingCount.store((uint32_t)streaming.size(), std::memory_order_relaxed);
+}
+
+bool vsdl_stream_wait(VSDL_Context& ctx, uint32_t id) {
+    VSDL_TextureStreamer* streamer = ctx.textureStreamer;
+    VSDL_Texture& texture = streamer->textures.at(id);
+    for (;;) {
+        if (texture.failed) return false;
+        if (texture.residentMip == 0) return true;
+
+        take_decoded(ctx, *streamer, UINT32_MAX);
+        auto entry = std::find_if(streamer->streaming.begin(), streamer->streaming.end(),
+                                  [id](const VSDL_StreamingTexture& candidate) { return candidate.id == id; });
+        if (entry != streamer->streaming.end()) {
+            while (entry->nextMip > 0) upload_next_mip(ctx, *streamer, *entry);
+            publish_level(ctx, *streamer, texture, 0);
+            streamer->streaming.erase(entry);
+            streamer->streamingCount.store((uint32_t)streamer->streaming.size(), std::memory_order_relaxed);
+            vsdl_finish_uploads(ctx);
+            return true;
+        }
+        if (texture.failed) return false;
+
+        std::unique_lock<std::mutex> lock(streamer->mutex);
+        streamer->decodedReady.wait(lock, [streamer] { return !streamer->decoded.empty(); });
+    }
+}
+
+const VSDL_Texture& vsdl_get_texture(VSDL_Context& ctx, uint32_t id) {
+    return ctx.textureStreamer->textures.at(id);
+}
+
+std::string vsdl_stream_status(VSDL_Context& ctx) {
+    VSDL_TextureStreamer* streamer = ctx.textureStreamer;
+    if (!streamer) return "off";
+    char status[128];
+    snprintf(status, sizeof(status), "%u / %u resident, %u streaming, %.1f MB streamed",
+             streamer->residentCount.load(std::memory_order_relaxed), streamer->requestedCount.load(std::memory_order_relaxed),
+             streamer->streamingCount.load(std::memory_order_relaxed),
+             streamer->bytesStreamed.load(std::memory_order_relaxed) / (1024.0 * 1024.0));
+    return status;
+}
+
+bool vsdl_create_texture_streamer(VSDL_Context& ctx) {
+    VkSamplerCreateInfo samplerInfo = {};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_LINEAR;
+    samplerInfo.minFilter = VK_FILTER_LINEAR;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+    VkSampler sampler = VK_NULL_HANDLE;
+    if (vkCreateSampler(ctx.device, &samplerInfo, nullptr, &sampler) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create texture sampler");
+        return false;
+    }
+
+    // Leave a core for the main thread; decoding is short-lived and bound by memory bandwidth beyond a few
+    uint32_t workers = std::min((uint32_t)VSDL_STREAM_MAX_WORKERS, std::max(1u, std::thread::hardware_concurrency() - 1));
+    VSDL_TextureStreamer* streamer = new VSDL_TextureStreamer();
+    streamer->sampler = sampler;
+    streamer->jobs = vsdl_create_job_system(workers);
+    ctx.textureStreamer = streamer;
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Texture streamer: %u decode worker(s), %llu MB per frame", workers,
+                (unsigned long long)(VSDL_STREAM_BYTES_PER_FRAME / (1024 * 1024)));
+    return true;
+}
+
+void vsdl_destroy_texture_streamer(VSDL_Context& ctx) {
+    VSDL_TextureStreamer* streamer = ctx.textureStreamer;
+    if (!streamer) return;
+
+    // Queued jobs see the flag and return at once; running ones finish their image
+    streamer->cancel.store(true, std::memory_order_relaxed);
+    vsdl_destroy_job_system(streamer->jobs);
+
+    for (auto& entry : streamer->retiredViews) {
+        vkDestroyImageView(ctx.device, entry.first, nullptr);
+    }
+    for (auto& texture : streamer->textures) {
+        if (texture.view) vkDestroyImageView(ctx.device, texture.view, nullptr);
+        vsdl_bindless_free(ctx, texture.handle);
+        vsdl_destroy_image(ctx, texture.image);
+    }
+    vkDestroySampler(ctx.device, streamer->sampler, nullptr);
+    delete streamer;
+    ctx.textureStreamer = nullptr;
+}
\ No newline at end of file
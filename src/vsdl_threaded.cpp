@@ -0,0 +1,185 @@
+#include "vsdl_threaded.h"
+#include "vsdl_renderer.h"
+#include "vsdl_profiler.h"
+#include "vsdl_imgui.h"
+#include "imgui.h"
+#include <SDL3/SDL_log.h>
+#include <SDL3/SDL_timer.h>
+#include <atomic>
+#include <exception>
+#include <thread>
+
+#define VSDL_SNAPSHOT_FRESH 4u // Set in the shared index when the writer published since the last read
+
+// Everything the render thread needs from one simulation tick
+struct VSDL_FrameSnapshot {
+    ImDrawData drawData;
+    ImVector<ImDrawList*> drawLists; // Owned copies, reused from tick to tick
+    uint64_t tick = 0; // 0 until the slot is first written
+    Uint64 inputCounter = 0; // SDL_GetPerformanceCounter() when this tick's input was sampled
+    VSDL_UiSettings settings; // The simulation thread's UI edits as of this tick
+};
+
+// Single producer/single consumer triple buffer: the writer and reader each own one slot and swap
+// it with the shared middle slot, so neither side ever waits for the other
+struct VSDL_SnapshotBuffer {
+    VSDL_FrameSnapshot slots[3];
+    std::atomic<uint32_t> middle{1}; // Slot index | VSDL_SNAPSHOT_FRESH
+    uint32_t writeIndex = 0; // Simulation thread only
+    uint32_t readIndex = 2;  // Render thread only
+};
+
+struct VSDL_ThreadedState {
+    VSDL_SnapshotBuffer snapshots;
+    std::atomic<bool> quit{false};
+    std::atomic<bool> resized{false}; // Not part of the snapshot, a skipped snapshot must not lose it
+    std::atomic<uint64_t> framesRendered{0};
+    std::atomic<float> inputLatencyMs{0.0f};
+    double latencySumMs = 0.0; // Render thread only, read after join
+    uint64_t latencySamples = 0;
+    std::exception_ptr error;
+};
+
+// Deep copy the draw lists, ImGui reuses its own buffers on the next NewFrame
+static void copy_draw_data(VSDL_FrameSnapshot& snapshot, const ImDrawData* source) {
+    while (snapshot.drawLists.Size < source->CmdListsCount) {
+        snapshot.drawLists.push_back(IM_NEW(ImDrawList)(source->CmdLists[0]->_Data));
+    }
+    snapshot.drawData = *source;
+    for (int i = 0; i < source->CmdListsCount; i++) {
+        const ImDrawList* sourceList = source->CmdLists[i];
+        ImDrawList* list = snapshot.drawLists[i];
+        list->CmdBuffer = sourceList->CmdBuffer;
+        list->IdxBuffer = sourceList->IdxBuffer;
+        list->VtxBuffer = sourceList->VtxBuffer;
+        list->Flags = sourceList->Flags;
+        snapshot.drawData.CmdLists[i] = list;
+    }
+}
+
+static void publish_snapshot(VSDL_SnapshotBuffer& buffer) {
+    uint32_t previous = buffer.middle.exchange(buffer.writeIndex | VSDL_SNAPSHOT_FRESH, std::memory_order_acq_rel);
+    buffer.writeIndex = previous & 3u;
+}
+
+static bool consume_snapshot(VSDL_SnapshotBuffer& buffer) {
+    if (!(buffer.middle.load(std::memory_order_acquire) & VSDL_SNAPSHOT_FRESH)) return false;
+    uint32_t previous = buffer.middle.exchange(buffer.readIndex, std::memory_order_acq_rel);
+    buffer.readIndex = previous & 3u;
+    return true;
+}
+
+static void render_thread_main(VSDL_Context& ctx, VSDL_ThreadedState& state) {
+    try {
+        while (!state.quit.load(std::memory_order_acquire)) {
+            // Only render new ticks; presenting the same snapshot twice would add nothing but GPU load
+            if (!consume_snapshot(state.snapshots)) {
+                SDL_DelayNS(250000);
+                continue;
+            }
+            VSDL_FrameSnapshot& snapshot = state.snapshots.slots[state.snapshots.readIndex];
+
+            if (state.resized.exchange(false)) ctx.swapchainOutOfDate = true;
+            if (SDL_GetWindowFlags(ctx.window) & SDL_WINDOW_MINIMIZED) continue;
+
+            ctx.uiDrawData = &snapshot.drawData;
+            ctx.uiSettings = snapshot.settings;
+            vsdl_draw_frame(ctx);
+
+            Uint64 now = SDL_GetPerformanceCounter();
+            float latencyMs = (float)((double)(now - snapshot.inputCounter) * 1000.0 / (double)SDL_GetPerformanceFrequency());
+            vsdl_profiler_cpu_scope(ctx, "input to present", snapshot.inputCounter);
+            state.inputLatencyMs.store(latencyMs, std::memory_order_relaxed);
+            state.latencySumMs += latencyMs;
+            state.latencySamples++;
+            state.framesRendered.fetch_add(1, std::memory_order_relaxed);
+        }
+    } catch (...) {
+        state.error = std::current_exception();
+        state.quit.store(true, std::memory_order_release);
+    }
+}
+
+void vsdl_threaded_loop(VSDL_Context& ctx, float tickHz) {
+    if (!ctx.frames[0].commandBuffer) vsdl_create_frames(ctx);
+    if (tickHz <= 0.0f) tickHz = 120.0f;
+    const Uint64 tickNs = (Uint64)((double)SDL_NS_PER_SECOND / tickHz);
+
+    VSDL_ThreadedState state;
+    // The simulation thread's copy of what the UI edits, seeded before the render thread takes over ctx
+    VSDL_UiSettings settings = ctx.uiSettings;
+    std::thread renderThread(render_thread_main, std::ref(ctx), std::ref(state));
+
+    uint64_t tick = 0;
+    uint64_t lastFrames = 0;
+    float renderFps = 0.0f;
+    Uint64 rateStart = SDL_GetTicksNS();
+    Uint64 nextTick = rateStart;
+    std::exception_ptr simulationError;
+    try {
+        // SDL only delivers events on the main thread, so input and simulation stay here
+        while (!state.quit.load(std::memory_order_acquire)) {
+            Uint64 inputCounter = SDL_GetPerformanceCounter();
+            SDL_Event event;
+            while (SDL_PollEvent(&event)) {
+                vsdl::imgui_new_frame(ctx, event);
+                if (event.type == SDL_EVENT_QUIT) state.quit.store(true, std::memory_order_release);
+                if (event.type == SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED) state.resized.store(true);
+            }
+            vsdl_profiler_cpu_scope(ctx, "events", inputCounter);
+
+            tick++;
+            Uint64 now = SDL_GetTicksNS();
+            if (now - rateStart >= SDL_NS_PER_SECOND) {
+                uint64_t frames = state.framesRendered.load(std::memory_order_relaxed);
+                renderFps = (float)((double)(frames - lastFrames) * SDL_NS_PER_SECOND / (double)(now - rateStart));
+                lastFrames = frames;
+                rateStart = now;
+            }
+
+            Uint64 scopeStart = SDL_GetPerformanceCounter();
+            vsdl_build_ui(ctx, &settings);
+            ImGui::Begin("Test Window"); // Appends to the window opened by vsdl_build_ui
+            if (ImGui::CollapsingHeader("Threading")) { // Closed by default like Statistics, the tick count never holds still
+                ImGui::Text("Sim tick %llu at %.0f Hz, render %.1f FPS", (unsigned long long)tick, tickHz, renderFps);
+                ImGui::Text("Input to present: %.2f ms", state.inputLatencyMs.load(std::memory_order_relaxed));
+            }
+            ImGui::End();
+            ImGui::Render();
+
+            VSDL_FrameSnapshot& snapshot = state.snapshots.slots[state.snapshots.writeIndex];
+            copy_draw_data(snapshot, ImGui::GetDrawData());
+            snapshot.tick = tick;
+            snapshot.inputCounter = inputCounter;
+            snapshot.settings = settings;
+            publish_snapshot(state.snapshots);
+            vsdl_profiler_cpu_scope(ctx, "ui", scopeStart);
+
+            // Fixed tick; after a long hitch resynchronize instead of running a burst of catch-up ticks
+            nextTick += tickNs;
+            now = SDL_GetTicksNS();
+            if (now < nextTick) {
+                SDL_DelayPrecise(nextTick - now);
+            } else if (now - nextTick > 4 * tickNs) {
+                nextTick = now;
+            }
+        }
+    } catch (...) {
+        simulationError = std::current_exception();
+        state.quit.store(true, std::memory_order_release);
+    }
+    renderThread.join();
+
+    // Snapshots die with this function; the draw data was copied into ImGui's vertex buffers at record time
+    vkDeviceWaitIdle(ctx.device);
+    ctx.uiDrawData = nullptr;
+    for (auto& snapshot : state.snapshots.slots) {
+        for (ImDrawList* list : snapshot.drawLists) IM_DELETE(list);
+    }
+
+    if (simulationError) std::rethrow_exception(simulationError);
+    if (state.error) std::rethrow_exception(state.error);
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Threaded loop: %llu ticks at %.0f Hz, %llu frames, average input to present %.2f ms",
+                (unsigned long long)tick, tickHz, (unsigned long long)state.framesRendered.load(),
+                state.latencySamples ? state.latencySumMs / state.latencySamples : 0.0);
+}
\ No newline at end of file
@@ -0,0 +1,133 @@
+#include "vsdl_transforms.h"
+#include "imgui.h"
+#include <algorithm>
+#include <cmath>
+
+#define VSDL_PI 3.14159265358979f
+
+void vsdl_update_camera(VSDL_Context& ctx) {
+    VSDL_Camera& camera = ctx.camera;
+    float aspect = ctx.swapchainExtent.height ? (float)ctx.swapchainExtent.width / (float)ctx.swapchainExtent.height : 1.0f;
+
+    glm::vec3 forward(std::cos(camera.pitch) * std::sin(camera.yaw), std::sin(camera.pitch),
+                      -std::cos(camera.pitch) * std::cos(camera.yaw));
+    camera.view = glm::lookAt(camera.position, camera.position + forward, glm::vec3(0.0f, 1.0f, 0.0f));
+
+    // Written out by hand: GLM has no reverse-Z variants. Column-major, Y negated for Vulkan.
+    glm::mat4 projection(0.0f);
+    if (camera.perspective) {
+        // Infinite far plane: depth = near / -z, 1 at the near plane and 0 at infinity
+        float focal = 1.0f / std::tan(camera.fovY * 0.5f);
+        projection[0][0] = focal / aspect;
+        projection[1][1] = -focal;
+        projection[2][3] = -1.0f;
+        projection[3][2] = camera.nearZ;
+    } else {
+        // depth = (z + far) / (far - near): 1 at the near plane, 0 at the far plane
+        float halfHeight = camera.orthoHeight * 0.5f;
+        projection[0][0] = 1.0f / (halfHeight * aspect);
+        projection[1][1] = -1.0f / halfHeight;
+        projection[2][2] = 1.0f / (camera.farZ - camera.nearZ);
+        projection[3][2] = camera.farZ / (camera.farZ - camera.nearZ);
+        projection[3][3] = 1.0f;
+    }
+    camera.projection = projection;
+    camera.viewProjection = projection * camera.view;
+}
+
+void vsdl_camera_ui(VSDL_Camera& camera) {
+    if (!ImGui::CollapsingHeader("Camera")) return;
+    ImGui::Checkbox("Perspective", &camera.perspective);
+    ImGui::DragFloat3("Position", &camera.position.x, 0.01f);
+    ImGui::SliderAngle("Yaw", &camera.yaw, -180.0f, 180.0f);
+    ImGui::SliderAngle("Pitch", &camera.pitch, -89.0f, 89.0f);
+    if (camera.perspective) {
+        ImGui::SliderAngle("Field of view", &camera.fovY, 20.0f, 120.0f);
+    } else {
+        ImGui::DragFloat("Height", &camera.orthoHeight, 0.01f, 0.1f, 100.0f);
+    }
+    if (ImGui::Button("Reset camera")) camera = VSDL_Camera{};
+}
+
+void vsdl_generate_transforms(VSDL_Transforms& transforms, uint32_t count) {
+    uint32_t seed = 0x9E3779B9u;
+    auto random01 = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return (float)(seed >> 8) / (float)(1u << 24);
+    };
+    float scale = std::clamp(0.6f / std::sqrt((float)std::max(count, 1u)), 0.004f, 0.5f);
+
+    transforms.count = count;
+    for (auto* component : { &transforms.positionX, &transforms.positionY, &transforms.positionZ, &transforms.scale,
+                             &transforms.angle, &transforms.spin, &transforms.colorR, &transforms.colorG, &transforms.colorB }) {
+        component->resize(count);
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        transforms.positionX[i] = random01() * 2.4f - 1.2f;
+        transforms.positionY[i] = random01() * 2.4f - 1.2f;
+        transforms.positionZ[i] = 0.0f;
+        transforms.scale[i] = scale;
+        transforms.angle[i] = 0.0f;
+        transforms.spin[i] = (random01() - 0.5f) * 2.0f; // Up to about 60 degrees per second either way
+        transforms.colorR[i] = 0.5f + 0.5f * random01();
+        transforms.colorG[i] = 0.5f + 0.5f * random01();
+        transforms.colorB[i] = 0.5f + 0.5f * random01();
+    }
+}
+
+// Branch-free sine for x in [-pi, pi] (parabola plus one refinement step, error below 0.001). Unlike
+// std::sin it has no range reduction or libm call, so the loops below stay vectorizable.
+static inline float fast_sin(float x) {
+    const float b = 4.0f / VSDL_PI;
+    const float c = -4.0f / (VSDL_PI * VSDL_PI);
+    float y = b * x + c * x * std::fabs(x);
+    return 0.225f * (y * std::fabs(y) - y) + y;
+}
+
+void vsdl_update_transforms(VSDL_Transforms& transforms, float dtSeconds, VSDL_ObjectData* out) {
+    const uint32_t count = transforms.count;
+    float* angle = transforms.angle.data();
+    const float* spin = transforms.spin.data();
+
+    // The step stays well under 2 pi, so one conditional wrap keeps angles in [-pi, pi]
+    for (uint32_t i = 0; i < count; i++) {
+        float a = angle[i] + spin[i] * dtSeconds;
+        a -= a > VSDL_PI ? 2.0f * VSDL_PI : 0.0f;
+        a += a < -VSDL_PI ? 2.0f * VSDL_PI : 0.0f;
+        angle[i] = a;
+    }
+
+    const float* positionX = transforms.positionX.data();
+    const float* positionY = transforms.positionY.data();
+    const float* positionZ = transforms.positionZ.data();
+    const float* scale = transforms.scale.data();
+    const float* colorR = transforms.colorR.data();
+    const float* colorG = transforms.colorG.data();
+    const float* colorB = transforms.colorB.data();
+    for (uint32_t i = 0; i < count; i++) {
+        float a = angle[i];
+        float sine = fast_sin(a);
+        float shifted = a + 0.5f * VSDL_PI; // cos(a) = sin(a + pi/2), wrapped back into range
+        shifted -= shifted > VSDL_PI ? 2.0f * VSDL_PI : 0.0f;
+        float cosine = fast_sin(shifted);
+
+        // Rotation about Z times uniform scale, then translation
+        VSDL_ObjectData& object = out[i];
+        object.world[0][0] = cosine * scale[i];
+        object.world[0][1] = -sine * scale[i];
+        object.world[0][2] = 0.0f;
+        object.world[0][3] = positionX[i];
+        object.world[1][0] = sine * scale[i];
+        object.world[1][1] = cosine * scale[i];
+        object.world[1][2] = 0.0f;
+        object.world[1][3] = positionY[i];
+        object.world[2][0] = 0.0f;
+        object.world[2][1] = 0.0f;
+        object.world[2][2] = scale[i];
+        object.world[2][3] = positionZ[i];
+        object.color[0] = colorR[i];
+        object.color[1] = colorG[i];
+        object.color[2] = colorB[i];
+        object.color[3] = 1.0f;
+    }
+}
\ No newline at end of file
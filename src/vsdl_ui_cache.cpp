@@ -0,0 +1,508 @@
+#include "vsdl_ui_cache.h"
+#include "vsdl_memory.h"
+#include "vsdl_pipeline.h"
+#include "vsdl_profiler.h"
+#include "vsdl_upload.h"
+#include "imgui.h"
+#include "imgui_impl_vulkan.h"
+#include <SDL3/SDL_log.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+// Word at a time: the vertices dominate, and a byte-wise FNV over them would cost more than a replay saves
+static uint64_t hash_bytes(uint64_t hash, const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, bytes + i, 8);
+        hash = (hash ^ word) * 0x9E3779B97F4A7C15ull;
+        hash ^= hash >> 29;
+    }
+    uint64_t tail = size;
+    if (i < size) memcpy(&tail, bytes + i, size - i);
+    hash = (hash ^ tail) * 0x9E3779B97F4A7C15ull;
+    return hash ^ (hash >> 32);
+}
+
+// Everything the backend reads to draw a frame; texture ids only as handles, their contents never change
+static uint64_t hash_draw_data(const ImDrawData* drawData) {
+    float view[6] = { drawData->DisplayPos.x, drawData->DisplayPos.y, drawData->DisplaySize.x, drawData->DisplaySize.y,
+                      drawData->FramebufferScale.x, drawData->FramebufferScale.y };
+    uint64_t hash = hash_bytes(14695981039346656037ull, view, sizeof(view));
+    for (int i = 0; i < drawData->CmdListsCount; i++) {
+        const ImDrawList* list = drawData->CmdLists[i];
+        hash = hash_bytes(hash, list->VtxBuffer.Data, (size_t)list->VtxBuffer.Size * sizeof(ImDrawVert));
+        hash = hash_bytes(hash, list->IdxBuffer.Data, (size_t)list->IdxBuffer.Size * sizeof(ImDrawIdx));
+        for (const ImDrawCmd& cmd : list->CmdBuffer) {
+            uint64_t fields[5];
+            memcpy(fields, &cmd.ClipRect, sizeof(float) * 4);
+            fields[2] = (uint64_t)cmd.GetTexID();
+            fields[3] = (uint64_t)cmd.VtxOffset << 32 | cmd.IdxOffset;
+            fields[4] = (uint64_t)cmd.ElemCount << 1 | (cmd.UserCallback != nullptr);
+            hash = hash_bytes(hash, fields, sizeof(fields));
+        }
+    }
+    return hash;
+}
+
+static void create_layer_pass(VSDL_Context& ctx) {
+    VkAttachmentDescription colorAttachment = {};
+    colorAttachment.format = ctx.swapchainImageFormat;
+    colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR; // Transparent
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    VkAttachmentReference colorRef = { 0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+    VkSubpassDescription subpass = {};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = 1;
+    subpass.pColorAttachments = &colorRef;
+
+    // In: earlier composites must be done reading. Out: the composite reads what the pass wrote.
+    VkSubpassDependency dependencies[2] = {};
+    dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[0].dstSubpass = 0;
+    dependencies[0].srcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependencies[1].srcSubpass = 0;
+    dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependencies[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+    VkRenderPassCreateInfo renderPassInfo = {};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    renderPassInfo.attachmentCount = 1;
+    renderPassInfo.pAttachments = &colorAttachment;
+    renderPassInfo.subpassCount = 1;
+    renderPassInfo.pSubpasses = &subpass;
+    renderPassInfo.dependencyCount = 2;
+    renderPassInfo.pDependencies = dependencies;
+    if (vkCreateRenderPass(ctx.device, &renderPassInfo, nullptr, &ctx.ui.layerPass) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create UI layer render pass");
+        throw std::runtime_error("Render pass creation failed");
+    }
+}
+
+void vsdl_create_ui_cache(VSDL_Context& ctx) {
+    VSDL_UiRenderer& ui = ctx.ui;
+
+    VkSamplerCreateInfo samplerInfo = {};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_NEAREST;
+    samplerInfo.minFilter = VK_FILTER_NEAREST;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    if (vkCreateSampler(ctx.device, &samplerInfo, nullptr, &ui.layerSampler) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create UI layer sampler");
+        throw std::runtime_error("Sampler creation failed");
+    }
+
+    // Identical to the backend's own set layout: one combined image sampler for the fragment stage
+    VkDescriptorSetLayoutBinding binding = {};
+    binding.binding = 0;
+    binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    binding.descriptorCount = 1;
+    binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = 1;
+    layoutInfo.pBindings = &binding;
+    if (vkCreateDescriptorSetLayout(ctx.device, &layoutInfo, nullptr, &ui.setLayout) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create UI descriptor set layout");
+        throw std::runtime_error("Descriptor set layout creation failed");
+    }
+
+    VkPushConstantRange pushRange = {};
+    pushRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    pushRange.size = sizeof(float) * 4;
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &ui.setLayout;
+    pipelineLayoutInfo.pushConstantRangeCount = 1;
+    pipelineLayoutInfo.pPushConstantRanges = &pushRange;
+    if (vkCreatePipelineLayout(ctx.device, &pipelineLayoutInfo, nullptr, &ui.pipelineLayout) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create UI pipeline layout");
+        throw std::runtime_error("Pipeline layout creation failed");
+    }
+
+    if (!ctx.dynamicRendering.enabled) create_layer_pass(ctx);
+
+    VSDL_PipelineKey key = vsdl_pipeline_key(ctx, "shaders/imgui.vert.spv", "shaders/imgui.frag.spv", ui.pipelineLayout);
+    key.vertexInput = VSDL_VertexInput::ImGui;
+    key.cullMode = VK_CULL_MODE_NONE;
+    key.blend = VSDL_BlendMode::Premultiplied;
+    key.depth = VSDL_DepthMode::Disabled;
+    VSDL_PipelineKey layerKey = key;
+    layerKey.renderPass = ui.layerPass;
+    layerKey.depthFormat = VK_FORMAT_UNDEFINED;
+    VSDL_PipelineKey compositeKey = key;
+    compositeKey.vertShader = vsdl_pipeline_shader(ctx, "shaders/ui_composite.vert.spv");
+    compositeKey.fragShader = vsdl_pipeline_shader(ctx, "shaders/ui_composite.frag.spv");
+    compositeKey.vertexInput = VSDL_VertexInput::None;
+    std::vector<VSDL_PipelineId> ids = vsdl_prewarm_pipelines(ctx, { key, layerKey, compositeKey });
+    ui.pipeline = ids[0];
+    ui.layerPipeline = ids[1];
+    ui.compositePipeline = ids[2];
+}
+
+static void destroy_layer(VSDL_Context& ctx) {
+    VSDL_UiRenderer& ui = ctx.ui;
+    if (ui.layerTexture) ImGui_ImplVulkan_RemoveTexture(ui.layerTexture);
+    ui.layerTexture = VK_NULL_HANDLE;
+    if (ui.layerFramebuffer) vkDestroyFramebuffer(ctx.device, ui.layerFramebuffer, nullptr);
+    ui.layerFramebuffer = VK_NULL_HANDLE;
+    if (ui.layerView) vkDestroyImageView(ctx.device, ui.layerView, nullptr);
+    ui.layerView = VK_NULL_HANDLE;
+    vsdl_destroy_image(ctx, ui.layer);
+    ui.layerValid = false;
+}
+
+static void destroy_slots(VSDL_Context& ctx) {
+    for (VSDL_UiCacheSlot& slot : ctx.ui.slots) {
+        vsdl_destroy_buffer(ctx, slot.vertexBuffer);
+        vsdl_destroy_buffer(ctx, slot.indexBuffer);
+        slot = VSDL_UiCacheSlot{};
+    }
+}
+
+void vsdl_destroy_ui_cache(VSDL_Context& ctx) {
+    VSDL_UiRenderer& ui = ctx.ui;
+    if (ui.reusedFrames + ui.redrawnFrames > 0) {
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "UI %s: %llu frames reused, %llu redrawn", vsdl_ui_mode_name(ui.mode),
+                    (unsigned long long)ui.reusedFrames, (unsigned long long)ui.redrawnFrames);
+    }
+    destroy_layer(ctx);
+    destroy_slots(ctx);
+    // The pipelines belong to the library
+    if (ui.layerPass) vkDestroyRenderPass(ctx.device, ui.layerPass, nullptr);
+    if (ui.pipelineLayout) vkDestroyPipelineLayout(ctx.device, ui.pipelineLayout, nullptr);
+    if (ui.setLayout) vkDestroyDescriptorSetLayout(ctx.device, ui.setLayout, nullptr);
+    if (ui.layerSampler) vkDestroySampler(ctx.device, ui.layerSampler, nullptr);
+    // Field by field, the atomic makes the struct non-assignable
+    ui.drawData = nullptr;
+    ui.hash = 0;
+    ui.stableFrames = 0;
+    ui.reusedFrames = 0;
+    ui.redrawnFrames = 0;
+    ui.lastReused.store(false, std::memory_order_relaxed);
+    ui.setLayout = VK_NULL_HANDLE;
+    ui.pipelineLayout = VK_NULL_HANDLE;
+    ui.pipeline = VSDL_NO_PIPELINE;
+    ui.layerPipeline = VSDL_NO_PIPELINE;
+    ui.compositePipeline = VSDL_NO_PIPELINE;
+    ui.layerPass = VK_NULL_HANDLE;
+    ui.layerSampler = VK_NULL_HANDLE;
+    ui.layerHash = 0;
+}
+
+void vsdl_resize_ui_cache(VSDL_Context& ctx) {
+    // The backend's own buffers go with ImGui_ImplVulkan_SetMinImageCount, ours go with the extent
+    destroy_layer(ctx);
+    destroy_slots(ctx);
+}
+
+void vsdl_set_ui_mode(VSDL_Context& ctx, VSDL_UiMode mode) {
+    VSDL_UiRenderer& ui = ctx.ui;
+    if (mode == ui.mode) return;
+    ui.mode = mode;
+    ui.stableFrames = 0;
+    ui.layerValid = false;
+}
+
+void vsdl_ui_begin_frame(VSDL_Context& ctx, ImDrawData* drawData) {
+    VSDL_UiRenderer& ui = ctx.ui;
+    ui.drawData = drawData;
+    if (ui.mode == VSDL_UiMode::Direct) {
+        ui.lastReused.store(false, std::memory_order_relaxed);
+        return;
+    }
+    uint64_t hash = hash_draw_data(drawData);
+    ui.stableFrames = hash == ui.hash ? ui.stableFrames + 1 : 0;
+    ui.hash = hash;
+}
+
+static void create_layer(VSDL_Context& ctx) {
+    VSDL_UiRenderer& ui = ctx.ui;
+    VkImageCreateInfo imageInfo = {};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = ctx.swapchainImageFormat;
+    imageInfo.extent = { ctx.swapchainExtent.width, ctx.swapchainExtent.height, 1 };
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    ui.layer = vsdl_create_image(ctx, imageInfo, true); // Resized with the swapchain, like the depth buffer
+
+    VkImageViewCreateInfo viewInfo = {};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = ui.layer.image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = imageInfo.format;
+    viewInfo.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+    if (vkCreateImageView(ctx.device, &viewInfo, nullptr, &ui.layerView) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create UI layer view");
+        throw std::runtime_error("Image view creation failed");
+    }
+
+    if (ui.layerPass) {
+        VkFramebufferCreateInfo framebufferInfo = {};
+        framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        framebufferInfo.renderPass = ui.layerPass;
+        framebufferInfo.attachmentCount = 1;
+        framebufferInfo.pAttachments = &ui.layerView;
+        framebufferInfo.width = ctx.swapchainExtent.width;
+        framebufferInfo.height = ctx.swapchainExtent.height;
+        framebufferInfo.layers = 1;
+        if (vkCreateFramebuffer(ctx.device, &framebufferInfo, nullptr, &ui.layerFramebuffer) != VK_SUCCESS) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create UI layer framebuffer");
+            throw std::runtime_error("Framebuffer creation failed");
+        }
+    }
+
+    ui.layerTexture = ImGui_ImplVulkan_AddTexture(ui.layerSampler, ui.layerView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    ui.layerValid = false;
+}
+
+static void layer_barrier(VSDL_Context& ctx, VkCommandBuffer commandBuffer, VkImageLayout oldLayout, VkImageLayout newLayout,
+                          VkPipelineStageFlags srcStage, VkAccessFlags srcAccess, VkPipelineStageFlags dstStage,
+                          VkAccessFlags dstAccess) {
+    VkImageMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstAccessMask = dstAccess;
+    barrier.oldLayout = oldLayout;
+    barrier.newLayout = newLayout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = ctx.ui.layer.image;
+    barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+    vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+void vsdl_record_ui_layer(VSDL_Context& ctx, VkCommandBuffer commandBuffer) {
+    VSDL_UiRenderer& ui = ctx.ui;
+    if (ui.mode != VSDL_UiMode::Layer) return;
+    if (!ui.layer.image) create_layer(ctx);
+    bool reused = ui.layerValid && ui.layerHash == ui.hash;
+    ui.lastReused.store(reused, std::memory_order_relaxed);
+    if (reused) {
+        ui.reusedFrames++;
+        return;
+    }
+    ui.redrawnFrames++;
+
+    // One layer shared by every frame slot: the pass waits for earlier composites on the same queue
+    vsdl_gpu_scope_begin(ctx, commandBuffer, "ui layer");
+    VkClearValue clearValue = {}; // Transparent black, the identity for premultiplied blending
+    if (ctx.dynamicRendering.enabled) {
+        layer_barrier(ctx, commandBuffer, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                      VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                      VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT);
+        VkRenderingAttachmentInfo attachment = {};
+        attachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+        attachment.imageView = ui.layerView;
+        attachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        attachment.clearValue = clearValue;
+        VkRenderingInfo renderingInfo = {};
+        renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+        renderingInfo.renderArea.extent = ctx.swapchainExtent;
+        renderingInfo.layerCount = 1;
+        renderingInfo.colorAttachmentCount = 1;
+        renderingInfo.pColorAttachments = &attachment;
+        ctx.dynamicRendering.cmdBeginRendering(commandBuffer, &renderingInfo);
+    } else {
+        VkRenderPassBeginInfo renderPassInfo = {};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderPassInfo.renderPass = ui.layerPass;
+        renderPassInfo.framebuffer = ui.layerFramebuffer;
+        renderPassInfo.renderArea.extent = ctx.swapchainExtent;
+        renderPassInfo.clearValueCount = 1;
+        renderPassInfo.pClearValues = &clearValue;
+        vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    }
+
+    // A changed UI is new geometry either way, so the backend uploads it as usual, just into the layer
+    ImGui_ImplVulkan_RenderDrawData(ui.drawData, commandBuffer, vsdl_pipeline(ctx, ui.layerPipeline));
+
+    if (ctx.dynamicRendering.enabled) {
+        ctx.dynamicRendering.cmdEndRendering(commandBuffer);
+        layer_barrier(ctx, commandBuffer, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                      VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                      VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+    } else {
+        vkCmdEndRenderPass(commandBuffer); // finalLayout does the transition
+    }
+    vsdl_gpu_scope_end(ctx, commandBuffer);
+
+    ui.layerHash = ui.hash;
+    ui.layerValid = true;
+}
+
+// Project the draw commands the way the backend does and upload the geometry into the slot's buffers.
+// False for UIs the replay can't reproduce (user callbacks).
+static bool build_slot(VSDL_Context& ctx, VSDL_UiCacheSlot& slot) {
+    const ImDrawData* drawData = ctx.ui.drawData;
+    float width = drawData->DisplaySize.x * drawData->FramebufferScale.x;
+    float height = drawData->DisplaySize.y * drawData->FramebufferScale.y;
+    slot.valid = false;
+    slot.draws.clear();
+
+    uint32_t globalVertex = 0;
+    uint32_t globalIndex = 0;
+    for (int i = 0; i < drawData->CmdListsCount && width > 0.0f && height > 0.0f; i++) {
+        const ImDrawList* list = drawData->CmdLists[i];
+        for (const ImDrawCmd& cmd : list->CmdBuffer) {
+            if (cmd.UserCallback != nullptr) return false;
+            float minX = std::max((cmd.ClipRect.x - drawData->DisplayPos.x) * drawData->FramebufferScale.x, 0.0f);
+            float minY = std::max((cmd.ClipRect.y - drawData->DisplayPos.y) * drawData->FramebufferScale.y, 0.0f);
+            float maxX = std::min((cmd.ClipRect.z - drawData->DisplayPos.x) * drawData->FramebufferScale.x, width);
+            float maxY = std::min((cmd.ClipRect.w - drawData->DisplayPos.y) * drawData->FramebufferScale.y, height);
+            if (maxX <= minX || maxY <= minY) continue;
+
+            VSDL_UiDraw draw;
+            draw.scissor.offset = { (int32_t)minX, (int32_t)minY };
+            draw.scissor.extent = { (uint32_t)(maxX - minX), (uint32_t)(maxY - minY) };
+            draw.texture = (VkDescriptorSet)cmd.GetTexID();
+            draw.indexCount = cmd.ElemCount;
+            draw.firstIndex = cmd.IdxOffset + globalIndex;
+            draw.vertexOffset = (int32_t)(cmd.VtxOffset + globalVertex);
+            slot.draws.push_back(draw);
+        }
+        globalVertex += (uint32_t)list->VtxBuffer.Size;
+        globalIndex += (uint32_t)list->IdxBuffer.Size;
+    }
+
+    if (!slot.draws.empty()) {
+        VkDeviceSize vertexBytes = (VkDeviceSize)globalVertex * sizeof(ImDrawVert);
+        VkDeviceSize indexBytes = (VkDeviceSize)globalIndex * sizeof(ImDrawIdx);
+        // Grown with headroom so a UI that settles slightly larger doesn't reallocate; the slot's previous
+        // frame has completed, so its buffers are free to go
+        if (slot.vertexBuffer.size < vertexBytes) {
+            vsdl_destroy_buffer(ctx, slot.vertexBuffer);
+            slot.vertexBuffer = vsdl_create_buffer(ctx, vertexBytes * 3 / 2, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                   VSDL_MemoryClass::Static);
+        }
+        if (slot.indexBuffer.size < indexBytes) {
+            vsdl_destroy_buffer(ctx, slot.indexBuffer);
+            slot.indexBuffer = vsdl_create_buffer(ctx, indexBytes * 3 / 2, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                                  VSDL_MemoryClass::Static);
+        }
+        VkDeviceSize vertexOffset = 0;
+        VkDeviceSize indexOffset = 0;
+        for (int i = 0; i < drawData->CmdListsCount; i++) {
+            const ImDrawList* list = drawData->CmdLists[i];
+            VkDeviceSize listVertexBytes = (VkDeviceSize)list->VtxBuffer.Size * sizeof(ImDrawVert);
+            VkDeviceSize listIndexBytes = (VkDeviceSize)list->IdxBuffer.Size * sizeof(ImDrawIdx);
+            if (listVertexBytes) vsdl_upload_buffer(ctx, list->VtxBuffer.Data, listVertexBytes, slot.vertexBuffer, vertexOffset);
+            if (listIndexBytes) vsdl_upload_buffer(ctx, list->IdxBuffer.Data, listIndexBytes, slot.indexBuffer, indexOffset);
+            vertexOffset += listVertexBytes;
+            indexOffset += listIndexBytes;
+        }
+    }
+
+    slot.transform[0] = 2.0f / drawData->DisplaySize.x;
+    slot.transform[1] = 2.0f / drawData->DisplaySize.y;
+    slot.transform[2] = -1.0f - drawData->DisplayPos.x * slot.transform[0];
+    slot.transform[3] = -1.0f - drawData->DisplayPos.y * slot.transform[1];
+    slot.viewport = { 0.0f, 0.0f, width, height, 0.0f, 1.0f };
+    slot.hash = ctx.ui.hash;
+    slot.valid = true;
+    return true;
+}
+
+static void replay_slot(VSDL_Context& ctx, VkCommandBuffer commandBuffer, const VSDL_UiCacheSlot& slot) {
+    if (slot.draws.empty()) return;
+    VSDL_UiRenderer& ui = ctx.ui;
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vsdl_pipeline(ctx, ui.pipeline));
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &slot.vertexBuffer.buffer, &offset);
+    vkCmdBindIndexBuffer(commandBuffer, slot.indexBuffer.buffer, 0, sizeof(ImDrawIdx) == 2 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32);
+    vkCmdSetViewport(commandBuffer, 0, 1, &slot.viewport);
+    vkCmdPushConstants(commandBuffer, ui.pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(slot.transform), slot.transform);
+
+    VkDescriptorSet bound = VK_NULL_HANDLE;
+    for (const VSDL_UiDraw& draw : slot.draws) {
+        if (draw.texture != bound) {
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, ui.pipelineLayout, 0, 1, &draw.texture, 0, nullptr);
+            bound = draw.texture;
+        }
+        vkCmdSetScissor(commandBuffer, 0, 1, &draw.scissor);
+        vkCmdDrawIndexed(commandBuffer, draw.indexCount, 1, draw.firstIndex, draw.vertexOffset, 0);
+    }
+}
+
+static void composite_layer(VSDL_Context& ctx, VkCommandBuffer commandBuffer) {
+    VSDL_UiRenderer& ui = ctx.ui;
+    if (ui.drawData->TotalVtxCount == 0) return; // Nothing was drawn into the layer
+    VkViewport viewport = { 0.0f, 0.0f, (float)ctx.swapchainExtent.width, (float)ctx.swapchainExtent.height, 0.0f, 1.0f };
+    VkRect2D scissor = {};
+    scissor.extent = ctx.swapchainExtent;
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, vsdl_pipeline(ctx, ui.compositePipeline));
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, ui.pipelineLayout, 0, 1, &ui.layerTexture, 0, nullptr);
+    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+    vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+}
+
+bool vsdl_record_ui(VSDL_Context& ctx, VkCommandBuffer commandBuffer) {
+    VSDL_UiRenderer& ui = ctx.ui;
+    if (ui.mode == VSDL_UiMode::Layer && ui.layerValid) {
+        composite_layer(ctx, commandBuffer);
+        return true;
+    }
+    if (ui.mode != VSDL_UiMode::Cached) return false;
+
+    VSDL_UiCacheSlot& slot = ui.slots[ctx.currentFrame];
+    bool reused = slot.valid && slot.hash == ui.hash;
+    ui.lastReused.store(reused, std::memory_order_relaxed);
+    if (reused) {
+        ui.reusedFrames++;
+    } else {
+        ui.redrawnFrames++;
+        // A UI that changes every frame would pay for an upload per frame and never replay it; wait until it
+        // has held still for a frame
+        if (ui.stableFrames == 0 || !build_slot(ctx, slot)) return false;
+    }
+    replay_slot(ctx, commandBuffer, slot);
+    return true;
+}
+
+const char* vsdl_ui_mode_name(VSDL_UiMode mode) {
+    switch (mode) {
+        case VSDL_UiMode::Direct: return "direct";
+        case VSDL_UiMode::Cached: return "cached";
+        case VSDL_UiMode::Layer: return "layer";
+    }
+    return "unknown";
+}
+
+void vsdl_ui_cache_ui(VSDL_Context& ctx, VSDL_UiSettings& settings) {
+    if (!ImGui::CollapsingHeader("UI rendering")) return;
+    int mode = (int)settings.uiMode;
+    ImGui::RadioButton("Direct", &mode, (int)VSDL_UiMode::Direct);
+    ImGui::SameLine();
+    ImGui::RadioButton("Cached", &mode, (int)VSDL_UiMode::Cached);
+    ImGui::SameLine();
+    ImGui::RadioButton("Layer", &mode, (int)VSDL_UiMode::Layer);
+    settings.uiMode = (VSDL_UiMode)mode;
+    // A state rather than running totals: it only changes with the UI, so it does not keep the hash moving itself
+    ImGui::Text("Last frame: %s", ctx.ui.lastReused.load(std::memory_order_relaxed) ? "reused" : "redrawn");
+}
\ No newline at end of file
@@ -0,0 +1,257 @@
+#include "vsdl_upload.h"
+#include "vsdl_memory.h"
+#include "vsdl_sync.h"
+#include <SDL3/SDL_log.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+// Big enough for typical meshes; anything over half of it gets its own staging buffer
+#define VSDL_UPLOAD_RING_SIZE (16ull * 1024 * 1024)
+#define VSDL_UPLOAD_ALIGNMENT 16
+
+bool vsdl_create_upload_queue(VSDL_Context& ctx) {
+    VSDL_UploadQueue& uploads = ctx.uploads;
+
+    VkCommandPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolInfo.queueFamilyIndex = ctx.transferQueueFamilyIndex;
+    if (vkCreateCommandPool(ctx.device, &poolInfo, nullptr, &uploads.commandPool) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create upload command pool");
+        return false;
+    }
+
+    VkCommandBuffer commandBuffers[VSDL_UPLOAD_BATCH_COUNT];
+    VkCommandBufferAllocateInfo allocInfo = {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = uploads.commandPool;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = VSDL_UPLOAD_BATCH_COUNT;
+    if (vkAllocateCommandBuffers(ctx.device, &allocInfo, commandBuffers) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to allocate upload command buffers");
+        return false;
+    }
+
+    for (uint32_t i = 0; i < VSDL_UPLOAD_BATCH_COUNT; i++) {
+        uploads.batches[i].commandBuffer = commandBuffers[i];
+    }
+
+    try {
+        uploads.ring = vsdl_create_buffer(ctx, VSDL_UPLOAD_RING_SIZE, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VSDL_MemoryClass::Staging);
+    } catch (const std::exception&) {
+        return false;
+    }
+
+    SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Upload queue: family %u (%s), %llu MB staging ring", ctx.transferQueueFamilyIndex,
+                ctx.transferQueue != ctx.graphicsQueue ? "dedicated transfer" : "graphics",
+                (unsigned long long)(VSDL_UPLOAD_RING_SIZE / (1024 * 1024)));
+    return true;
+}
+
+// Release the ring space and oversized staging buffers of a batch whose timeline value has completed
+static void retire_batch(VSDL_Context& ctx, VSDL_UploadBatch& batch) {
+    ctx.uploads.ringUsed -= batch.ringBytes;
+    batch.ringBytes = 0;
+    for (auto& buffer : batch.oversizedStaging) {
+        vsdl_destroy_buffer(ctx, buffer);
+    }
+    batch.oversizedStaging.clear();
+    batch.inFlight = false;
+}
+
+// Retire finished batches in submission order; with wait set, block on the oldest one
+static bool retire_batches(VSDL_Context& ctx, bool wait) {
+    VSDL_UploadQueue& uploads = ctx.uploads;
+    bool retired = false;
+    for (;;) {
+        VSDL_UploadBatch* oldest = nullptr;
+        for (auto& batch : uploads.batches) {
+            if (batch.inFlight && (!oldest || batch.timelineValue < oldest->timelineValue)) oldest = &batch;
+        }
+        if (!oldest) return retired;
+
+        if (wait && !retired) {
+            vsdl_timeline_wait(ctx, VSDL_QueueKind::Transfer, oldest->timelineValue);
+        } else if (vsdl_timeline_completed(ctx, VSDL_QueueKind::Transfer) < oldest->timelineValue) {
+            return retired;
+        }
+        retire_batch(ctx, *oldest);
+        retired = true;
+    }
+}
+
+static void submit_batch(VSDL_Context& ctx, VSDL_UploadBatch& batch) {
+    if (vkEndCommandBuffer(batch.commandBuffer) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to end upload command buffer");
+        throw std::runtime_error("Upload command buffer end failed");
+    }
+
+    batch.timelineValue = vsdl_queue_submit(ctx, VSDL_QueueKind::Transfer, batch.commandBuffer, {});
+    batch.recording = false;
+    batch.inFlight = true;
+    ctx.uploads.currentBatch = (ctx.uploads.currentBatch + 1) % VSDL_UPLOAD_BATCH_COUNT;
+}
+
+// Returns the batch to record into, starting it if needed
+static VSDL_UploadBatch& begin_batch(VSDL_Context& ctx) {
+    VSDL_UploadQueue& uploads = ctx.uploads;
+    VSDL_UploadBatch* batch = &uploads.batches[uploads.currentBatch];
+    if (batch->recording) return *batch;
+
+    // All batches in flight: only now does the CPU wait, and only on the transfer queue
+    if (batch->inFlight) retire_batches(ctx, true);
+
+    VkCommandBufferBeginInfo beginInfo = {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkResetCommandBuffer(batch->commandBuffer, 0);
+    if (vkBeginCommandBuffer(batch->commandBuffer, &beginInfo) != VK_SUCCESS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to begin upload command buffer");
+        throw std::runtime_error("Upload command buffer begin failed");
+    }
+    batch->recording = true;
+    return *batch;
+}
+
+// Reserve size bytes in the ring for the recording batch; returns false when it can't fit right now
+static bool ring_allocate(VSDL_UploadQueue& uploads, VSDL_UploadBatch& batch, VkDeviceSize size, VkDeviceSize& offset) {
+    VkDeviceSize head = (uploads.ringHead + VSDL_UPLOAD_ALIGNMENT - 1) & ~(VkDeviceSize)(VSDL_UPLOAD_ALIGNMENT - 1);
+    VkDeviceSize padding = head - uploads.ringHead;
+    if (head + size > uploads.ring.size) {
+        // Skip the tail end of the ring and wrap to the start
+        padding = uploads.ring.size - uploads.ringHead;
+        head = 0;
+    }
+    if (uploads.ringUsed + padding + size > uploads.ring.size) return false;
+
+    offset = head;
+    uploads.ringHead = head + size;
+    uploads.ringUsed += padding + size;
+    batch.ringBytes += padding + size;
+    return true;
+}
+
+// Copy data into the ring (or a one-off staging buffer) and return the batch that must record the copy
+static VSDL_UploadBatch& stage_data(VSDL_Context& ctx, const void* data, VkDeviceSize size, VkBuffer& srcBuffer,
+                                    VkDeviceSize& srcOffset) {
+    VSDL_UploadQueue& uploads = ctx.uploads;
+    VSDL_UploadBatch* batch = &begin_batch(ctx);
+    srcOffset = 0;
+
+    if (size > uploads.ring.size / 2) {
+        // Large uploads get a one-off staging buffer instead of draining the ring
+        VSDL_Buffer staging = vsdl_create_buffer(ctx, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VSDL_MemoryClass::Staging);
+        memcpy(staging.mapped, data, (size_t)size);
+        vmaFlushAllocation(ctx.allocator, staging.allocation, 0, VK_WHOLE_SIZE);
+        srcBuffer = staging.buffer;
+        batch->oversizedStaging.push_back(staging);
+    } else {
+        while (!ring_allocate(uploads, *batch, size, srcOffset)) {
+            // Ring full: hand what we have to the GPU and reclaim space from finished batches
+            if (batch->ringBytes > 0) submit_batch(ctx, *batch);
+            retire_batches(ctx, true);
+            batch = &begin_batch(ctx);
+        }
+        memcpy((char*)uploads.ring.mapped + srcOffset, data, (size_t)size);
+        vmaFlushAllocation(ctx.allocator, uploads.ring.allocation, srcOffset, size);
+        srcBuffer = uploads.ring.buffer;
+    }
+    uploads.bytesUploaded += size;
+    return *batch;
+}
+
+void vsdl_upload_buffer(VSDL_Context& ctx, const void* data, VkDeviceSize size, VSDL_Buffer& dst, VkDeviceSize dstOffset) {
+    if (size == 0) return;
+
+    VkBuffer srcBuffer = VK_NULL_HANDLE;
+    VkDeviceSize srcOffset = 0;
+    VSDL_UploadBatch& batch = stage_data(ctx, data, size, srcBuffer, srcOffset);
+
+    VkBufferCopy region = {};
+    region.srcOffset = srcOffset;
+    region.dstOffset = dstOffset;
+    region.size = size;
+    vkCmdCopyBuffer(batch.commandBuffer, srcBuffer, dst.buffer, 1, &region);
+}
+
+void vsdl_upload_image(VSDL_Context& ctx, const void* data, VkDeviceSize size, VSDL_Image& dst, uint32_t mipLevel) {
+    if (size == 0) return;
+
+    VkBuffer srcBuffer = VK_NULL_HANDLE;
+    VkDeviceSize srcOffset = 0;
+    VSDL_UploadBatch& batch = stage_data(ctx, data, size, srcBuffer, srcOffset);
+
+    VkImageMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = dst.image;
+    barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, mipLevel, 1, 0, 1 };
+    vkCmdPipelineBarrier(batch.commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                         0, nullptr, 0, nullptr, 1, &barrier);
+
+    VkBufferImageCopy region = {};
+    region.bufferOffset = srcOffset;
+    region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, mipLevel, 0, 1 };
+    region.imageExtent = { std::max(1u, dst.extent.width >> mipLevel), std::max(1u, dst.extent.height >> mipLevel), 1 };
+    vkCmdCopyBufferToImage(batch.commandBuffer, srcBuffer, dst.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+    // The transfer queue may not support shader stages; the semaphore wait of the graphics submit makes
+    // the level visible to its readers
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = 0;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    vkCmdPipelineBarrier(batch.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+                         0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+std::vector<VSDL_QueueWait> vsdl_flush_uploads(VSDL_Context& ctx) {
+    VSDL_UploadQueue& uploads = ctx.uploads;
+    if (!uploads.commandPool) return {};
+
+    VSDL_UploadBatch& batch = uploads.batches[uploads.currentBatch];
+    if (batch.recording) submit_batch(ctx, batch);
+    retire_batches(ctx, false);
+
+    // One wait on the latest value covers every earlier batch; nothing at all once the host saw it finish
+    uint64_t submitted = vsdl_timeline_pending(ctx, VSDL_QueueKind::Transfer) - 1;
+    if (submitted <= uploads.waitedValue || submitted <= vsdl_timeline_completed(ctx, VSDL_QueueKind::Transfer)) return {};
+    uploads.waitedValue = submitted;
+    VSDL_QueueWait wait;
+    wait.kind = VSDL_QueueKind::Transfer;
+    wait.value = submitted;
+    wait.stages = VSDL_UPLOAD_WAIT_STAGES;
+    return { wait };
+}
+
+void vsdl_finish_uploads(VSDL_Context& ctx) {
+    VSDL_UploadQueue& uploads = ctx.uploads;
+    if (!uploads.commandPool) return;
+
+    VSDL_UploadBatch& batch = uploads.batches[uploads.currentBatch];
+    if (batch.recording) submit_batch(ctx, batch);
+    while (retire_batches(ctx, true)) {}
+}
+
+void vsdl_destroy_upload_queue(VSDL_Context& ctx) {
+    VSDL_UploadQueue& uploads = ctx.uploads;
+    for (auto& batch : uploads.batches) {
+        if (batch.inFlight) vsdl_timeline_wait(ctx, VSDL_QueueKind::Transfer, batch.timelineValue);
+        for (auto& buffer : batch.oversizedStaging) {
+            vsdl_destroy_buffer(ctx, buffer);
+        }
+        batch.oversizedStaging.clear();
+        batch = VSDL_UploadBatch{};
+    }
+    vsdl_destroy_buffer(ctx, uploads.ring);
+    if (uploads.commandPool) {
+        vkDestroyCommandPool(ctx.device, uploads.commandPool, nullptr);
+        uploads.commandPool = VK_NULL_HANDLE;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,127 @@
+// Device scoring and selection against hand-made candidate lists; needs no GPU or Vulkan instance
+#include "vsdl_device.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(condition)                                                        \
+    do {                                                                        \
+        if (!(condition)) {                                                     \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+            failures++;                                                         \
+        }                                                                       \
+    } while (0)
+
+// A device that can render to the window and has nothing else going for it
+static VSDL_DeviceCandidate bare(const char* name, VkPhysicalDeviceType type) {
+    VSDL_DeviceCandidate candidate;
+    candidate.name = name;
+    candidate.type = type;
+    candidate.graphicsQueue = true;
+    candidate.presentQueue = true;
+    candidate.swapchain = true;
+    return candidate;
+}
+
+// The same with every bonus the scorer knows about, memory capped and the newest API version
+static VSDL_DeviceCandidate loaded(const char* name, VkPhysicalDeviceType type) {
+    VSDL_DeviceCandidate candidate = bare(name, type);
+    candidate.apiVersion = VK_MAKE_API_VERSION(0, 1, 4, 0);
+    candidate.deviceLocalBytes = 64ull << 30;
+    candidate.asyncCompute = true;
+    candidate.dedicatedTransfer = true;
+    candidate.timelineSemaphore = true;
+    candidate.descriptorIndexing = true;
+    candidate.dynamicRendering = true;
+    candidate.memoryBudget = true;
+    return candidate;
+}
+
+// Type decides first: no amount of extras lifts a device over a bare one of a better type
+static void test_type_tiers() {
+    const VkPhysicalDeviceType order[] = { VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU, VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU,
+                                           VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU, VK_PHYSICAL_DEVICE_TYPE_OTHER,
+                                           VK_PHYSICAL_DEVICE_TYPE_CPU };
+    for (size_t i = 0; i + 1 < sizeof(order) / sizeof(order[0]); i++) {
+        VSDL_DeviceCandidate better = bare("better", order[i]);
+        VSDL_DeviceCandidate worse = loaded("worse", order[i + 1]);
+        CHECK(vsdl_score_device(better, false) > vsdl_score_device(worse, false));
+        // Listed first, the loaded device would also win a tie
+        CHECK(vsdl_select_device({ worse, better }, false, "") == 1);
+    }
+
+    // Within a type the extras do count
+    CHECK(vsdl_score_device(loaded("a", VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU), false) >
+          vsdl_score_device(bare("b", VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU), false));
+}
+
+static void test_ties_and_unusable() {
+    // Equal scores go to the lower index
+    std::vector<VSDL_DeviceCandidate> twins = { bare("first", VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU),
+                                                bare("second", VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU) };
+    CHECK(vsdl_select_device(twins, false, "") == 0);
+
+    // A discrete GPU that cannot present loses to anything that can, but is fine headless
+    VSDL_DeviceCandidate offscreen = loaded("offscreen", VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU);
+    offscreen.presentQueue = false;
+    offscreen.swapchain = false;
+    std::string reason;
+    CHECK(vsdl_score_device(offscreen, false, &reason) < 0);
+    CHECK(!reason.empty());
+    CHECK(vsdl_score_device(offscreen, true) >= 0);
+    std::vector<VSDL_DeviceCandidate> candidates = { offscreen, bare("llvmpipe", VK_PHYSICAL_DEVICE_TYPE_CPU) };
+    CHECK(vsdl_select_device(candidates, false, "") == 1);
+    CHECK(vsdl_select_device(candidates, true, "") == 0);
+}
+
+static void test_override() {
+    std::vector<VSDL_DeviceCandidate> candidates = { loaded("NVIDIA GeForce RTX 4070", VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU),
+                                                     bare("AMD Radeon(TM) Graphics", VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU),
+                                                     bare("llvmpipe (LLVM 17.0.6, 256 bits)", VK_PHYSICAL_DEVICE_TYPE_CPU) };
+    candidates[2].graphicsQueue = false;
+    CHECK(vsdl_select_device(candidates, false, "") == 0);
+
+    // By index, and by case-insensitive name substring
+    std::string report;
+    CHECK(vsdl_select_device(candidates, false, "1", &report) == 1);
+    CHECK(report.find("(override)") != std::string::npos);
+    CHECK(vsdl_select_device(candidates, false, "radeon") == 1);
+
+    // An override naming nothing, or an unusable device, falls back to the best score
+    CHECK(vsdl_select_device(candidates, false, "7", &report) == 0);
+    CHECK(report.find("matches no GPU") != std::string::npos);
+    CHECK(vsdl_select_device(candidates, false, "intel", &report) == 0);
+    CHECK(vsdl_select_device(candidates, false, "LLVMPIPE", &report) == 0);
+    CHECK(report.find("unusable GPU 2") != std::string::npos);
+}
+
+static void test_nothing_usable() {
+    std::string report;
+    CHECK(vsdl_select_device({}, false, "", &report) == -1);
+    CHECK(report.find("No usable GPU") != std::string::npos);
+
+    VSDL_DeviceCandidate computeOnly = loaded("compute only", VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU);
+    computeOnly.graphicsQueue = false;
+    VSDL_DeviceCandidate noSwapchain = bare("no swapchain", VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU);
+    noSwapchain.swapchain = false;
+    CHECK(vsdl_select_device({ computeOnly, noSwapchain }, false, "0", &report) == -1);
+    CHECK(report.find("unusable, no graphics queue") != std::string::npos);
+    CHECK(report.find("No usable GPU") != std::string::npos);
+    // Headless drops the window requirements but never the graphics queue
+    CHECK(vsdl_select_device({ computeOnly, noSwapchain }, true, "") == 1);
+}
+
+int main() {
+    test_type_tiers();
+    test_ties_and_unusable();
+    test_override();
+    test_nothing_usable();
+    if (failures) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("Device selection: all checks passed\n");
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,125 @@
+// Pack files into a VSDL asset archive (see include/vsdl_archive_format.h)
+// Usage: vsdl_pack <output.vpk> <root directory> <file>...
+// Entry names are the file paths relative to the root, so they match the paths the loaders use.
+#include "vsdl_archive_format.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+struct PackInput {
+    std::string name;
+    std::filesystem::path path;
+    uint32_t type;
+    uint64_t size;
+};
+
+static uint32_t entry_type(const std::filesystem::path& path) {
+    std::string extension = path.extension().string();
+    if (extension == ".spv") return VSDL_ARCHIVE_SHADER;
+    if (extension == ".obj" || extension == ".mesh") return VSDL_ARCHIVE_MESH;
+    if (extension == ".ppm" || extension == ".tga" || extension == ".png" || extension == ".ktx" || extension == ".ktx2") {
+        return VSDL_ARCHIVE_TEXTURE;
+    }
+    return VSDL_ARCHIVE_RAW;
+}
+
+static uint64_t align_up(uint64_t value) {
+    return (value + VSDL_ARCHIVE_ALIGNMENT - 1) / VSDL_ARCHIVE_ALIGNMENT * VSDL_ARCHIVE_ALIGNMENT;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 4) {
+        fprintf(stderr, "Usage: %s <output.vpk> <root directory> <file>...\n", argv[0]);
+        return 1;
+    }
+    const std::filesystem::path root = std::filesystem::absolute(argv[2]);
+
+    std::vector<PackInput> inputs;
+    for (int i = 3; i < argc; i++) {
+        std::filesystem::path path = std::filesystem::absolute(argv[i]);
+        std::error_code error;
+        uint64_t size = std::filesystem::file_size(path, error);
+        if (error) {
+            fprintf(stderr, "vsdl_pack: cannot read %s: %s\n", argv[i], error.message().c_str());
+            return 1;
+        }
+        std::string name = std::filesystem::relative(path, root).generic_string();
+        if (name.empty() || name.rfind("..", 0) == 0 || name.size() >= VSDL_ARCHIVE_MAX_NAME) {
+            fprintf(stderr, "vsdl_pack: %s is outside %s or its name is too long\n", argv[i], argv[2]);
+            return 1;
+        }
+        inputs.push_back({ name, path, entry_type(path), size });
+    }
+
+    // Sorted index for binary search at runtime
+    std::sort(inputs.begin(), inputs.end(), [](const PackInput& a, const PackInput& b) { return a.name < b.name; });
+    for (size_t i = 1; i < inputs.size(); i++) {
+        if (inputs[i].name == inputs[i - 1].name) {
+            fprintf(stderr, "vsdl_pack: duplicate entry %s\n", inputs[i].name.c_str());
+            return 1;
+        }
+    }
+
+    VSDL_ArchiveHeader header = {};
+    header.magic = VSDL_ARCHIVE_MAGIC;
+    header.version = VSDL_ARCHIVE_VERSION;
+    header.entryCount = (uint32_t)inputs.size();
+    header.alignment = VSDL_ARCHIVE_ALIGNMENT;
+
+    std::vector<VSDL_ArchiveEntry> entries(inputs.size());
+    uint64_t offset = align_up(sizeof(VSDL_ArchiveHeader) + entries.size() * sizeof(VSDL_ArchiveEntry));
+    for (size_t i = 0; i < inputs.size(); i++) {
+        VSDL_ArchiveEntry& entry = entries[i];
+        memset(&entry, 0, sizeof(entry));
+        memcpy(entry.name, inputs[i].name.c_str(), inputs[i].name.size());
+        entry.type = inputs[i].type;
+        entry.offset = offset;
+        entry.size = inputs[i].size;
+        offset = align_up(offset + inputs[i].size);
+    }
+
+    // Write to a temporary file so a running instance never maps a half-written archive
+    std::string output = argv[1];
+    std::string temp = output + ".tmp";
+    std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        fprintf(stderr, "vsdl_pack: cannot create %s\n", temp.c_str());
+        return 1;
+    }
+    file.write((const char*)&header, sizeof(header));
+    file.write((const char*)entries.data(), entries.size() * sizeof(VSDL_ArchiveEntry));
+
+    std::vector<char> data;
+    for (size_t i = 0; i < inputs.size(); i++) {
+        std::ifstream input(inputs[i].path, std::ios::binary);
+        data.resize((size_t)inputs[i].size);
+        if (!input.read(data.data(), (std::streamsize)data.size())) {
+            fprintf(stderr, "vsdl_pack: failed to read %s\n", inputs[i].path.string().c_str());
+            return 1;
+        }
+        // Zero padding up to the entry's aligned offset
+        uint64_t position = (uint64_t)file.tellp();
+        std::vector<char> padding((size_t)(entries[i].offset - position), 0);
+        file.write(padding.data(), (std::streamsize)padding.size());
+        file.write(data.data(), (std::streamsize)data.size());
+    }
+    uint64_t total = (uint64_t)file.tellp();
+    file.close();
+    if (!file) {
+        fprintf(stderr, "vsdl_pack: failed to write %s\n", temp.c_str());
+        return 1;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temp, output, error);
+    if (error) {
+        fprintf(stderr, "vsdl_pack: cannot replace %s: %s\n", output.c_str(), error.message().c_str());
+        return 1;
+    }
+    printf("vsdl_pack: %zu entries, %llu bytes -> %s\n", inputs.size(), (unsigned long long)total, output.c_str());
+    return 0;
+}
\ No newline at end of file